@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the synthetic NMEA logs and the timer shared by the benchmarks
+///
+/// BenchTrack is one 1 Hz receiver moving with noise on a straight track. Every epoch has a
+/// GGA, GSA, RMC and VTG, every 5th epoch also two GPGSV, every 997th a line of binary garbage.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef BENCH_NMEA_H_
+#define BENCH_NMEA_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include <chrono>
+#include <string>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// ******************************************************************
+// Functions
+// ******************************************************************
+
+// Seconds of a steady clock
+static inline double benchNow()
+{
+   return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Append "$<body>*HH\r\n" with the body formatted like printf
+static inline void benchSentence(std::string &out, const char *format, ...)
+{
+   char body[128];
+   va_list args;
+
+   va_start(args, format);
+   int length = vsnprintf(body, sizeof(body), format, args);
+   va_end(args);
+   if (length < 0 || length >= (int)sizeof(body)) abort();
+
+   uint8_t checksum = 0;
+   for (int i = 0; i < length; i++) checksum ^= (uint8_t)body[i];
+
+   char tail[8];
+   snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+
+   out += '$';
+   out.append(body, length);
+   out += tail;
+}
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class BenchTrack
+{
+   public:
+      explicit BenchTrack(uint32_t seed) : state(seed * 2654435761u + 1), epochs(0)
+      {
+         lat = 48.0 + uniform();
+         lng = 8.0 + uniform();
+         altitude = 100.0 + uniform() * 50.0;
+         second = 16 * 3600 + 55 * 60;
+      }
+
+      // Append the sentences of the next epoch
+      void epoch(std::string &out)
+      {
+         static const int sats[7][3] = {{8, 40, 137}, {10, 56, 137}, {16, 49, 200}, {18, 12, 30}, {23, 20, 300}, {26, 18, 178}, {27, 60, 90}};
+         char time[16], latField[24], lngField[24];
+
+         snprintf(time, sizeof(time), "%02u%02u%02u.000", (second / 3600) % 24, (second / 60) % 60, second % 60);
+         lat += (0.0003 + gauss() * 0.00005) / 60;
+         lng += (0.0004 + gauss() * 0.00005) / 60;
+         toNmea(lat, 2, latField);
+         toNmea(lng, 3, lngField);
+         altitude += gauss() * 0.2;
+         double speed = fabs(12.0 + gauss());
+         double course = fmod(405.0 + gauss() * 2.0, 360.0);
+
+         benchSentence(out, "GNGGA,%s,%s,N,%s,E,1,07,1.%u,%.1f,M,48.3,M,,", time, latField, lngField, next() % 10, altitude);
+         benchSentence(out, "GNGSA,A,3,10,16,21,28,,,,,,,,,1.9,1.2,1.5,1");
+         if (epochs % 5 == 0)
+         {
+            for (int part = 0; part < 2; part++)
+            {
+               const int (*s)[3] = sats + 4 * part;
+               if (part == 0)
+                  benchSentence(out, "GPGSV,2,1,07,%02d,%02d,%03d,%02u,%02d,%02d,%03d,%02u,%02d,%02d,%03d,%02u,%02d,%02d,%03d,%02u,0",
+                     s[0][0], s[0][1], s[0][2], 20 + next() % 26, s[1][0], s[1][1], s[1][2], 20 + next() % 26,
+                     s[2][0], s[2][1], s[2][2], 20 + next() % 26, s[3][0], s[3][1], s[3][2], 20 + next() % 26);
+               else
+                  benchSentence(out, "GPGSV,2,2,07,%02d,%02d,%03d,%02u,%02d,%02d,%03d,%02u,%02d,%02d,%03d,%02u,0",
+                     s[0][0], s[0][1], s[0][2], 20 + next() % 26, s[1][0], s[1][1], s[1][2], 20 + next() % 26,
+                     s[2][0], s[2][1], s[2][2], 20 + next() % 26);
+            }
+         }
+         benchSentence(out, "GNRMC,%s,A,%s,N,%s,E,%.2f,%.2f,180323,,,A,V", time, latField, lngField, speed, course);
+         benchSentence(out, "GNVTG,%.2f,T,,M,%.2f,N,%.2f,K,A", course, speed, speed * 1.852);
+         if (epochs % 997 == 0)
+         {
+            static const char garbage[] = "\x00\xff" "garbage$GPGGA,12*00\r\n";
+            out.append(garbage, sizeof(garbage) - 1);
+         }
+
+         epochs++;
+         second++;
+      }
+
+      // Log of at least bytes, one track
+      static std::string log(size_t bytes, uint32_t seed = 1)
+      {
+         BenchTrack track(seed);
+         std::string out;
+
+         out.reserve(bytes + 1024);
+         while (out.size() < bytes) track.epoch(out);
+         return out;
+      }
+
+   private:
+      uint32_t state;                                          // xorshift32
+      uint32_t epochs;
+      uint32_t second;
+      double lat, lng, altitude;                               // degrees and m
+
+      // Positive degrees as NMEA DDMM.MMMMM or DDDMM.MMMMM
+      static void toNmea(double degrees, int degreeDigits, char *field)
+      {
+         unsigned long units = (unsigned long)lround(degrees * 60 * 100000);   // 1e-5 minutes
+         snprintf(field, 24, "%0*lu%02lu.%05lu", degreeDigits, units / 6000000, units / 100000 % 60, units % 100000);
+      }
+
+      uint32_t next()
+      {
+         state ^= state << 13;
+         state ^= state >> 17;
+         state ^= state << 5;
+         return state;
+      }
+      double uniform()   { return (next() >> 8) * (1.0 / 16777216.0); }
+      double gauss()     { return (uniform() + uniform() + uniform() + uniform() - 2.0) * 1.7320508; }   // Close to normal, variance 1
+};
+
+
+
+
+#endif
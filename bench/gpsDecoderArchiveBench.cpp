@@ -0,0 +1,176 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the compression benchmark of gpsDecoderArchive.h
+///
+/// Every log given on the command line is compressed and decompressed in 64 KB pieces, the
+/// round trip is checked byte by byte. Without arguments a 16 MB BenchTrack log is used, real
+/// receiver logs compress worse, so pass some recorded ones to get meaningful ratios:
+///
+/// bench/gpsDecoderArchiveBench ublox.nmea quectel.nmea
+///
+/// On POSIX hosts gzip -6 and xz -9 are run over the same bytes for comparison, if installed.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderArchive.h"
+#include "benchNmea.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+   #include <unistd.h>
+   #define BENCH_TOOLS
+#endif
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define SYNTHETIC_BYTES                   (16 * 1024 * 1024)
+#define PIECE                             65536               // Bytes per write(), like reading a file
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static void collect(const uint8_t *data, size_t length, void *context)
+{
+   std::vector<uint8_t> &out = *(std::vector<uint8_t> *)context;
+   out.insert(out.end(), data, data + length);
+}
+
+static bool readFile(const char *path, std::string &log)
+{
+   FILE *file = fopen(path, "rb");
+   if (!file) return false;
+
+   char buffer[PIECE];
+   size_t length;
+   while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0) log.append(buffer, length);
+
+   fclose(file);
+   return true;
+}
+
+#ifdef BENCH_TOOLS
+// Compressed size of a file by an external tool, 0 if the tool is not installed
+static size_t toolSize(const char *command, const char *path)
+{
+   std::string line = std::string(command) + " -c '" + path + "' 2>/dev/null | wc -c";
+   FILE *pipe = popen(line.c_str(), "r");
+   if (!pipe) return 0;
+
+   unsigned long long size = 0;
+   if (fscanf(pipe, "%llu", &size) != 1) size = 0;
+   pclose(pipe);
+   return (size_t)size;
+}
+#endif
+
+// Print one line of the table, false if the round trip failed
+static bool measure(const char *name, const std::string &log, const char *path)
+{
+   std::vector<uint8_t> compressed, decompressed;
+   compressed.reserve(log.size() / 4);
+   decompressed.reserve(log.size());
+
+   double start = benchNow();
+   GpsDecoderArchive::Compressor compressor(collect, &compressed);
+   for (size_t i = 0; i < log.size(); i += PIECE) compressor.write(log.data() + i, log.size() - i < PIECE ? log.size() - i : PIECE);
+   compressor.finish();
+   double compressTime = benchNow() - start;
+
+   start = benchNow();
+   GpsDecoderArchive::Decompressor decompressor(collect, &decompressed);
+   bool ok = true;
+   for (size_t i = 0; ok && i < compressed.size(); i += PIECE) ok = decompressor.write(compressed.data() + i, compressed.size() - i < PIECE ? compressed.size() - i : PIECE);
+   ok = ok && decompressor.finish();
+   double decompressTime = benchNow() - start;
+
+   ok = ok && decompressed.size() == log.size() && std::equal(decompressed.begin(), decompressed.end(), (const uint8_t *)log.data());
+
+   double megabytes = log.size() / 1e6;
+   printf("%-24s %10zu %10zu %7.1fx %9.1f %9.1f", name, log.size(), compressed.size(), (double)log.size() / compressed.size(),
+          megabytes / compressTime, megabytes / decompressTime);
+
+#ifdef BENCH_TOOLS
+   size_t gzip = toolSize("gzip -6", path), xz = toolSize("xz -9", path);
+   if (gzip) printf(" %7.1fx", (double)log.size() / gzip); else printf(" %8s", "-");
+   if (xz) printf(" %7.1fx", (double)log.size() / xz); else printf(" %8s", "-");
+#else
+   (void)path;
+#endif
+
+   printf("%s\n", ok ? "" : "  ROUND TRIP FAILED");
+   return ok;
+}
+
+static const char *baseName(const char *path)
+{
+   const char *name = strrchr(path, '/');
+   return name ? name + 1 : path;
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main(int argc, char **argv)
+{
+   bool ok = true;
+
+   printf("%-24s %10s %10s %8s %9s %9s %8s %8s\n", "log", "bytes", "archive", "ratio", "comp MB/s", "dec MB/s", "gzip -6", "xz -9");
+
+   if (argc < 2)
+   {
+      std::string log = BenchTrack::log(SYNTHETIC_BYTES);
+      std::string path;
+
+#ifdef BENCH_TOOLS
+      // The tools need a file
+      char name[] = "/tmp/gpsDecoderArchiveBenchXXXXXX";
+      int descriptor = mkstemp(name);
+      if (descriptor >= 0)
+      {
+         FILE *file = fdopen(descriptor, "wb");
+         fwrite(log.data(), 1, log.size(), file);
+         fclose(file);
+         path = name;
+      }
+#endif
+
+      ok = measure("BenchTrack (synthetic)", log, path.c_str());
+
+#ifdef BENCH_TOOLS
+      if (!path.empty()) unlink(path.c_str());
+#endif
+   }
+
+   for (int i = 1; i < argc; i++)
+   {
+      std::string log;
+      if (!readFile(argv[i], log))
+      {
+         printf("%s: can not read\n", argv[i]);
+         ok = false;
+         continue;
+      }
+      if (!measure(baseName(argv[i]), log, argv[i])) ok = false;
+   }
+
+   return ok ? 0 : 1;
+}
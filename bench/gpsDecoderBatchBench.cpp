@@ -0,0 +1,151 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the benchmark of the batch distanceBetween and courseTo kernels
+///
+/// 4096 random pairs of positions, half of them within 10 km, are run through the scalar
+/// functions in a loop and through the batch functions of the selected kernel, in double and
+/// float, and from a PreparedPointClass. Prints ns per position and the largest difference
+/// to the scalar result, in m and degrees. The float course differs most for pairs only a few
+/// meters apart, float inputs have a resolution of about 1 m.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "benchNmea.h"
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define POSITIONS                         4096
+#define RUN_SECONDS                       0.3
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static std::vector<double> lat1, lng1, lat2, lng2;
+static std::vector<float> lat1F, lng1F, lat2F, lng2F;
+static volatile double sink;                                   // Keeps the results alive
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static double uniform(double low, double high)
+{
+   return low + (high - low) * rand() / RAND_MAX;
+}
+
+// Course difference across 0 / 360 degrees
+static double angleDifference(double a, double b)
+{
+   double difference = fabs(a - b);
+   return difference > 180 ? 360 - difference : difference;
+}
+
+// ns per position of a function, which processes all POSITIONS once
+template <class Function>
+static double timeOf(Function function)
+{
+   size_t rounds = 0;
+   double start = benchNow(), elapsed;
+
+   do
+   {
+      function();
+      rounds++;
+   } while ((elapsed = benchNow() - start) < RUN_SECONDS);
+
+   return elapsed * 1e9 / ((double)rounds * POSITIONS);
+}
+
+static void print(const char *name, double scalar, double batch, double error, const char *unit)
+{
+   printf("%-22s %9.1f %9.1f %8.1fx %12.2e %s\n", name, scalar, batch, scalar / batch, error, unit);
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   std::vector<double> scalar(POSITIONS), batch(POSITIONS);
+   std::vector<float> batchF(POSITIONS);
+   double error;
+
+   srand(1);
+   for (size_t i = 0; i < POSITIONS; i++)
+   {
+      lat1.push_back(uniform(-85, 85));
+      lng1.push_back(uniform(-180, 180));
+      lat2.push_back(i % 2 ? uniform(-85, 85) : lat1[i] + uniform(-0.09, 0.09));
+      lng2.push_back(i % 2 ? uniform(-180, 180) : lng1[i] + uniform(-0.09, 0.09));
+      lat1F.push_back((float)lat1[i]);
+      lng1F.push_back((float)lng1[i]);
+      lat2F.push_back((float)lat2[i]);
+      lng2F.push_back((float)lng2[i]);
+   }
+
+   printf("%d positions, kernel %s, ns per position, largest difference to the scalar result\n\n", POSITIONS, GpsDecoderClass::batchKernel());
+   printf("%-22s %9s %9s %9s %12s\n", "function", "scalar", "batch", "speedup", "difference");
+
+   // double
+   double scalarTime = timeOf([&] { for (size_t i = 0; i < POSITIONS; i++) scalar[i] = GpsDecoderClass::distanceBetween(lat1[i], lng1[i], lat2[i], lng2[i]); sink = scalar[0]; });
+   double batchTime = timeOf([&] { GpsDecoderClass::distanceBetween(lat1.data(), lng1.data(), lat2.data(), lng2.data(), batch.data(), POSITIONS); sink = batch[0]; });
+   error = 0;
+   for (size_t i = 0; i < POSITIONS; i++) error = fmax(error, fabs(batch[i] - scalar[i]));
+   print("distanceBetween", scalarTime, batchTime, error, "m");
+
+   scalarTime = timeOf([&] { for (size_t i = 0; i < POSITIONS; i++) scalar[i] = GpsDecoderClass::courseTo(lat1[i], lng1[i], lat2[i], lng2[i]); sink = scalar[0]; });
+   batchTime = timeOf([&] { GpsDecoderClass::courseTo(lat1.data(), lng1.data(), lat2.data(), lng2.data(), batch.data(), POSITIONS); sink = batch[0]; });
+   error = 0;
+   for (size_t i = 0; i < POSITIONS; i++) error = fmax(error, angleDifference(batch[i], scalar[i]));
+   print("courseTo", scalarTime, batchTime, error, "deg");
+
+   // float, the scalar reference is the double function over the rounded inputs
+   scalarTime = timeOf([&] { for (size_t i = 0; i < POSITIONS; i++) scalar[i] = GpsDecoderClass::distanceBetween(lat1F[i], lng1F[i], lat2F[i], lng2F[i]); sink = scalar[0]; });
+   batchTime = timeOf([&] { GpsDecoderClass::distanceBetween(lat1F.data(), lng1F.data(), lat2F.data(), lng2F.data(), batchF.data(), POSITIONS); sink = batchF[0]; });
+   error = 0;
+   for (size_t i = 0; i < POSITIONS; i++) error = fmax(error, fabs(batchF[i] - scalar[i]));
+   print("distanceBetween float", scalarTime, batchTime, error, "m");
+
+   scalarTime = timeOf([&] { for (size_t i = 0; i < POSITIONS; i++) scalar[i] = GpsDecoderClass::courseTo(lat1F[i], lng1F[i], lat2F[i], lng2F[i]); sink = scalar[0]; });
+   batchTime = timeOf([&] { GpsDecoderClass::courseTo(lat1F.data(), lng1F.data(), lat2F.data(), lng2F.data(), batchF.data(), POSITIONS); sink = batchF[0]; });
+   error = 0;
+   for (size_t i = 0; i < POSITIONS; i++) error = fmax(error, angleDifference(batchF[i], scalar[i]));
+   print("courseTo float", scalarTime, batchTime, error, "deg");
+
+   // From one prepared point to all second positions
+   GpsDecoderClass::PreparedPointClass point(lat1[0], lng1[0]);
+
+   scalarTime = timeOf([&] { for (size_t i = 0; i < POSITIONS; i++) scalar[i] = point.distanceTo(lat2[i], lng2[i]); sink = scalar[0]; });
+   batchTime = timeOf([&] { point.distanceTo(lat2.data(), lng2.data(), batch.data(), POSITIONS); sink = batch[0]; });
+   error = 0;
+   for (size_t i = 0; i < POSITIONS; i++) error = fmax(error, fabs(batch[i] - scalar[i]));
+   print("prepared distanceTo", scalarTime, batchTime, error, "m");
+
+   scalarTime = timeOf([&] { for (size_t i = 0; i < POSITIONS; i++) scalar[i] = point.courseTo(lat2[i], lng2[i]); sink = scalar[0]; });
+   batchTime = timeOf([&] { point.courseTo(lat2.data(), lng2.data(), batch.data(), POSITIONS); sink = batch[0]; });
+   error = 0;
+   for (size_t i = 0; i < POSITIONS; i++) error = fmax(error, angleDifference(batch[i], scalar[i]));
+   print("prepared courseTo", scalarTime, batchTime, error, "deg");
+
+   return 0;
+}
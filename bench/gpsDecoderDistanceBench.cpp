@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the cost and error benchmark of the distanceBetween and courseTo tiers
+///
+/// Two sets of 100000 position pairs: short hops up to about 100 m, like consecutive fixes of a
+/// 10 Hz receiver, and random pairs up to 18000 km apart, the course of nearly antipodal points
+/// depends on the last digit. Every tier runs over both sets, also the plain distanceBetween
+/// and courseTo without a tier and DISTANCE_AUTO with a tolerance of 1 cm and 0.01 degrees.
+/// Prints ns per call and the largest difference to DISTANCE_VINCENTY, which is within 0.1 mm
+/// of GeographicLib.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "benchNmea.h"
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define PAIRS                             100000
+#define ROUNDS                            3
+#define MAX_DISTANCE                      18000000.0          // m, random pairs
+#define AUTO_DISTANCE_TOLERANCE           0.01                // m
+#define AUTO_COURSE_TOLERANCE             0.01                // degrees
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderClass::DistanceMethod DistanceMethod;
+
+struct PairClass
+{
+   double lat1, lng1, lat2, lng2;
+   double distance, course;                                    // DISTANCE_VINCENTY
+};
+
+struct TierClass
+{
+   const char *name;
+   bool plain;                                                 // distanceBetween and courseTo without a tier
+   DistanceMethod method;
+};
+
+static const TierClass tiers[] =
+{
+   { "sphere (plain)", true,  GpsDecoderClass::DISTANCE_HAVERSINE },
+   { "equirectangular", false, GpsDecoderClass::DISTANCE_EQUIRECTANGULAR },
+   { "haversine",      false, GpsDecoderClass::DISTANCE_HAVERSINE },
+   { "vincenty",       false, GpsDecoderClass::DISTANCE_VINCENTY },
+   { "auto",           false, GpsDecoderClass::DISTANCE_AUTO },
+};
+
+static volatile double sink;                                   // Keeps the results alive
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static double uniform(double low, double high)
+{
+   return low + (high - low) * rand() / RAND_MAX;
+}
+
+// Course difference across 0 / 360 degrees
+static double angleDifference(double a, double b)
+{
+   double difference = fabs(a - b);
+   return difference > 180 ? 360 - difference : difference;
+}
+
+static std::vector<PairClass> makePairs(bool hops)
+{
+   std::vector<PairClass> pairs(PAIRS);
+
+   for (size_t i = 0; i < PAIRS; i++)
+   {
+      PairClass &pair = pairs[i];
+      do
+      {
+         pair.lat1 = uniform(-80, 80);
+         pair.lng1 = uniform(-180, 180);
+         pair.lat2 = hops ? pair.lat1 + uniform(-0.0006, 0.0006) : uniform(-80, 80);
+         pair.lng2 = hops ? pair.lng1 + uniform(-0.0006, 0.0006) : uniform(-180, 180);
+         pair.distance = GpsDecoderClass::distanceBetween(pair.lat1, pair.lng1, pair.lat2, pair.lng2, GpsDecoderClass::DISTANCE_VINCENTY);
+      } while (pair.distance > MAX_DISTANCE);
+      pair.course = GpsDecoderClass::courseTo(pair.lat1, pair.lng1, pair.lat2, pair.lng2, GpsDecoderClass::DISTANCE_VINCENTY);
+   }
+   return pairs;
+}
+
+static double distanceOf(const TierClass &tier, const PairClass &pair)
+{
+   if (tier.plain) return GpsDecoderClass::distanceBetween(pair.lat1, pair.lng1, pair.lat2, pair.lng2);
+   return GpsDecoderClass::distanceBetween(pair.lat1, pair.lng1, pair.lat2, pair.lng2, tier.method, AUTO_DISTANCE_TOLERANCE);
+}
+
+static double courseOf(const TierClass &tier, const PairClass &pair)
+{
+   if (tier.plain) return GpsDecoderClass::courseTo(pair.lat1, pair.lng1, pair.lat2, pair.lng2);
+   return GpsDecoderClass::courseTo(pair.lat1, pair.lng1, pair.lat2, pair.lng2, tier.method, AUTO_COURSE_TOLERANCE);
+}
+
+// Prints ns per call and the largest error of one tier over one set
+static void measure(const TierClass &tier, const std::vector<PairClass> &pairs)
+{
+   double distanceError = 0, courseError = 0, sum = 0;
+
+   for (size_t i = 0; i < pairs.size(); i++)
+   {
+      distanceError = fmax(distanceError, fabs(distanceOf(tier, pairs[i]) - pairs[i].distance));
+      courseError = fmax(courseError, angleDifference(courseOf(tier, pairs[i]), pairs[i].course));
+   }
+
+   double start = benchNow();
+   for (int round = 0; round < ROUNDS; round++)
+   {
+      for (size_t i = 0; i < pairs.size(); i++) sum += distanceOf(tier, pairs[i]);
+   }
+   double distanceTime = (benchNow() - start) * 1e9 / (ROUNDS * pairs.size());
+
+   start = benchNow();
+   for (int round = 0; round < ROUNDS; round++)
+   {
+      for (size_t i = 0; i < pairs.size(); i++) sum += courseOf(tier, pairs[i]);
+   }
+   double courseTime = (benchNow() - start) * 1e9 / (ROUNDS * pairs.size());
+   sink = sum;
+
+   printf("%-18s %10.1f %12.2e %10.1f %12.2e\n", tier.name, distanceTime, distanceError, courseTime, courseError);
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   srand(1);
+   std::vector<PairClass> hops = makePairs(true);
+   std::vector<PairClass> globe = makePairs(false);
+
+   printf("%d pairs per set, ns per call, largest difference to DISTANCE_VINCENTY in m and degrees\n", PAIRS);
+   printf("auto: tolerance %g m and %g degrees\n", AUTO_DISTANCE_TOLERANCE, AUTO_COURSE_TOLERANCE);
+
+   for (int set = 0; set < 2; set++)
+   {
+      printf("\n%s\n", set == 0 ? "hops up to 100 m" : "random pairs up to 18000 km");
+      printf("%-18s %10s %12s %10s %12s\n", "tier", "distance", "error m", "course", "error deg");
+      for (size_t i = 0; i < sizeof(tiers) / sizeof(tiers[0]); i++) measure(tiers[i], set == 0 ? hops : globe);
+   }
+
+   return 0;
+}
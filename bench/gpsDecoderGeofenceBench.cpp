@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the fixes per second over the fence count benchmark of gpsDecoderGeofence.h
+///
+/// Fences of 30 to 400 m, a quarter circles and the rest polygons of 5 to 24 corners, are spread
+/// over 0.5 x 0.8 degrees, together with one large fence. A 10 Hz track at 15 m/s runs through
+/// them. The grid is the geofence with its default cells. The linear loop is the same geofence
+/// with one cell of 180 degrees, so every fix tests the bounding box of every fence and the
+/// fence itself, if the box contains the fix. Both must report the same events.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderGeofence.h"
+#include "benchNmea.h"
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define FIXES                             200000
+#define LINEAR_TESTS                      200000000.0         // Fence tests of the linear loop per fence count
+#define LINEAR_CELL                       1800000000          // 1e-7 degrees, one cell for the whole region
+#define REGION_LAT                        50.0
+#define REGION_LNG                        8.0
+#define REGION_HEIGHT                     0.5
+#define REGION_WIDTH                      0.8
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static const int fenceCounts[] = { 100, 1000, 5000, 20000, 50000 };
+static std::vector<int32_t> trackLat, trackLng;
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static double uniform(double low, double high)
+{
+   return low + (high - low) * rand() / RAND_MAX;
+}
+
+static int32_t toE7(double degrees)
+{
+   return (int32_t)lround(degrees * 1e7);
+}
+
+static void countEvent(const GpsDecoderGeofence::Event &event, void *events)
+{
+   (void)event;
+   (*(size_t *)events)++;
+}
+
+// Add the same random fences to both geofences
+static void addFences(int count, GpsDecoderGeofence &grid, GpsDecoderGeofence &linear)
+{
+   std::vector<int32_t> lat, lng;
+
+   for (int id = 0; id < count; id++)
+   {
+      double centerLat = uniform(REGION_LAT, REGION_LAT + REGION_HEIGHT);
+      double centerLng = uniform(REGION_LNG, REGION_LNG + REGION_WIDTH);
+      double size = uniform(30, 400);
+      uint64_t dwell = id % 3 == 0 ? 3000 : 0;
+
+      if (id % 4 == 0)
+      {
+         grid.addCircle(id, toE7(centerLat), toE7(centerLng), size, dwell);
+         linear.addCircle(id, toE7(centerLat), toE7(centerLng), size, dwell);
+         continue;
+      }
+
+      int corners = 5 + rand() % 20;
+      lat.clear();
+      lng.clear();
+      for (int k = 0; k < corners; k++)
+      {
+         double angle = 2 * M_PI * k / corners, radius = size * uniform(0.4, 1.0);
+         lat.push_back(toE7(centerLat + radius * cos(angle) / 111000));
+         lng.push_back(toE7(centerLng + radius * sin(angle) / 71000));
+      }
+      grid.addPolygon(id, lat.data(), lng.data(), corners, dwell);
+      linear.addPolygon(id, lat.data(), lng.data(), corners, dwell);
+   }
+
+   // One fence over most of the region
+   const int32_t largeLat[] = { toE7(REGION_LAT + 0.1), toE7(REGION_LAT + 0.4), toE7(REGION_LAT + 0.35), toE7(REGION_LAT + 0.05) };
+   const int32_t largeLng[] = { toE7(REGION_LNG + 0.1), toE7(REGION_LNG + 0.2), toE7(REGION_LNG + 0.7), toE7(REGION_LNG + 0.6) };
+   grid.addPolygon(count, largeLat, largeLng, 4);
+   linear.addPolygon(count, largeLat, largeLng, 4);
+}
+
+// Fixes per second over the first fixes of the track, compareEvents gets the events of the first compareFixes
+static double fixesPerSecond(GpsDecoderGeofence &geofence, size_t fixes, size_t compareFixes, size_t &compareEvents)
+{
+   size_t events = 0;
+   geofence.onEvent(countEvent, &events);
+   geofence.build();
+
+   double start = benchNow();
+   for (size_t i = 0; i < fixes; i++)
+   {
+      geofence.update(i * 10, trackLat[i], trackLng[i]);
+      if (i + 1 == compareFixes) compareEvents = events;
+   }
+   return fixes / (benchNow() - start);
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   bool ok = true;
+
+   // The track turns back at the border of the region
+   srand(7);
+   double lat = REGION_LAT + REGION_HEIGHT / 2, lng = REGION_LNG + REGION_WIDTH / 2, heading = uniform(0, 2 * M_PI);
+   for (size_t i = 0; i < FIXES; i++)
+   {
+      heading += uniform(-0.05, 0.05);
+      lat += 1.5 * cos(heading) / 111000;
+      lng += 1.5 * sin(heading) / 71000;
+      if (lat < REGION_LAT || lat > REGION_LAT + REGION_HEIGHT || lng < REGION_LNG || lng > REGION_LNG + REGION_WIDTH)
+      {
+         heading += M_PI;
+         lat = fmin(fmax(lat, REGION_LAT), REGION_LAT + REGION_HEIGHT);
+         lng = fmin(fmax(lng, REGION_LNG), REGION_LNG + REGION_WIDTH);
+      }
+      trackLat.push_back(toE7(lat));
+      trackLng.push_back(toE7(lng));
+   }
+
+   printf("10 Hz track, %d fixes for the grid, million fixes per second, events of the fixes run by both\n\n", FIXES);
+   printf("%8s %12s %12s %10s %10s\n", "fences", "grid", "linear", "speedup", "events");
+
+   for (size_t n = 0; n < sizeof(fenceCounts) / sizeof(fenceCounts[0]); n++)
+   {
+      GpsDecoderGeofence grid, linear(LINEAR_CELL);
+      addFences(fenceCounts[n], grid, linear);
+
+      // The linear loop only runs over the start of the track, the events are compared there
+      size_t linearFixes = (size_t)fmin(FIXES, LINEAR_TESTS / fenceCounts[n]);
+      size_t gridEvents = 0, linearEvents = 0;
+      double gridRate = fixesPerSecond(grid, FIXES, linearFixes, gridEvents);
+      double linearRate = fixesPerSecond(linear, linearFixes, linearFixes, linearEvents);
+
+      printf("%8d %12.2f %12.3f %9.0fx %10zu%s\n", fenceCounts[n], gridRate / 1e6, linearRate / 1e6, gridRate / linearRate, gridEvents,
+             gridEvents == linearEvents ? "" : "  EVENTS DIFFER");
+      if (gridEvents != linearEvents) ok = false;
+   }
+
+   return ok ? 0 : 1;
+}
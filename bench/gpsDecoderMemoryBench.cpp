@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the memory per stream benchmark of gpsDecoderPool.h
+///
+/// 10000 streams are created in a pool of GpsDecoderClass, of GpsDecoder<> and of a fleet
+/// config with location, time, date, speed and course only. The heap in use is taken from
+/// glibc after the streams are created and after every stream got an 8 KB burst.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderPool.h"
+#include "gpsDecoderTemplate.h"
+#include "benchNmea.h"
+#include <string>
+#include <stdio.h>
+#ifdef __GLIBC__
+   #include <malloc.h>
+#endif
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define STREAMS                           10000
+#define BURST                             8192
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+struct FleetConfig : GpsDecoderDefaultConfig
+{
+   static constexpr uint16_t fields = GPS_DECODER_FIELD_LOCATION | GPS_DECODER_FIELD_TIME | GPS_DECODER_FIELD_DATE |
+                                      GPS_DECODER_FIELD_SPEED | GPS_DECODER_FIELD_COURSE;
+};
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// Bytes of heap in use, 0 if the C library can not tell
+static size_t heapInUse()
+{
+#ifdef __GLIBC__
+   struct mallinfo2 info = mallinfo2();
+   return info.uordblks + info.hblkhd;
+#else
+   return 0;
+#endif
+}
+
+template <class Decoder>
+static void measure(const char *name, const std::string &burst)
+{
+   size_t created, idle;
+
+   {
+      GpsDecoderPool<Decoder> pool(1);
+      size_t start = heapInUse();
+
+      for (uint32_t id = 0; id < STREAMS; id++) pool.decoder(id);
+      created = heapInUse() - start;
+
+      for (uint32_t id = 0; id < STREAMS; id++) pool.submit(id, burst.data(), burst.size());
+      pool.wait();
+      idle = heapInUse() - start;
+   }
+
+   printf("%-24s %8zu %12.0f %12.0f\n", name, sizeof(Decoder), (double)created / STREAMS, (double)idle / STREAMS);
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   std::string burst = BenchTrack::log(BURST).substr(0, BURST);
+
+   printf("%d streams, bytes per stream, after creating them and after a %d byte burst each\n\n", STREAMS, BURST);
+   printf("%-24s %8s %12s %12s\n", "decoder", "sizeof", "created", "after burst");
+
+   measure<GpsDecoderClass>("GpsDecoderClass", burst);
+   measure<GpsDecoder<> >("GpsDecoder<>", burst);
+   measure<GpsDecoder<FleetConfig> >("GpsDecoder<FleetConfig>", burst);
+
+   return 0;
+}
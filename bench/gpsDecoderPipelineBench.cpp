@@ -0,0 +1,92 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the benchmark of gpsDecoderPipeline.h against the serial decoder
+///
+/// A 20 MB log is decoded in 4 KB pieces by GpsDecoderClass::decode and by pipelines with 1 to
+/// 2 * cores parsers. The wall time per line shows the speedup with enough cores, the time the
+/// calling thread spends per line shows the cost of framing and commit, which does not scale.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderPipeline.h"
+#include "benchNmea.h"
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <stdio.h>
+#include <time.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define LOG_BYTES                         (20 * 1000 * 1000)
+#define PIECE                             4096
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// CPU seconds of the calling thread
+static double threadSeconds()
+{
+   timespec now;
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+   return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   size_t cores = std::thread::hardware_concurrency();
+   if (cores == 0) cores = 1;
+
+   std::string log = BenchTrack::log(LOG_BYTES);
+   size_t lines = std::count(log.begin(), log.end(), '\n');
+
+   printf("%zu cores, %zu lines, %d byte pieces, ns per line\n\n", cores, lines, PIECE);
+   printf("%-12s %10s %14s %10s %10s\n", "decoder", "wall", "calling thread", "speedup", "frames");
+
+   GpsDecoderClass serial;
+   double wall = benchNow();
+   double cpu = threadSeconds();
+   for (size_t offset = 0; offset < log.size(); offset += PIECE) serial.decode(log.data() + offset, std::min<size_t>(PIECE, log.size() - offset));
+   double serialWall = benchNow() - wall;
+   cpu = threadSeconds() - cpu;
+
+   printf("%-12s %10.0f %14.0f %10.2f %10u\n", "serial", serialWall * 1e9 / lines, cpu * 1e9 / lines, 1.0, serial.passedChecksum());
+
+   for (size_t parsers = 1; parsers <= 2 * cores; parsers *= 2)
+   {
+      GpsDecoderClass decoder;
+      GpsDecoderPipeline pipeline(decoder, parsers);
+
+      wall = benchNow();
+      cpu = threadSeconds();
+      for (size_t offset = 0; offset < log.size(); offset += PIECE) pipeline.decode(log.data() + offset, std::min<size_t>(PIECE, log.size() - offset));
+      pipeline.flush();
+      wall = benchNow() - wall;
+      cpu = threadSeconds() - cpu;
+
+      char name[32];
+      snprintf(name, sizeof(name), "%zu parsers", parsers);
+      printf("%-12s %10.0f %14.0f %10.2f %10u\n", name, wall * 1e9 / lines, cpu * 1e9 / lines, serialWall / wall, decoder.passedChecksum());
+   }
+
+   return 0;
+}
@@ -0,0 +1,180 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the stream scaling benchmark of gpsDecoderPool.h
+///
+/// 100 to 10000 streams, each with its own track, are submitted in 512 byte pieces by two
+/// threads and decoded by 1 to 2 * cores workers. The fairness run floods 100 hot streams
+/// from an own thread and measures, how long 1000 other streams wait for their bytes.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderPool.h"
+#include "benchNmea.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define STREAM_BYTES                      8192                // Log of every stream
+#define PIECE                             512                 // Bytes per submit
+#define SUBMITTERS                        2
+#define HOT                               100                 // Streams flooded in the fairness run
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// GGA handler, counts into the atomic context
+static void countGGA(GpsDecoderClass &, void *context)
+{
+   static_cast<std::atomic<uint64_t> *>(context)->fetch_add(1, std::memory_order_relaxed);
+}
+
+// Submit the logs of all streams piece by piece, returns the seconds and sets the bytes and passed frames
+static double throughput(const std::vector<std::string> &logs, size_t threads, size_t &bytes, uint64_t &frames)
+{
+   GpsDecoderPool<> pool(threads);
+   size_t streams = logs.size();
+
+   for (size_t id = 0; id < streams; id++) pool.decoder((uint32_t)id);
+
+   double start = benchNow();
+
+   std::vector<std::thread> submitters;
+   for (size_t s = 0; s < SUBMITTERS; s++)
+   {
+      submitters.push_back(std::thread([&, s]()
+      {
+         for (size_t offset = 0; offset < STREAM_BYTES; offset += PIECE)
+         {
+            for (size_t id = s; id < streams; id += SUBMITTERS)
+            {
+               const std::string &log = logs[id];
+               if (offset < log.size()) pool.submit((uint32_t)id, log.data() + offset, std::min<size_t>(PIECE, log.size() - offset));
+            }
+         }
+      }));
+   }
+   for (size_t s = 0; s < submitters.size(); s++) submitters[s].join();
+   pool.wait();
+
+   double seconds = benchNow() - start;
+
+   frames = 0;
+   bytes = 0;
+   for (size_t id = 0; id < streams; id++)
+   {
+      frames += pool.decoder((uint32_t)id).passedChecksum();
+      bytes += logs[id].size();
+   }
+   return seconds;
+}
+
+// Milliseconds until the GGAs of the cold streams are decoded, while the hot streams are flooded
+static double fairness(const std::vector<std::string> &logs, size_t threads, uint64_t coldGGA)
+{
+   GpsDecoderPool<> pool(threads);
+   std::atomic<uint64_t> cold(0);
+   std::atomic<uint64_t> hotGGA(0);
+   std::atomic<bool> done(false);
+
+   for (size_t id = 0; id < HOT; id++) pool.decoder((uint32_t)id).onGGA(countGGA, &hotGGA);
+   for (size_t id = HOT; id < logs.size(); id++) pool.decoder((uint32_t)id).onGGA(countGGA, &cold);
+
+   std::thread flood([&]()
+   {
+      for (size_t offset = 0; !done.load(std::memory_order_relaxed); offset = (offset + PIECE) % (STREAM_BYTES - PIECE))
+      {
+         for (size_t id = 0; id < HOT; id++) pool.submit((uint32_t)id, logs[id].data() + offset, PIECE);
+      }
+   });
+
+   // Let the hot streams get going
+   while (hotGGA.load(std::memory_order_relaxed) == 0) std::this_thread::yield();
+
+   double start = benchNow();
+   for (size_t id = HOT; id < logs.size(); id++) pool.submit((uint32_t)id, logs[id].data(), logs[id].size());
+
+   double waited = -1.0;
+   while (benchNow() - start < 10.0)
+   {
+      if (cold.load(std::memory_order_relaxed) == coldGGA)
+      {
+         waited = (benchNow() - start) * 1e3;
+         break;
+      }
+      std::this_thread::yield();
+   }
+
+   done.store(true);
+   flood.join();
+   return waited;
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   size_t cores = std::thread::hardware_concurrency();
+   if (cores == 0) cores = 1;
+
+   std::vector<std::string> logs;
+   for (uint32_t id = 0; id < 10000; id++) logs.push_back(BenchTrack::log(STREAM_BYTES, id + 1).substr(0, STREAM_BYTES));
+
+   printf("%zu cores, %d bytes per stream in %d byte submits from %d threads\n\n", cores, STREAM_BYTES, PIECE, SUBMITTERS);
+   printf("%-8s %-8s %10s %14s\n", "streams", "workers", "MB/s", "frames/s");
+
+   for (size_t streams = 100; streams <= logs.size(); streams *= 10)
+   {
+      std::vector<std::string> part(logs.begin(), logs.begin() + streams);
+
+      for (size_t threads = 1; threads <= 2 * cores; threads *= 2)
+      {
+         size_t bytes;
+         uint64_t frames;
+         double seconds = throughput(part, threads, bytes, frames);
+
+         printf("%-8zu %-8zu %10.1f %14.0f\n", streams, threads, bytes / seconds / 1e6, frames / seconds);
+      }
+   }
+
+   // The cold streams get one submit each, count the GGAs a single decoder sees in them
+   std::vector<std::string> fleet(logs.begin(), logs.begin() + HOT + 1000);
+   uint64_t coldGGA = 0;
+   for (size_t id = HOT; id < fleet.size(); id++)
+   {
+      GpsDecoderClass decoder;
+      std::atomic<uint64_t> count(0);
+      decoder.onGGA(countGGA, &count);
+      decoder.decode(fleet[id].data(), fleet[id].size());
+      coldGGA += count.load();
+   }
+
+   printf("\nfairness, 1000 cold streams submitted once while %d hot streams are flooded\n", HOT);
+   for (size_t threads = 1; threads <= 2 * cores; threads *= 2)
+   {
+      double waited = fairness(fleet, threads, coldGGA);
+      if (waited < 0) printf("%zu workers: cold streams not decoded within 10 s\n", threads);
+      else printf("%zu workers: cold streams decoded after %.1f ms\n", threads, waited);
+   }
+
+   return 0;
+}
@@ -0,0 +1,163 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the reader scaling benchmark of gpsDecoderRing.h
+///
+/// 1 to 2 * cores reader threads load the most recent record from GpsDecoderLatest, from
+/// GpsDecoderBroadcast and, as reference, from a record behind a std::mutex. The writer
+/// publishes either 1000 records/s or as fast as it can.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderRing.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define RUN_MS                            300
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderClass::FixRecord FixRecord;
+
+// Most recent record behind a lock, the reference
+class MutexLatest
+{
+   public:
+      void store(const FixRecord &value)   { std::lock_guard<std::mutex> lock(mutex); record = value; }
+      uint64_t load(FixRecord &value)      { std::lock_guard<std::mutex> lock(mutex); value = record; return 1; }
+
+   private:
+      std::mutex mutex;
+      FixRecord record;
+};
+
+// Broadcast reader with the interface of load, counts received and lost records
+class BroadcastLatest
+{
+   public:
+      explicit BroadcastLatest(GpsDecoderBroadcast<16> &broadcast) : reader(broadcast) {}
+      uint64_t load(FixRecord &value)      { return reader.pop(value) ? 1 : 0; }
+
+   private:
+      GpsDecoderBroadcast<16>::Reader reader;
+};
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// Loads per second of all readers together, while the writer publishes busy or at 1 kHz
+template <class Writer, class MakeReader>
+static double run(Writer &writer, MakeReader makeReader, int readerCount, bool busy)
+{
+   std::atomic<bool> done(false);
+   std::atomic<uint64_t> loads(0);
+   std::vector<std::thread> readers;
+
+   for (int r = 0; r < readerCount; r++)
+   {
+      readers.push_back(std::thread([&]()
+      {
+         auto reader = makeReader();
+         FixRecord record;
+         uint64_t count = 0;
+
+         while (!done.load(std::memory_order_relaxed))
+         {
+            reader->load(record);
+            count++;
+         }
+         loads += count;
+      }));
+   }
+
+   std::thread publisher([&]()
+   {
+      FixRecord record = FixRecord();
+
+      while (!done.load(std::memory_order_relaxed))
+      {
+         record.time++;
+         writer.store(record);
+         if (!busy) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+   });
+
+   std::this_thread::sleep_for(std::chrono::milliseconds(RUN_MS));
+   done.store(true);
+
+   publisher.join();
+   for (size_t r = 0; r < readers.size(); r++) readers[r].join();
+
+   return loads.load() * 1000.0 / RUN_MS;
+}
+
+// Writer of the broadcast with the interface of store
+struct BroadcastWriter
+{
+   GpsDecoderBroadcast<16> broadcast;
+   void store(const FixRecord &record)   { broadcast.push(record); }
+};
+
+// Reader access to a shared latest record
+template <class Latest>
+struct SharedReader
+{
+   Latest *latest;
+   uint64_t load(FixRecord &record)   { return latest->load(record); }
+};
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   int cores = (int)std::thread::hardware_concurrency();
+   if (cores < 1) cores = 1;
+
+   printf("%d cores, %d ms per run, million loads/s of all readers together\n\n", cores, RUN_MS);
+   printf("%-8s %-8s %12s %12s %12s\n", "writer", "readers", "latest", "broadcast", "mutex");
+
+   for (int b = 0; b < 2; b++)
+   {
+      bool busy = b == 1;
+
+      for (int readerCount = 1; readerCount <= 2 * cores; readerCount *= 2)
+      {
+         GpsDecoderLatest latest;
+         BroadcastWriter broadcast;
+         MutexLatest mutex;
+
+         double latestRate = run(latest, [&]() { return std::unique_ptr<SharedReader<GpsDecoderLatest> >(new SharedReader<GpsDecoderLatest>{&latest}); }, readerCount, busy);
+         double broadcastRate = run(broadcast, [&]() { return std::unique_ptr<BroadcastLatest>(new BroadcastLatest(broadcast.broadcast)); }, readerCount, busy);
+         double mutexRate = run(mutex, [&]() { return std::unique_ptr<SharedReader<MutexLatest> >(new SharedReader<MutexLatest>{&mutex}); }, readerCount, busy);
+
+         printf("%-8s %-8d %12.1f %12.1f %12.1f\n", busy ? "busy" : "1 kHz", readerCount, latestRate / 1e6, broadcastRate / 1e6, mutexRate / 1e6);
+      }
+   }
+
+   return 0;
+}
@@ -0,0 +1,203 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the implementation of sub class EpochClass for GpsDecoderClass
+///
+/// A receiver sends several sentences per epoch, GGA, RMC, GSA, GSV, VTG, ... The epoch
+/// collects the values of all of them into one FixRecord and hands it over as a whole, when
+/// the end of epoch rule has been met. Only values received within the epoch are set.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <string.h>
+
+
+// ******************************************************************
+// Constructor
+// ******************************************************************
+GpsDecoderClass::EpochClass::EpochClass()
+{
+   valid = false;
+   updated = false;
+   epochCount = 0;
+   lastSentenceTime = 0;
+   memset(&record, 0, sizeof(record));
+   memset(&next, 0, sizeof(next));
+   handler = NULL;
+   handlerContext = NULL;
+
+   // The first sentence of the next epoch ends the current one
+   setRule(GPS_DECODER_EPOCH_TIME_CHANGE, 0, 0);
+}
+
+
+// ******************************************************************
+// Methods
+// ******************************************************************
+
+// Select when an epoch is complete, any of the rules ends it
+// lastSentence is used by GPS_DECODER_EPOCH_LAST_SENTENCE, timeout by GPS_DECODER_EPOCH_TIMEOUT
+void GpsDecoderClass::EpochClass::setRule(uint8_t rules, uint16_t lastSentence, uint16_t timeout)
+{
+   this->rules = rules;
+   this->lastSentence = lastSentence;
+   this->timeout = timeout;
+}
+
+// Copies the last complete epoch into record
+// Returns false and leaves record untouched, if there is no new epoch since the last call
+bool GpsDecoderClass::EpochClass::read(FixRecord &record)
+{
+   checkTimeout();
+
+   if (!updated) return false;
+
+   record = this->record;
+   updated = false;
+   return true;
+}
+
+// Close the open epoch, if a sentence, which passed the checksum test, already belongs to the next one
+// Called before the sentence is committed, so the handler sees only values of the closed epoch
+void GpsDecoderClass::EpochClass::begin(const SentenceClass &sentence)
+{
+   bool hasTime = (sentenceFilterBit(sentence.type) & (GPS_DECODER_SENTENCE_GGA | GPS_DECODER_SENTENCE_RMC)) && sentence.isValid(1);
+
+   checkTimeout();
+   if ((rules & GPS_DECODER_EPOCH_TIME_CHANGE) && hasTime && (next.valid & GPS_DECODER_FIELD_TIME) && next.time != sentence.time)
+   {
+      commit();
+   }
+}
+
+// Add the values of a sentence, which has been committed, to the open epoch
+void GpsDecoderClass::EpochClass::add(const SentenceClass &sentence, const SatellitesClass &satellites)
+{
+   uint16_t sentenceBit = sentenceFilterBit(sentence.type);
+   bool hasTime = (sentenceBit & (GPS_DECODER_SENTENCE_GGA | GPS_DECODER_SENTENCE_RMC)) && sentence.isValid(1);
+
+   lastSentenceTime = millis();
+   next.sentences |= sentenceBit;
+
+   if (hasTime)
+   {
+      next.time = sentence.time;
+      next.valid |= GPS_DECODER_FIELD_TIME;
+   }
+
+   switch (sentenceBit)
+   {
+      case GPS_DECODER_SENTENCE_GGA:
+         if (sentence.isValid(2) && sentence.isValid(4))
+         {
+            next.latE7 = sentence.latitude.toE7();
+            next.lngE7 = sentence.longitude.toE7();
+            next.valid |= GPS_DECODER_FIELD_LOCATION;
+         }
+         if (sentence.isValid(9))
+         {
+            next.altitude = sentence.altitude;
+            next.valid |= GPS_DECODER_FIELD_ALTITUDE;
+         }
+         break;
+
+      case GPS_DECODER_SENTENCE_RMC:
+         if (sentence.status == 'A' && sentence.isValid(3) && sentence.isValid(5))
+         {
+            next.latE7 = sentence.latitude.toE7();
+            next.lngE7 = sentence.longitude.toE7();
+            next.valid |= GPS_DECODER_FIELD_LOCATION;
+         }
+         if (sentence.isValid(7))
+         {
+            next.speed = sentence.speed;
+            next.valid |= GPS_DECODER_FIELD_SPEED;
+         }
+         if (sentence.isValid(9))
+         {
+            next.date = sentence.date;
+            next.valid |= GPS_DECODER_FIELD_DATE;
+         }
+         break;
+
+      case GPS_DECODER_SENTENCE_GSA:
+         // Receivers send one GSA per system with the same dops
+         if (sentence.isValid(15) && sentence.isValid(16) && sentence.isValid(17))
+         {
+            next.pdop = sentence.pdop;
+            next.hdop = sentence.hdop;
+            next.vdop = sentence.vdop;
+            next.valid |= GPS_DECODER_FIELD_DOP;
+         }
+         if (sentence.isValid(2))
+         {
+            next.fixedType = sentence.fixedType;
+            next.valid |= GPS_DECODER_FIELD_FIXED_TYPE;
+         }
+         // fall through
+
+      case GPS_DECODER_SENTENCE_GSV:
+         // The satellite tables have already been committed, take the sums over all systems
+         {
+            uint16_t used = satellites.gps.activeCount() + satellites.glonass.activeCount() + satellites.baidu.activeCount();
+            uint16_t inView = satellites.gps.satellitesInView() + satellites.glonass.satellitesInView() + satellites.baidu.satellitesInView();
+            next.satellitesUsed = used < 0xff ? used : 0xff;
+            next.satellitesInView = inView < 0xff ? inView : 0xff;
+            next.valid |= GPS_DECODER_FIELD_SATELLITES;
+         }
+         break;
+
+      case GPS_DECODER_SENTENCE_VTG:
+         if (sentence.status == 'T' && sentence.isValid(1) && sentence.isValid(5))
+         {
+            next.speed = sentence.speed;
+            next.course = sentence.course;
+            next.valid |= GPS_DECODER_FIELD_SPEED | GPS_DECODER_FIELD_COURSE;
+         }
+         break;
+
+      default:
+         break;
+   }
+
+   // Close the epoch behind its last sentence
+   if ((rules & GPS_DECODER_EPOCH_LAST_SENTENCE) && (lastSentence & sentenceBit))
+   {
+      commit();
+   }
+}
+
+// Close the open epoch, if no sentence has been received within the timeout
+void GpsDecoderClass::EpochClass::checkTimeout()
+{
+   if ((rules & GPS_DECODER_EPOCH_TIMEOUT) && next.sentences && millis() - lastSentenceTime >= timeout)
+   {
+      commit();
+   }
+}
+
+// Hand over the open epoch as complete fix record and start an empty one
+void GpsDecoderClass::EpochClass::commit()
+{
+   if (!next.sentences) return;
+
+   record = next;
+   memset(&next, 0, sizeof(next));
+
+   epochCount++;
+   lastCommitTime = millis();
+   valid = updated = true;
+
+   if (handler) handler(record, handlerContext);
+}
@@ -0,0 +1,195 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the implementation of sub class FieldClass for GpsDecoderClass
+///
+/// The number parsers work only on the chars of the field, do not need a 0 termination
+/// and do not depend on the locale. All values are returned as integer fixed point.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define FIELD_DIGIT(c)     ((uint8_t)((c) - '0'))
+#define FIELD_IS_DIGIT(c)  (FIELD_DIGIT(c) <= 9)
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// value = value * 10 + digit, false if the result does not fit into 32 bit
+static inline bool appendDigit(uint32_t &value, uint8_t digit)
+{
+   if (value > (UINT32_MAX - digit) / 10) return false;
+   value = value * 10 + digit;
+   return true;
+}
+
+
+// ******************************************************************
+// Methods
+// ******************************************************************
+
+// Parse an unsigned integer "123"
+// Returns false and 0 if the field is empty, contains anything else than digits or does not fit into 32 bit
+bool GpsDecoderClass::FieldClass::toUnsigned(uint32_t &value) const
+{
+   uint32_t result = 0;
+   value = 0;
+
+   if (len == 0) return false;
+
+   for (uint8_t i = 0; i < len; i++)
+   {
+      if (!FIELD_IS_DIGIT(str[i]) || !appendDigit(result, FIELD_DIGIT(str[i]))) return false;
+   }
+
+   value = result;
+   return true;
+}
+
+// Parse a signed decimal number "-12.345" into fixed point with the given number of decimals
+// Decimals behind the requested ones are truncated, "-12.345" with 2 decimals -> -1234
+// Returns false and 0 if the field is empty, malformed or the fixed point value does not fit into 32 bit
+bool GpsDecoderClass::FieldClass::toFixed(uint8_t decimals, int32_t &value) const
+{
+   uint8_t i = 0;
+   bool negative = false;
+   uint32_t result = 0;
+   value = 0;
+
+   if (len == 0) return false;
+
+   if (str[0] == '-' || str[0] == '+')
+   {
+      negative = str[0] == '-';
+      i++;
+   }
+
+   // Integer part
+   uint8_t firstDigit = i;
+   for (; i < len && FIELD_IS_DIGIT(str[i]); i++)
+   {
+      if (!appendDigit(result, FIELD_DIGIT(str[i]))) return false;
+   }
+   bool hasDigits = i > firstDigit;
+
+   // Fractional part, fill up missing decimals with 0
+   uint8_t scale = decimals;
+   if (i < len && str[i] == '.')
+   {
+      for (i++; i < len && FIELD_IS_DIGIT(str[i]); i++)
+      {
+         hasDigits = true;
+         if (scale == 0) continue;
+         if (!appendDigit(result, FIELD_DIGIT(str[i]))) return false;
+         scale--;
+      }
+   }
+   for (; scale > 0; scale--)
+   {
+      if (!appendDigit(result, 0)) return false;
+   }
+
+   if (i != len || !hasDigits || result > (uint32_t)INT32_MAX) return false;
+
+   value = negative ? -(int32_t)result : (int32_t)result;
+   return true;
+}
+
+// Parse a NMEA time "hhmmss.ss" into hhmmsscc, more than two decimals are truncated
+// Returns false and 0 if the field is empty or malformed
+bool GpsDecoderClass::FieldClass::toTime(uint32_t &value) const
+{
+   value = 0;
+
+   if (len < 6) return false;
+   for (uint8_t i = 0; i < 6; i++)
+   {
+      if (!FIELD_IS_DIGIT(str[i])) return false;
+   }
+
+   // Fast path, all receivers send the six digits of hhmmss in front
+   uint32_t result = FIELD_DIGIT(str[0]) * 100000 + FIELD_DIGIT(str[1]) * 10000 + FIELD_DIGIT(str[2]) * 1000 +
+                     FIELD_DIGIT(str[3]) * 100 + FIELD_DIGIT(str[4]) * 10 + FIELD_DIGIT(str[5]);
+   result *= 100;
+
+   // Optional fractional seconds
+   if (len > 6)
+   {
+      if (str[6] != '.') return false;
+      for (uint8_t i = 7; i < len; i++)
+      {
+         if (!FIELD_IS_DIGIT(str[i])) return false;
+      }
+      if (len > 7) result += FIELD_DIGIT(str[7]) * 10;
+      if (len > 8) result += FIELD_DIGIT(str[8]);
+   }
+
+   value = result;
+   return true;
+}
+
+// Parse a NMEA date "ddmmyy" into ddmmyy
+// Returns false and 0 if the field is empty or malformed
+bool GpsDecoderClass::FieldClass::toDate(uint32_t &value) const
+{
+   if (len != 6)
+   {
+      value = 0;
+      return false;
+   }
+
+   return toUnsigned(value);
+}
+
+// Parse degrees in that funny NMEA format DDMM.MMMM or DDDMM.MMMM
+// Returns false and 0 degrees if the field is empty, malformed or beyond maxDegrees, 90 for latitudes and 180 for longitudes
+bool GpsDecoderClass::FieldClass::toDegrees(RawDegreesClass &deg, uint16_t maxDegrees) const
+{
+   uint8_t i = 0;
+   uint32_t leftOfDecimal = 0;
+   uint32_t multiplier = 10000000UL;
+   uint32_t tenMillionthsOfMinutes = 0;
+
+   deg.deg = 0;
+   deg.billionths = 0;
+   deg.negative = false;
+
+   for (; i < len && FIELD_IS_DIGIT(str[i]); i++)
+   {
+      leftOfDecimal = leftOfDecimal * 10 + FIELD_DIGIT(str[i]);
+   }
+   if (i == 0 || i > 5 || leftOfDecimal % 100 >= 60) return false;
+
+   if (i < len && str[i] == '.')
+   {
+      for (i++; i < len && FIELD_IS_DIGIT(str[i]); i++)
+      {
+         multiplier /= 10;
+         tenMillionthsOfMinutes += FIELD_DIGIT(str[i]) * multiplier;
+      }
+   }
+   if (i != len) return false;
+
+   tenMillionthsOfMinutes += (leftOfDecimal % 100) * 10000000UL;
+   if (leftOfDecimal / 100 > maxDegrees || (leftOfDecimal / 100 == maxDegrees && tenMillionthsOfMinutes != 0)) return false;
+   deg.deg = (uint16_t)(leftOfDecimal / 100);
+   deg.billionths = (5 * tenMillionthsOfMinutes + 1) / 3;
+   return true;
+}
@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the implementation of sub class FrameStateClass for GpsDecoderClass
+///
+/// The frame state is everything which is only needed between the $ and the \n of a frame,
+/// checksums, the current field and the staged values of the sentence. The decoded values
+/// are kept in the other sub classes. GpsDecoder<Config> uses the same frame state.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <string.h>
+#include <ctype.h>
+
+
+// ******************************************************************
+// Constructor
+// ******************************************************************
+GpsDecoderClass::FrameStateClass::FrameStateClass()
+{
+   memset(&currentField[0], 0, sizeof(currentField));
+   start();
+   waitForFrameStart = false;
+}
+
+
+// ******************************************************************
+// Methods
+// ******************************************************************
+
+// Reset the frame state, a new frame starts
+void GpsDecoderClass::FrameStateClass::start()
+{
+   calculatedChecksum = 0;
+   receivedChecksum = 0;
+   receivedChecksumDigits = 0;
+   currentFieldOffset = 0;
+   currentFieldIndex = 0;
+   currentSentence.talker = 0;                                  // A broken identifier must not inherit the talker of the last frame
+   currentSentence.type = 0;
+   currentSentence.validFields = 0;
+   currentSentence.status = 0;
+   waitForFrameStart = true;
+   blockReadChecksumInCalculation = false;
+}
+
+// Xor chars into calculated checksum
+void GpsDecoderClass::FrameStateClass::addToChecksum(const char *chars, size_t count)
+{
+   for (size_t i = 0; i < count; i++)
+   {
+      calculatedChecksum ^= (uint8_t)chars[i];
+   }
+}
+
+// Add chars to the current field and the calculated checksum
+void GpsDecoderClass::FrameStateClass::appendToField(const char *chars, size_t count)
+{
+   addToChecksum(chars, count);
+
+   // Field is too long for any value, which is parsed. Mark it, so it is passed on as empty field
+   if (currentFieldOffset + count > sizeof(currentField))
+   {
+      currentFieldOffset = GPS_DECODER_FIELD_OVERFLOW;
+      return;
+   }
+
+   memcpy(&currentField[currentFieldOffset], chars, count);
+   currentFieldOffset += count;
+}
+
+// Add a received char behind the * to the received checksum
+// Only the two chars directly behind the * are the checksum, everything behind is ignored
+void GpsDecoderClass::FrameStateClass::readChecksum(char a)
+{
+   if (receivedChecksumDigits >= 2) return;
+
+   if (isxdigit(a))
+   {
+      receivedChecksum = (receivedChecksum << 4) | fromHex(a);
+      receivedChecksumDigits++;
+   }
+   else
+   {
+      receivedChecksumDigits = GPS_DECODER_CHECKSUM_INVALID;
+   }
+}
@@ -0,0 +1,155 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the implementation of sub class PreparedPointClass for GpsDecoderClass
+///
+/// A home or depot position with sin and cos of its latitude and longitude calculated once.
+/// The longitude difference of distanceBetween and courseTo is taken apart by the angle sum
+/// rules, so only the other point needs sin and cos, and two prepared points need none.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <math.h>
+
+#ifndef GPS_DECODER_NO_FLOAT
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+// distanceBetween with sin and cos of point 1 in trig1 and of point 2 as values
+static double distanceOf(const double *trig1, double sinLat2, double cosLat2, double sinLng2, double cosLng2)
+{
+   double sdlong = trig1[2] * cosLng2 - trig1[3] * sinLng2;   // sin(long1 - long2)
+   double cdlong = trig1[3] * cosLng2 + trig1[2] * sinLng2;
+   double delta = (trig1[1] * sinLat2) - (trig1[0] * cosLat2 * cdlong);
+   delta = sq(delta);
+   delta += sq(cosLat2 * sdlong);
+   delta = sqrt(delta);
+   double denom = (trig1[0] * sinLat2) + (trig1[1] * cosLat2 * cdlong);
+   delta = atan2(delta, denom);
+   return delta * 6372795;
+}
+
+// courseTo from point 1 to point 2, like distanceOf
+static double courseOf(const double *trig1, double sinLat2, double cosLat2, double sinLng2, double cosLng2)
+{
+   double sdlon = sinLng2 * trig1[3] - cosLng2 * trig1[2];   // sin(long2 - long1)
+   double cdlon = cosLng2 * trig1[3] + sinLng2 * trig1[2];
+   double a1 = sdlon * cosLat2;
+   double a2 = trig1[0] * cosLat2 * cdlon;
+   a2 = trig1[1] * sinLat2 - a2;
+   a2 = atan2(a1, a2);
+   if (a2 < 0.0)
+   {
+      a2 += GPS_DECODER_TWO_PI;
+   }
+   return degrees(a2);
+}
+
+
+// ******************************************************************
+// Constructor
+// ******************************************************************
+GpsDecoderClass::PreparedPointClass::PreparedPointClass()
+{
+   set(0.0, 0.0);
+}
+
+GpsDecoderClass::PreparedPointClass::PreparedPointClass(double lat, double lng)
+{
+   set(lat, lng);
+}
+
+
+// ******************************************************************
+// Methods
+// ******************************************************************
+void GpsDecoderClass::PreparedPointClass::set(double lat, double lng)
+{
+   latitude = lat;
+   longitude = lng;
+   trig[0] = sin(radians(lat));
+   trig[1] = cos(radians(lat));
+   trig[2] = sin(radians(lng));
+   trig[3] = cos(radians(lng));
+   x = trig[1] * trig[3];
+   y = trig[1] * trig[2];
+   z = trig[0];
+}
+
+// Reads the raw values, lat() and lng() would clear the updated flag of the location
+void GpsDecoderClass::PreparedPointClass::set(const LocationClass &location)
+{
+   set(location.rawLatData.toDegrees(), location.rawLngData.toDegrees());
+}
+
+double GpsDecoderClass::PreparedPointClass::distanceTo(const PreparedPointClass &point) const
+{
+   return distanceOf(trig, point.trig[0], point.trig[1], point.trig[2], point.trig[3]);
+}
+
+double GpsDecoderClass::PreparedPointClass::courseTo(const PreparedPointClass &point) const
+{
+   return courseOf(trig, point.trig[0], point.trig[1], point.trig[2], point.trig[3]);
+}
+
+double GpsDecoderClass::PreparedPointClass::distanceTo(double lat, double lng) const
+{
+   return distanceOf(trig, sin(radians(lat)), cos(radians(lat)), sin(radians(lng)), cos(radians(lng)));
+}
+
+double GpsDecoderClass::PreparedPointClass::courseTo(double lat, double lng) const
+{
+   return courseOf(trig, sin(radians(lat)), cos(radians(lat)), sin(radians(lng)), cos(radians(lng)));
+}
+
+// The SIMD kernels of the batch functions take the cached sin and cos, see GpsDecoderClass::batchKernel()
+void GpsDecoderClass::PreparedPointClass::distanceTo(const double *lat, const double *lng, double *distances, size_t count) const
+{
+   if (batchFrom(false, trig, lat, lng, distances, count)) return;
+
+   for (size_t i = 0; i < count; i++) distances[i] = distanceTo(lat[i], lng[i]);
+}
+
+void GpsDecoderClass::PreparedPointClass::courseTo(const double *lat, const double *lng, double *courses, size_t count) const
+{
+   if (batchFrom(true, trig, lat, lng, courses, count)) return;
+
+   for (size_t i = 0; i < count; i++) courses[i] = courseTo(lat[i], lng[i]);
+}
+
+// The chord between the unit vectors grows with the distance, so only the nearest point needs atan2
+size_t GpsDecoderClass::PreparedPointClass::nearest(const PreparedPointClass *points, size_t count, double *distance) const
+{
+   size_t best = count;
+   double bestChord = 0.0;
+
+   for (size_t i = 0; i < count; i++)
+   {
+      double dx = points[i].x - x;
+      double dy = points[i].y - y;
+      double dz = points[i].z - z;
+      double chord = dx * dx + dy * dy + dz * dz;
+      if (best == count || chord < bestChord)
+      {
+         best = i;
+         bestChord = chord;
+      }
+   }
+
+   if (distance && best < count) *distance = distanceTo(points[best]);
+   return best;
+}
+
+#endif
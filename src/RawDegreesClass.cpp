@@ -1,36 +1,49 @@
-//-----------------------------------------------------------------------------
-//
-/// @file
-/// @brief This file contains the implementation of sub class RawDegreesClass for GpsDecoderClass
-///
-/// <please insert here the optional more detail description>
-///
-//-----------------------------------------------------------------------------
-// $Author: FKSN $
-// $Change: $
-// $DateTime: 10.03.2023 $
-//
-// Creator: FKSN ()
-// Compiler: Arduino PlattformIO 
-//-----------------------------------------------------------------------------
-
-// ******************************************************************
-// Includes
-// ******************************************************************
-#include "gpsDecoder.h"
-
-
-// ******************************************************************
-// Constructor
-// ******************************************************************
-GpsDecoderClass::RawDegreesClass::RawDegreesClass()
-{
-    deg = 0;
-    billionths = 0;
-    negative = false;
-}
-
-
-// ******************************************************************
-// Methods
-// ******************************************************************
\ No newline at end of file
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the implementation of sub class RawDegreesClass for GpsDecoderClass
+///
+/// <please insert here the optional more detail description>
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 10.03.2023 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO 
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+
+
+// ******************************************************************
+// Constructor
+// ******************************************************************
+GpsDecoderClass::RawDegreesClass::RawDegreesClass()
+{
+    deg = 0;
+    billionths = 0;
+    negative = false;
+}
+
+
+// ******************************************************************
+// Methods
+// ******************************************************************
+int32_t GpsDecoderClass::RawDegreesClass::toE7() const
+{
+   int32_t ret = deg * 10000000L + (billionths + 50) / 100;
+   return negative ? -ret : ret;
+}
+
+#ifndef GPS_DECODER_NO_FLOAT
+double GpsDecoderClass::RawDegreesClass::toDegrees() const
+{
+   double ret = deg + billionths / 1000000000.0;
+   return negative ? -ret : ret;
+}
+#endif
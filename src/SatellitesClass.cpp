@@ -1,29 +1,132 @@
-//-----------------------------------------------------------------------------
-//
-/// @file
-/// @brief This file contains the implementation of sub class SatellitesClass for GpsDecoderClass
-///
-/// <please insert here the optional more detail description>
-///
-//-----------------------------------------------------------------------------
-// $Author: FKSN $
-// $Change: $
-// $DateTime: 12.03.2023 $
-//
-// Creator: FKSN ()
-// Compiler: Arduino PlattformIO 
-//-----------------------------------------------------------------------------
-
-// ******************************************************************
-// Includes
-// ******************************************************************
-#include "gpsDecoder.h"
-
-
-// ******************************************************************
-// Constructor
-// ******************************************************************
-
-// ******************************************************************
-// Methods
-// ******************************************************************
\ No newline at end of file
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the implementation of sub class SatelliteSystemClass for GpsDecoderClass
+///
+/// <please insert here the optional more detail description>
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 12.03.2023 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO 
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <string.h>
+
+
+// ******************************************************************
+// Constructor
+// ******************************************************************
+GpsDecoderClass::SatelliteSystemClass::SatelliteSystemClass()
+{
+    valid = false;
+    updated = false;
+    activeSatellites = 0;
+    front = 0;
+    nextMessage = 0;
+    totalMessages = 0;
+    skyViewsCompleted = 0;
+}
+
+GpsDecoderClass::SatelliteSystemClass::SkyViewClass::SkyViewClass()
+{
+    clear();
+}
+
+
+// ******************************************************************
+// Methods
+// ******************************************************************
+void GpsDecoderClass::SatelliteSystemClass::SkyViewClass::clear()
+{
+   entries = 0;
+   inView = 0;
+   memset(ids, 0, sizeof(ids));
+   memset(elevations, 0, sizeof(elevations));
+   memset(snrs, 0, sizeof(snrs));
+   memset(azimuths, 0, sizeof(azimuths));
+}
+
+uint8_t GpsDecoderClass::SatelliteSystemClass::activeCount() const
+{
+   uint8_t count = 0;
+   for (uint64_t mask = activeSatellites; mask; mask &= mask - 1) count++;
+   return count;
+}
+
+void GpsDecoderClass::SatelliteSystemClass::commit()
+{
+   lastCommitTime = millis();
+   valid = updated = true;
+}
+
+// Replace the active set by the ids of a GSA sentence, empty ids are skipped
+void GpsDecoderClass::SatelliteSystemClass::commitGSA(const SentenceClass &sentence)
+{
+   activeSatellites = 0;
+   for (uint8_t i = 0; i < 12; i++)
+   {
+      if (sentence.isValid(3+i) && sentence.activeSatelliteIds[i])
+      {
+         activeSatellites |= (uint64_t)1 << ((sentence.activeSatelliteIds[i] - 1) & 63);
+      }
+   }
+
+   commit();
+}
+
+// Add one GSV message to the back sky view, 4 satellites per message, so the message number is the offset in the table
+// The first message clears the back sky view, the last one makes it the front sky view. Messages out of order
+// drop the back sky view until the next first message. Satellites above the capacity are dropped.
+// Returns true if the sky view is complete and has been flipped to the front
+bool GpsDecoderClass::SatelliteSystemClass::commitGSV(const SentenceClass &sentence)
+{
+   SkyViewClass &back = views[front ^ 1];
+
+   if (sentence.messageNumber == 1)
+   {
+      back.clear();
+      totalMessages = sentence.totalMessages < 0xff ? sentence.totalMessages : 0xff;
+      nextMessage = 1;
+   }
+
+   if (nextMessage == 0 || sentence.messageNumber != nextMessage || sentence.totalMessages != totalMessages)
+   {
+      nextMessage = 0;
+      return false;
+   }
+   nextMessage++;
+
+   back.inView = sentence.satellitesInView < 0xff ? sentence.satellitesInView : 0xff;
+   back.entries = back.inView < GPS_DECODER_MAX_SATELLITES ? back.inView : GPS_DECODER_MAX_SATELLITES;
+
+   for (uint8_t i = 0; i < 4; i++)
+   {
+      uint32_t index = (sentence.messageNumber - 1) * 4 + i;
+      if (index >= GPS_DECODER_MAX_SATELLITES) break;
+
+      back.ids[index] = sentence.isValid(4+4*i) ? sentence.satellites[i].id : 0;
+      back.elevations[index] = sentence.isValid(5+4*i) ? sentence.satellites[i].elevation : 0;
+      back.azimuths[index] = sentence.isValid(6+4*i) ? sentence.satellites[i].azimuth : 0;
+      back.snrs[index] = sentence.isValid(7+4*i) ? sentence.satellites[i].snr : 0;
+   }
+
+   // Sky view is complete, flip it to the front
+   if (sentence.messageNumber == totalMessages)
+   {
+      front ^= 1;
+      nextMessage = 0;
+      skyViewsCompleted++;
+      commit();
+      return true;
+   }
+
+   return false;
+}
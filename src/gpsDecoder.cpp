@@ -17,27 +17,53 @@
 // ******************************************************************
 // Includes
 // ******************************************************************
-#include "GpsDecoder.h"
+#include "gpsDecoder.h"
 #include <string.h>
-#include <ctype.h>
-#include <stdlib.h>
 #include <math.h>
 
+#if defined(__AVX2__) || defined(__SSE2__)
+  #include <immintrin.h>
+#elif defined(__ARM_NEON)
+  #include <arm_neon.h>
+#endif
+
+
+// ******************************************************************
+// Constants
+// ******************************************************************
+static const char *cardinalDirections[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE", "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
+
+// atan(2^-i) as binary angle with 16 additional fractional bits, 2^48 = 360 deg
+static const int64_t cordicAtan[GPS_DECODER_CORDIC_ITERATIONS] =
+{
+  35184372088832LL, 20770547670515LL, 10974586953444LL, 5570871696862LL, 2796246208089LL, 1399486241028LL,
+  699913886760LL, 349978300884LL, 174991820497LL, 87496244017LL, 43748163730LL, 21874087080LL,
+  10937044192LL, 5468522177LL, 2734261099LL, 1367130551LL, 683565276LL, 341782638LL,
+  170891319LL, 85445659LL, 42722830LL, 21361415LL, 10680707LL, 5340354LL,
+  2670177LL, 1335088LL, 667544LL, 333772LL, 166886LL, 83443LL
+};
+
 
 // ******************************************************************
 // Constructor
 // ******************************************************************
 GpsDecoderClass::GpsDecoderClass()
 {
-  // Init current frame with 0s
-  memset(&currentFrame[0],0,sizeof(currentFrame));
-
   decodedCharCount = 0;        // Endless increasing number of encoded chars
   sentencesWithFixCount = 0;   // Endless increasing number of fixed sentences
   failedChecksumCount = 0;     // Endless increasing number of failed checksum messages
   passedChecksumCount = 0;     // Endless increasing number of passed checksum messages
+  skippedSentenceCount = 0;    // Endless increasing number of filtered sentences
 
-  waitForFrameStart = false;   // Reset wait for frame start
+  // No event handlers
+  onGGA(NULL);
+  onRMC(NULL);
+  onLocation(NULL);
+  onChecksumFailure(NULL);
+  onSkyView(NULL);
+
+  // Enable all sentences and talkers, which are enabled at compile time
+  setSentenceFilter(GPS_DECODER_SENTENCE_ALL, GPS_DECODER_TALKER_ALL);
 }
 
 // ******************************************************************
@@ -50,757 +76,748 @@ bool GpsDecoderClass::decode(char currentChar)
   // Count up encoded char count
   decodedCharCount++;
 
-  // Try to get find a valid sentence in data stream
-  switch(currentChar)
-  {
-    // sentence begin
-    case '$':
-      // Reset decode state variables
-      calculatedChecksum = 0;
-      currentFrameOffset = 0;
-      memset(currentFrame,0,sizeof(currentFrame));
+  FrameEvent event = scanChar(frame, currentChar);
+  return event != FRAME_NONE && commitFrame(event, frame);
+}
 
-      // A new frame starts
-      waitForFrameStart = true;
-      blockReadChecksumInCalculation = false;
-    break;
 
+// Decode a whole buffer of received chars at once, behaves exactly like passing every char to decode(char)
+// Returns the number of frames which passed the checksum test and have been decoded
+size_t GpsDecoderClass::decode(const char *buffer, size_t length)
+{
+  size_t decodedFrames = 0;
 
-    // * not in the checksum calculation
-    case '*':
-      // if no frame start has been detected earlier break immediately
-      if (!waitForFrameStart) break;
+  // Count up encoded char count
+  decodedCharCount += length;
 
-      // Block all other following bytes, there fore they are the checksum of the frame
-      blockReadChecksumInCalculation = true;
+  while (length > 0)
+  {
+    size_t used;
+    FrameEvent event = scanFrame(frame, buffer, length, used);
 
-    // ordinary characters, fill buffer
-    default:
-      // if no frame start has been detected earlier break immediately
-      if (!waitForFrameStart) break;
+    buffer += used;
+    length -= used;
+    if (event != FRAME_NONE && commitFrame(event, frame)) decodedFrames++;
+  }
 
-      // If a * has been received prior, this is probably the checksum of the frame, so don't use it here
-      if(!blockReadChecksumInCalculation)
-      {
-        // Xor current char into calculated checksum
-        calculatedChecksum ^= (uint8_t)currentChar;
-      }
+  return decodedFrames;
+}
 
-      // Try to save the current message type into variable, prevent overflow
-      if (currentFrameOffset < (sizeof(currentFrame) - 1))
-      {
-        // Save message type in variable for later
-        currentFrame[currentFrameOffset] = currentChar;
-        currentFrameOffset++;
-      }
-    break;
 
-    // Dont care about \r completely
-    case '\r':
-    break;
+// Parse a field into the current sentence and continue with the next field
+GpsDecoderClass::FrameEvent GpsDecoderClass::scanField(FrameStateClass &frame, const FieldClass &field) const
+{
+  parseField(frame.currentSentence, frame.currentFieldIndex, field);
+
+  frame.currentFieldOffset = 0;
+
+  // Sentence identifier is known now, skip the rest of the line if the sentence is filtered
+  if (frame.currentFieldIndex == 0 && !isSentenceEnabled(frame.currentSentence))
+  {
+    frame.waitForFrameStart = false;
+    frame.currentFieldIndex++;
+    return FRAME_SKIPPED;
+  }
 
-    // last line
-    case '\n':
-      // if no frame start has been detected earlier break immediately
-      if (!waitForFrameStart) break;
+  // Stay on the last index for endless frames, it is ignored by all sentences
+  if (frame.currentFieldIndex < 0xff) frame.currentFieldIndex++;
+
+  return FRAME_NONE;
+}
 
-      // Frame now went through
-      waitForFrameStart = false;
 
-      // Close the frame with a 0 termination
-      currentFrame[currentFrameOffset] = 0;
+// Returns a view on chars of a field, too long fields are returned as empty field
+GpsDecoderClass::FieldClass GpsDecoderClass::fieldView(const char *chars, size_t count)
+{
+  FieldClass field;
 
-      // Check the complete sentence and return if its valid or not
-      // Example frame to parse "GPRMC,162614,A,5230.5900,N,01322.3900,E,10.0,90.0,131006,1.2,E,A*13"
-      return parseFrame();
-    break;
+  if (count <= GPS_DECODER_MAX_FIELD_SIZE)
+  {
+    field.str = chars;
+    field.len = count;
+  }
+  else
+  {
+    field.str = "";
+    field.len = 0;
   }
 
-  // Allways return false
-  return false;
+  return field;
 }
 
 
-// Process one received frame
+// Count and report a frame finished by the state machine, commit its sentence if the checksum passed
 // Returns true if new sentence has just passed checksum test and is validated
-bool GpsDecoderClass::parseFrame()
+bool GpsDecoderClass::commitFrame(FrameEvent event, const FrameStateClass &frame)
 {
-  // Calc checksum from frame, check if * is existend or not
-  char *checksumPos = strstr(currentFrame,"*");
-  if(!checksumPos)
+  switch (event)
   {
-    GPS_DECODER_LOG("GPS decoder: No * in frame: \"%s\" found\n", currentFrame);
-    return false;
-  }
-  uint8_t checksum = 16 * fromHex(*(++checksumPos)) + fromHex(*(++checksumPos));
+    case FRAME_SKIPPED:
+      skippedSentenceCount++;
+      return false;
 
-  // Check if checksum is valid
-  if (checksum != calculatedChecksum)
-  {
-    GPS_DECODER_LOG("GPS decoder: Invalid checksum! calc 0x%02x != read 0x%02x\n", calculatedChecksum,checksum);
+    case FRAME_NO_CHECKSUM:
+      GPS_DECODER_LOG("GPS decoder: No * in frame found\n");
+      return false;
+
+    // Both checksum chars are needed
+    case FRAME_INCOMPLETE_CHECKSUM:
+      GPS_DECODER_LOG("GPS decoder: Incomplete checksum in frame\n");
+
+      // Update failed checksum counter
+      failedChecksumCount++;
+      notify(checksumFailureHandler, checksumFailureContext);
+      return false;
+
+    case FRAME_INVALID_CHECKSUM:
+      GPS_DECODER_LOG("GPS decoder: Invalid checksum! calc 0x%02x != read 0x%02x\n", frame.calculatedChecksum,frame.receivedChecksum);
+
+      // Update failed checksum counter
+      failedChecksumCount++;
+      notify(checksumFailureHandler, checksumFailureContext);
+      return false;
 
-    // Update failed checksum counter
-    failedChecksumCount++;
-    return false;
+    case FRAME_PASSED:
+      GPS_DECODER_LOG("GPS decoder: Valid checksum\n");
+      // Update valid checksum
+      passedChecksumCount++;
+
+      return commitSentence(frame.currentSentence);
+
+    default:
+      return false;
   }
+}
 
-  GPS_DECODER_LOG("GPS decoder: Valid checksum\n");
-  // Update valid checksum
-  passedChecksumCount++;
 
-  // Cut off checksum now, makes parsing downwards easier
-  char *checksumCutOff = strstr(currentFrame,"*");
-  *checksumCutOff = 0;
+// Select the sentences and talkers which are decoded, all others are skipped right behind their identifier
+// Sentences and talkers disabled by GPS_DECODER_SENTENCE_MASK or GPS_DECODER_TALKER_MASK stay disabled
+void GpsDecoderClass::setSentenceFilter(uint16_t sentences, uint8_t talkers)
+{
+  sentenceFilter = sentences & GPS_DECODER_SENTENCE_MASK;
+  talkerFilter = talkers & GPS_DECODER_TALKER_MASK;
+}
 
-  // Check what type of frame has to be parsed
-  // GN = combination of all used satellite systems
-  
-  // Global Positioning System Fix Data. Time, Position and fix related data for a GPS receiver
-  if(!strncmp("GNGGA",currentFrame,5))
+
+// Copy the last committed value of every field, the updated flags stay untouched, so it can be used in handlers
+// valid has the GPS_DECODER_FIELD_xxx of all valid fields, sentences is 0. Unlike an epoch record the values
+// may come from different epochs, but there is no delay, in onLocation() it has the location just committed
+void GpsDecoderClass::currentFix(FixRecord &record) const
+{
+  memset(&record, 0, sizeof(record));
+
+  if(location.valid)
   {
-    GPS_DECODER_LOG("GPS decoder: Found GGA frame: \"%s\"\n", currentFrame);
-    return parseFrameGGA(currentFrame);
+    record.latE7 = location.rawLatData.toE7();
+    record.lngE7 = location.rawLngData.toE7();
+    record.valid |= GPS_DECODER_FIELD_LOCATION;
   }
-  // Recommended Minimum Navigation Information
-  else if(!strncmp("GNRMC",currentFrame,5))
+  if(date.valid)
   {
-    GPS_DECODER_LOG("GPS decoder: Found RMC frame: \"%s\"\n", currentFrame);
-    return parseFrameRMC(currentFrame);
+    record.date = date.date;
+    record.valid |= GPS_DECODER_FIELD_DATE;
   }
-  // DOP and active satellites
-  else if(!strncmp("GNGSA",currentFrame,5))
+  if(time.valid)
   {
-    GPS_DECODER_LOG("GPS decoder: Found GSA frame: \"%s\"\n", currentFrame);
-    return parseFrameGSA(currentFrame);
+    record.time = time.time;
+    record.valid |= GPS_DECODER_FIELD_TIME;
   }
-  // Satellites in view
-  else if(!strncmp("GLGSV",currentFrame,5) || !strncmp("GPGSV",currentFrame,5) || !strncmp("BDGSV",currentFrame,5))
+  if(speed.valid)
   {
-    GPS_DECODER_LOG("GPS decoder: Found GSV frame: \"%s\"\n", currentFrame);
-    return parseFrameGSV(currentFrame);
+    record.speed = speed.val;
+    record.valid |= GPS_DECODER_FIELD_SPEED;
   }
-  // Track Made Good and Ground Speed
-  else if(!strncmp("GNVTG",currentFrame,5))
+  if(course.valid)
   {
-    GPS_DECODER_LOG("GPS decoder: Found VTG frame: \"%s\"\n", currentFrame);
-    return parseFrameVTG(currentFrame);
+    record.course = course.val;
+    record.valid |= GPS_DECODER_FIELD_COURSE;
   }
-  else
+  if(altitude.valid)
+  {
+    record.altitude = altitude.val;
+    record.valid |= GPS_DECODER_FIELD_ALTITUDE;
+  }
+  if(hdop.valid && vdop.valid && pdop.valid)
+  {
+    record.hdop = hdop.val;
+    record.vdop = vdop.val;
+    record.pdop = pdop.val;
+    record.valid |= GPS_DECODER_FIELD_DOP;
+  }
+  if(fixedType.valid)
+  {
+    record.fixedType = (uint8_t)fixedType.val;
+    record.valid |= GPS_DECODER_FIELD_FIXED_TYPE;
+  }
+  if(satellites.gps.valid || satellites.glonass.valid || satellites.baidu.valid)
   {
-    GPS_DECODER_LOG("GPS decoder: Could not decode frame: \"%s\"\n", currentFrame);
-    return false;
+    uint16_t used = satellites.gps.activeCount() + satellites.glonass.activeCount() + satellites.baidu.activeCount();
+    uint16_t inView = satellites.gps.satellitesInView() + satellites.glonass.satellitesInView() + satellites.baidu.satellitesInView();
+    record.satellitesUsed = used < 0xff ? used : 0xff;
+    record.satellitesInView = inView < 0xff ? inView : 0xff;
+    record.valid |= GPS_DECODER_FIELD_SATELLITES;
   }
+}
 
-  // In any case return false
-  return false;
+
+// Register the event handlers, context is passed on to the handler, a NULL handler unregisters
+// Handlers are called from decode(), right behind the commit of the sub classes
+void GpsDecoderClass::onGGA(EventHandler handler, void *context)
+{
+  ggaHandler = handler;
+  ggaContext = context;
 }
 
-// Recommended Minimum Navigation Information
-bool GpsDecoderClass::parseFrameRMC(char *frame)
+void GpsDecoderClass::onRMC(EventHandler handler, void *context)
+{
+  rmcHandler = handler;
+  rmcContext = context;
+}
+
+void GpsDecoderClass::onLocation(EventHandler handler, void *context)
+{
+  locationHandler = handler;
+  locationContext = context;
+}
+
+void GpsDecoderClass::onChecksumFailure(EventHandler handler, void *context)
+{
+  checksumFailureHandler = handler;
+  checksumFailureContext = context;
+}
+
+void GpsDecoderClass::onSkyView(EventHandler handler, void *context)
+{
+  skyViewHandler = handler;
+  skyViewContext = context;
+}
+
+void GpsDecoderClass::onEpoch(EpochHandler handler, void *context)
+{
+  epoch.handler = handler;
+  epoch.handlerContext = context;
+}
+
+
+// Check the identifier of a sentence against the sentence filter
+bool GpsDecoderClass::isSentenceEnabled(const SentenceClass &sentence) const
+{
+  return (sentenceFilter & sentenceFilterBit(sentence.type)) && (talkerFilter & talkerFilterBit(sentence.talker));
+}
+
+
+// Returns the GPS_DECODER_SENTENCE_xxx bit of a packed sentence type
+uint16_t GpsDecoderClass::sentenceFilterBit(uint32_t type)
 {
-  char frameLocal[200] = {0};
+  switch(type)
+  {
+    case sentenceCode('G','G','A'): return GPS_DECODER_SENTENCE_GGA;
+    case sentenceCode('R','M','C'): return GPS_DECODER_SENTENCE_RMC;
+    case sentenceCode('G','S','A'): return GPS_DECODER_SENTENCE_GSA;
+    case sentenceCode('G','S','V'): return GPS_DECODER_SENTENCE_GSV;
+    case sentenceCode('V','T','G'): return GPS_DECODER_SENTENCE_VTG;
+    default:                        return GPS_DECODER_SENTENCE_OTHER;
+  }
+}
 
-  char identifierRaw[10] = {0};
-  char utcTimeRaw[15] = {0};
-  char statusRaw = 0;
-  char latitudeRaw[15] = {0};
-  char latitudeDirectionRaw = 0;
-  char longitudeRaw[15] = {0};
-  char longitudeDirectionRaw = 0;
-  double speedOverGroundKnotsRaw = 0;
-  double trackMadeGood = 0;
-  char dateRaw[15] = {0};
-  double magenticVariationDegreesRaw = 0;
-  char magenticVariationDegreesStatusRaw = 0;
 
-  // Save frame local, because we modify it
-  strncpy(frameLocal,frame,sizeof(frameLocal)-1);
+// Returns the GPS_DECODER_TALKER_xxx bit of a packed talker
+uint8_t GpsDecoderClass::talkerFilterBit(uint16_t talker)
+{
+  switch(talker)
+  {
+    case talkerCode('G','P'): return GPS_DECODER_TALKER_GP;
+    case talkerCode('G','L'): return GPS_DECODER_TALKER_GL;
+    case talkerCode('G','A'): return GPS_DECODER_TALKER_GA;
+    case talkerCode('B','D'):
+    case talkerCode('G','B'): return GPS_DECODER_TALKER_GB;
+    case talkerCode('G','N'): return GPS_DECODER_TALKER_GN;
+    default:                  return GPS_DECODER_TALKER_OTHER;
+  }
+}
 
-  // Jump to first fragment in frame
-  char *fragment = strsep(&frame, ",");
 
-  // Loop through all fragments in frame
-  for(uint8_t i=0;i<12;i++)
+// Parse one field of a sentence into its staged values
+// Field 0 is the sentence identifier, a two char talker followed by a three char sentence type "GPRMC"
+void GpsDecoderClass::parseField(SentenceClass &sentence, uint8_t index, const FieldClass &field)
+{
+  if (index == 0)
   {
-    switch (i)
+    if (field.len == 5)
     {
-      case 0:
-        strncpy(identifierRaw,fragment,sizeof(identifierRaw)-1);
-        break;
+      sentence.talker = talkerCode(field.str[0], field.str[1]);
+      sentence.type = sentenceCode(field.str[2], field.str[3], field.str[4]);
+    }
+    return;
+  }
+
+  // Talker can be anything
+  // GN = combination of all used satellite systems, GP = GPS, GL = GLONASS, GA = Galileo, GB/BD = Baidu
+  switch(sentence.type)
+  {
+    case sentenceCode('G','G','A'):
+      parseFieldGGA(sentence, index, field);
+      break;
+
+    case sentenceCode('R','M','C'):
+      parseFieldRMC(sentence, index, field);
+      break;
 
-      case 1:
-        strncpy(utcTimeRaw,fragment,sizeof(utcTimeRaw)-1);
-        break;
+    case sentenceCode('G','S','A'):
+      parseFieldGSA(sentence, index, field);
+      break;
 
-      case 2:
-        statusRaw = *fragment;
-        break;
+    case sentenceCode('G','S','V'):
+      parseFieldGSV(sentence, index, field);
+      break;
 
-      case 3:
-        strncpy(latitudeRaw,fragment,sizeof(latitudeRaw)-1);
-        break;
+    case sentenceCode('V','T','G'):
+      parseFieldVTG(sentence, index, field);
+      break;
 
-      case 4:
-        latitudeDirectionRaw = *fragment;
-        break;
+    // Unknown sentences are only checksummed
+    default:
+      break;
+  }
+}
 
-      case 5:
-        strncpy(longitudeRaw,fragment,sizeof(longitudeRaw)-1);
-        break;
 
-      case 6:
-        longitudeDirectionRaw = *fragment;
-        break;
+// Commit the staged values of a sentence, which passed the checksum test
+// Returns true if the sentence type is known
+bool GpsDecoderClass::commitSentence(const SentenceClass &sentence)
+{
+  bool committed;
 
-      case 7:
-        speedOverGroundKnotsRaw = atof(fragment);
-        break;
+  // The sentence may already belong to the next epoch
+  epoch.begin(sentence);
 
-      case 8:
-        trackMadeGood = atof(fragment);
-        break;
+  // Check what type of frame has been parsed
+  switch(sentence.type)
+  {
+    // Global Positioning System Fix Data. Time, Position and fix related data for a GPS receiver
+    case sentenceCode('G','G','A'):
+      GPS_DECODER_LOG("GPS decoder: Found GGA frame\n");
+      committed = commitGGA(sentence);
+      notify(ggaHandler, ggaContext);
+      break;
 
-      case 9:
-        strncpy(dateRaw,fragment,sizeof(dateRaw)-1);
-        break;
+    // Recommended Minimum Navigation Information
+    case sentenceCode('R','M','C'):
+      GPS_DECODER_LOG("GPS decoder: Found RMC frame\n");
+      committed = commitRMC(sentence);
+      notify(rmcHandler, rmcContext);
+      break;
 
-      case 10:
-        magenticVariationDegreesRaw = atof(fragment);
-        break;
+    // DOP and active satellites
+    case sentenceCode('G','S','A'):
+      GPS_DECODER_LOG("GPS decoder: Found GSA frame\n");
+      committed = commitGSA(sentence);
+      break;
 
-      case 11:
-        magenticVariationDegreesStatusRaw = *fragment;
-        continue;
+    // Satellites in view
+    case sentenceCode('G','S','V'):
+      GPS_DECODER_LOG("GPS decoder: Found GSV frame\n");
+      committed = commitGSV(sentence);
+      break;
 
-      // something bad happened
-      default:
-        return false;
-    }
+    // Track Made Good and Ground Speed
+    case sentenceCode('V','T','G'):
+      GPS_DECODER_LOG("GPS decoder: Found VTG frame\n");
+      committed = commitVTG(sentence);
+      break;
+
+    default:
+      GPS_DECODER_LOG("GPS decoder: Could not decode frame\n");
+      committed = false;
+      break;
+  }
+
+  // Every sentence is part of an epoch, also not decoded ones can end it
+  epoch.add(sentence, satellites);
+
+  return committed;
+}
+
+
+// Returns the satellite system for a NMEA 4.1 system id or NULL if it is not tracked
+GpsDecoderClass::SatelliteSystemClass *GpsDecoderClass::satelliteSystemById(uint32_t systemId)
+{
+  switch (systemId)
+  {
+    case 1: // GPS
+      return &satellites.gps;
+
+    case 2: // GLONASS
+      return &satellites.glonass;
+
+    case 4: // Baidu
+      return &satellites.baidu;
+
+    default:
+      return NULL;
+  }
+}
+
+
+// Returns the satellite system for a talker or NULL if it is not tracked
+GpsDecoderClass::SatelliteSystemClass *GpsDecoderClass::satelliteSystemByTalker(uint16_t talker)
+{
+  switch (talker)
+  {
+    case talkerCode('G','P'):
+      return &satellites.gps;
+
+    case talkerCode('G','L'):
+      return &satellites.glonass;
+
+    case talkerCode('B','D'):
+    case talkerCode('G','B'):
+      return &satellites.baidu;
+
+    default:
+      return NULL;
+  }
+}
+
+
+// Recommended Minimum Navigation Information
+// GNRMC,utcTime,status,latitude,N/S,longitude,E/W,speedKnots,trackMadeGood,date,magneticVariation,E/W,mode
+void GpsDecoderClass::parseFieldRMC(SentenceClass &sentence, uint8_t index, const FieldClass &field)
+{
+  switch (index)
+  {
+    case 1:
+      sentence.setValid(index, field.toTime(sentence.time));
+      break;
+
+    case 2:
+      sentence.status = field.first();
+      break;
+
+    case 3:
+      sentence.setValid(index, field.toDegrees(sentence.latitude, 90));
+      break;
+
+    case 4:
+      sentence.latitude.negative = field.first() == 'S';
+      break;
+
+    case 5:
+      sentence.setValid(index, field.toDegrees(sentence.longitude, 180));
+      break;
+
+    case 6:
+      sentence.longitude.negative = field.first() == 'W';
+      break;
+
+    case 7:
+      sentence.setValid(index, field.toFixed(2, sentence.speed));
+      break;
+
+    case 9:
+      sentence.setValid(index, field.toDate(sentence.date));
+      break;
 
-    fragment = strsep(&frame, ",");
+    default:
+      break;
   }
+}
 
+bool GpsDecoderClass::commitRMC(const SentenceClass &sentence)
+{
   // Update timestamp
-  if(strlen(utcTimeRaw)>0)
+  if(sentence.isValid(1))
   {
-    time.setTime(utcTimeRaw);
+    time.setTime(sentence.time);
     time.commit();
   }
   
   // Update Latitude if valid
-  if(statusRaw == 'A')
+  bool located = sentence.status == 'A' && sentence.isValid(3) && sentence.isValid(5);
+  if(located)
   {
-    location.setLatitude(latitudeRaw);
-    location.setLongitude(longitudeRaw);
+    location.setLatitude(sentence.latitude);
+    location.setLongitude(sentence.longitude);
     location.commit();
   }
 
   // Update speed
-  speed.set(speedOverGroundKnotsRaw);
-  speed.commit();
+  if(sentence.isValid(7))
+  {
+    speed.set(sentence.speed);
+    speed.commit();
+  }
 
   // Update date
-  if(strlen(dateRaw)>0)
+  if(sentence.isValid(9))
   {
-    date.setDate(dateRaw);
+    date.setDate(sentence.date);
     date.commit();
   }
 
+  // The handler sees all fields of the sentence
+  if(located) notify(locationHandler, locationContext);
+
   return true;
 }
 
 // Global Positioning System Fix Data. Time, Position and fix related data for a GPS receiver
-bool GpsDecoderClass::parseFrameGGA(char *frame)
-{
-  char frameLocal[200] = {0};
-
-  char identifierRaw[10] = {0};
-  char utcTimeRaw[15] = {0};
-  char latitudeRaw[15] = {0};
-  char latitudeDirectionRaw = 0;
-  char longitudeRaw[15] = {0};
-  char longitudeDirectionRaw = 0;
-  uint8_t qualityIndicator = 0;
-  uint8_t numberOfSatellitesInView = 0;
-  float horizontalDilutionOfPrecision = 0.0;
-  float antennaAltitudeBasedOnSeaLevel = 0.0;
-  float geodialSeparation = 0.0;
-  float ageOfDifeferentialGpsData = 0.0;
-  uint16_t differentialReferenceStationId = 0;
-
-  // Save frame local, because we modify it
-  strncpy(frameLocal,frame,sizeof(frameLocal)-1);
-
-  // Jump to first fragment in frame
-  char *fragment = strsep(&frame, ",");
-
-  // Loop through all fragments in frame
-  for(uint8_t i=0;i<15;i++)
-  {
-    switch (i)
-    {
-      case 0:
-        strncpy(identifierRaw,fragment,sizeof(identifierRaw)-1);
-        break;
-
-      case 1:
-        strncpy(utcTimeRaw,fragment,sizeof(utcTimeRaw)-1);
-        break;
-
-      case 2:
-        strncpy(latitudeRaw,fragment,sizeof(latitudeRaw)-1);
-        break;
-
-      case 3:
-        latitudeDirectionRaw = *fragment;
-        break;
-
-      case 4:
-        strncpy(longitudeRaw,fragment,sizeof(longitudeRaw)-1);
-        break;
-
-      case 5:
-        longitudeDirectionRaw = *fragment;
-        break;
-
-      case 6:
-        qualityIndicator = atoi(fragment);
-        break;
-
-      case 7:
-        numberOfSatellitesInView = atoi(fragment);
-        break;
-
-      case 8:
-        horizontalDilutionOfPrecision = atof(fragment);
-        break;
-
-      case 9:
-        antennaAltitudeBasedOnSeaLevel = atof(fragment);
-        break;
-
-      case 10:
-        break;
+// GNGGA,utcTime,latitude,N/S,longitude,E/W,quality,satellitesUsed,hdop,altitude,M,geoidSeparation,M,ageOfDifferentialData,referenceStationId
+void GpsDecoderClass::parseFieldGGA(SentenceClass &sentence, uint8_t index, const FieldClass &field)
+{
+  switch (index)
+  {
+    case 1:
+      sentence.setValid(index, field.toTime(sentence.time));
+      break;
 
-      case 11:
-        geodialSeparation = atof(fragment);
-        break;
+    case 2:
+      sentence.setValid(index, field.toDegrees(sentence.latitude, 90));
+      break;
 
-      case 12:
-        break;
+    case 3:
+      sentence.latitude.negative = field.first() == 'S';
+      break;
 
-      case 13:
-        ageOfDifeferentialGpsData = atof(fragment);
-        break;
+    case 4:
+      sentence.setValid(index, field.toDegrees(sentence.longitude, 180));
+      break;
 
-      case 14:
-        differentialReferenceStationId = atoi(fragment);
-        // Skip last strsep
-        continue;
+    case 5:
+      sentence.longitude.negative = field.first() == 'W';
+      break;
 
-      // something bad happened
-      default:
-        return false;
-    }
+    case 9:
+      sentence.setValid(index, field.toFixed(2, sentence.altitude));
+      break;
 
-    fragment = strsep(&frame, ",");
+    default:
+      break;
   }
+}
 
+bool GpsDecoderClass::commitGGA(const SentenceClass &sentence)
+{
   // Update time and commit it
-  if(strlen(utcTimeRaw)>0)
+  if(sentence.isValid(1))
   {
-    time.setTime(utcTimeRaw);
+    time.setTime(sentence.time);
     time.commit();
   }
   
   // Update position and commit
-  if(strlen(latitudeRaw)>0 && strlen(longitudeRaw)>0)
+  bool located = sentence.isValid(2) && sentence.isValid(4);
+  if(located)
   {
-    location.setLatitude(latitudeRaw);
-    location.setLongitude(longitudeRaw);
+    location.setLatitude(sentence.latitude);
+    location.setLongitude(sentence.longitude);
     location.commit();
   }
 
   // Set altitude
-  altitude.set((int32_t)round(antennaAltitudeBasedOnSeaLevel));
-  altitude.commit();
+  if(sentence.isValid(9))
+  {
+    altitude.set(sentence.altitude);
+    altitude.commit();
+  }
+
+  // The handler sees all fields of the sentence
+  if(located) notify(locationHandler, locationContext);
 
   return true;
 }
 
 // GPS DOP and active satellites
-bool GpsDecoderClass::parseFrameGSA(char *frame)
+// GNGSA,selectionMode,fixType,12x activeSatelliteId,pdop,hdop,vdop,systemId
+// https://receiverhelp.trimble.com/alloy-gnss/en-us/NMEA-0183messages_GSA.html
+void GpsDecoderClass::parseFieldGSA(SentenceClass &sentence, uint8_t index, const FieldClass &field)
 {
-  // https://receiverhelp.trimble.com/alloy-gnss/en-us/NMEA-0183messages_GSA.html
-  char frameLocal[200] = {0};
-
-  char identifierRaw[10] = {0};
-  char selectionMode = 0;             // M = manual, A = Automatic
-  uint8_t fixedTypeLocal = 0;         // 1= not available, 2 = 2D, 3 = 3D fix
-  uint8_t activeSatellites[12] = {0};
-  double pdopLocal = 0;
-  double hdopLocal = 0;
-  double vdopLocal = 0;
-  int8_t systemId = -1;               // 1=GPS, 2=GLONASS, 3=Galileo, 4=Baidu, 0=QZZ
-
-  // Save frame local, because we modify it
-  strncpy(frameLocal,frame,sizeof(frameLocal)-1);
+  uint32_t id;
 
-  // Jump to first fragment in frame
-  char *fragment = strsep(&frame, ",");
-
-  // Loop through all fragments in frame
-  for(uint8_t i=0;i<19;i++)
+  switch (index)
   {
-    switch (i)
-    {
-      case 0:
-        strncpy(identifierRaw,fragment,sizeof(identifierRaw)-1);
-        break;
-
-      case 1:
-        selectionMode = *fragment;
-        break;
-
-      case 2:
-        fixedTypeLocal = atoi(fragment);
-        break;
-
-      case 3:
-      case 4:
-      case 5:  
-      case 6:  
-      case 7:  
-      case 8:  
-      case 9:  
-      case 10:  
-      case 11:  
-      case 12:  
-      case 13:  
-      case 14:  
-        activeSatellites[i-3] = atoi(fragment);
-        break;
-
-      case 15:
-        pdopLocal = atof(fragment);
-        break;
-
-      case 16:
-        hdopLocal = atof(fragment);
-        break;
-
-      case 17:
-        vdopLocal = atof(fragment);
-        break;
-
-      case 18:
-        if(fragment == NULL){continue;}   // If no data stop here
-        systemId = atof(fragment);
-        continue;
-
-      // something bad happened
-      default:
-        return false;
-    }
-
-    fragment = strsep(&frame, ",");
-  }
-
-
-  // Update hdop
-  hdop.set(hdopLocal);
-  hdop.commit();
+    case 2:
+      sentence.setValid(index, field.toUnsigned(sentence.fixedType));
+      break;
 
-  // Update vdop
-  vdop.set(vdopLocal);
-  vdop.commit();
-  
-  // Update pdop
-  pdop.set(pdopLocal);
-  pdop.commit();
+    case 3:
+    case 4:
+    case 5:
+    case 6:
+    case 7:
+    case 8:
+    case 9:
+    case 10:
+    case 11:
+    case 12:
+    case 13:
+    case 14:
+      // Empty ids are set to 0
+      field.toUnsigned(id);
+      sentence.activeSatelliteIds[index-3] = id;
+      sentence.setValid(index, true);
+      break;
 
-  // Update fixed type
-  fixedType.set(fixedTypeLocal);
-  fixedType.commit();
+    case 15:
+      sentence.setValid(index, field.toFixed(2, sentence.pdop));
+      break;
 
-  // Update active satellites list
-  switch (systemId)
-  {
-    case 1: // GPS
-      for (uint8_t i = 0; i < 12; i++)
-      {
-        satellites.gps.listOfActiveSatelliteIds[i].set(activeSatellites[i]);
-        satellites.gps.listOfActiveSatelliteIds[i].commit();
-      }
+    case 16:
+      sentence.setValid(index, field.toFixed(2, sentence.hdop));
       break;
 
-    case 2: // GLONASS
-      for (uint8_t i = 0; i < 12; i++)
-      {
-        satellites.glonass.listOfActiveSatelliteIds[i].set(activeSatellites[i]);
-        satellites.glonass.listOfActiveSatelliteIds[i].commit();
-      }
+    case 17:
+      sentence.setValid(index, field.toFixed(2, sentence.vdop));
       break;
 
-    case 4: // Baidu
-      for (uint8_t i = 0; i < 12; i++)
-      {
-        satellites.baidu.listOfActiveSatelliteIds[i].set(activeSatellites[i]);
-        satellites.baidu.listOfActiveSatelliteIds[i].commit();
-      }
+    case 18:
+      sentence.setValid(index, field.toUnsigned(sentence.systemId));
       break;
-    
+
     default:
       break;
   }
-  
-  return true;
 }
 
-// Satellites in view
-bool GpsDecoderClass::parseFrameGSV(char *frame)
+bool GpsDecoderClass::commitGSA(const SentenceClass &sentence)
 {
-  char frameLocal[200] = {0};
-
-  char identifierRaw[10] = {0};
-  uint8_t totalNumberOfMessages = 0;
-  uint8_t messageNumber = 0;            // Seems that maximum 4 sats are in one message, so we use this as static offset
-  uint8_t satellitesInView = 0;
-  uint8_t satelliteNumber[4] = {0};
-  uint8_t satelliteElevation[4] = {0};
-  uint16_t satelliteAzimuth[4] = {0};
-  uint8_t satelliteSnr[4] = {0};
-
-  // Save frame local, because we modify it
-  strncpy(frameLocal,frame,sizeof(frameLocal)-1);
-
-  // Jump to first fragment in frame
-  char *fragment = strsep(&frame, ",");
-
-  // Loop through all fragments in frame
-  for(uint8_t i=0;i<20;i++)
+  // Update hdop
+  if(sentence.isValid(16))
   {
-    switch (i)
-    {
-      case 0:
-        strncpy(identifierRaw,fragment,sizeof(identifierRaw)-1);
-        break;
-
-      case 1:
-        totalNumberOfMessages = atoi(fragment);
-        break;
-
-      case 2:
-        messageNumber = atoi(fragment);
-        break;
-
-      case 3:
-        satellitesInView = atoi(fragment);
-        break;
-
-      case 4:
-        if(fragment==NULL){continue;} // If no satellite data continue here
-        satelliteNumber[0] = atoi(fragment);
-        break;
-      case 5:
-        satelliteElevation[0] = atoi(fragment);
-        break;  
-      case 6:
-        satelliteAzimuth[0] = atoi(fragment);
-        break; 
-      case 7:
-        satelliteSnr[0] = atoi(fragment);
-        break;
-
-      case 8:
-        if(fragment==NULL){continue;} // If no satellite data continue here
-        satelliteNumber[1] = atoi(fragment);
-        break;
-      case 9:
-        satelliteElevation[1] = atoi(fragment);
-        break;  
-      case 10:
-        satelliteAzimuth[1] = atoi(fragment);
-        break; 
-      case 11:
-        satelliteSnr[1] = atoi(fragment);
-        break;
-
-      case 12:
-        if(fragment==NULL){continue;} // If no satellite data continue here
-        satelliteNumber[2] = atoi(fragment);
-        break;
-      case 13:
-        satelliteElevation[2] = atoi(fragment);
-        break;  
-      case 14:
-        satelliteAzimuth[2] = atoi(fragment);
-        break; 
-      case 15:
-        satelliteSnr[2] = atoi(fragment);
-        break;
-
-      case 16:
-        if(fragment==NULL){continue;} // If no satellite data continue here
-        satelliteNumber[3] = atoi(fragment);
-        break;
-      case 17:
-        satelliteElevation[3] = atoi(fragment);
-        break;  
-      case 18:
-        satelliteAzimuth[3] = atoi(fragment);
-        break; 
-      case 19:
-        satelliteSnr[3] = atoi(fragment);
-        continue;
-
-      // something bad happened
-      default:
-        return false;
-    }
-
-    fragment = strsep(&frame, ",");
+    hdop.set(sentence.hdop);
+    hdop.commit();
   }
 
-  // Update glonass satellites infos
-  if(!strncmp("GLGSV",currentFrame,5))
+  // Update vdop
+  if(sentence.isValid(17))
   {
-    // Update satellites in view
-    satellites.glonass.numberSatellitesInView.set(satellitesInView);
-    satellites.glonass.numberSatellitesInView.commit();
-
-    // Update satellites infos
-    for (uint8_t i = 0; i < 4; i++)
-    {
-      // Calculate position in array based on total sats in view divided by 4
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].id.set(satelliteNumber[i]);
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].id.commit();
-
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].azimuth.set(satelliteAzimuth[i]);
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].azimuth.commit();
-
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].elevation.set(satelliteElevation[i]);
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].elevation.commit();
-
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].snr.set(satelliteSnr[i]);
-      satellites.glonass.listOfSatellitesInView[(messageNumber-1)*4+i].snr.commit();
-    }
+    vdop.set(sentence.vdop);
+    vdop.commit();
   }
-  // Update gps satellites infos
-  else if(!strncmp("GPGSV",currentFrame,5))
+  
+  // Update pdop
+  if(sentence.isValid(15))
   {
-    // Update satellites in view
-    satellites.gps.numberSatellitesInView.set(satellitesInView);
-    satellites.gps.numberSatellitesInView.commit();
-
-    // Update satellites infos
-    for (uint8_t i = 0; i < 4; i++)
-    {
-      // Calculate position in array based on total sats in view divided by 4
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].id.set(satelliteNumber[i]);
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].id.commit();
-
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].azimuth.set(satelliteAzimuth[i]);
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].azimuth.commit();
+    pdop.set(sentence.pdop);
+    pdop.commit();
+  }
 
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].elevation.set(satelliteElevation[i]);
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].elevation.commit();
+  // Update fixed type, 1= not available, 2 = 2D, 3 = 3D fix
+  if(sentence.isValid(2))
+  {
+    fixedType.set(sentence.fixedType);
+    fixedType.commit();
+  }
 
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].snr.set(satelliteSnr[i]);
-      satellites.gps.listOfSatellitesInView[(messageNumber-1)*4+i].snr.commit();
-    }
+  // System id is only available since NMEA 4.1, older receivers send one GSA per talker
+  SatelliteSystemClass *system;
+  if(sentence.isValid(18))
+  {
+    system = satelliteSystemById(sentence.systemId);
   }
-  // Update baidu satellites infos
-  else if(!strncmp("BDGSV",currentFrame,5))
+  else
   {
-    // Update satellites in view
-    satellites.baidu.numberSatellitesInView.set(satellitesInView);
-    satellites.baidu.numberSatellitesInView.commit();
+    system = satelliteSystemByTalker(sentence.talker);
+  }
 
-    // Update satellites infos
-    for (uint8_t i = 0; i < 4; i++)
-    {
-      // Calculate position in array based on total sats in view divided by 4
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].id.set(satelliteNumber[i]);
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].id.commit();
-
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].azimuth.set(satelliteAzimuth[i]);
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].azimuth.commit();
-
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].elevation.set(satelliteElevation[i]);
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].elevation.commit();
-
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].snr.set(satelliteSnr[i]);
-      satellites.baidu.listOfSatellitesInView[(messageNumber-1)*4+i].snr.commit();
-    }
+  // Update active satellites, unknown systems and GN without system id are skipped
+  if(system)
+  {
+    system->commitGSA(sentence);
   }
-  
+
   return true;
 }
 
 // Satellites in view
-bool GpsDecoderClass::parseFrameVTG(char *frame)
+// GPGSV,totalNumberOfMessages,messageNumber,satellitesInView,4x (id,elevation,azimuth,snr),signalId
+void GpsDecoderClass::parseFieldGSV(SentenceClass &sentence, uint8_t index, const FieldClass &field)
 {
-  char frameLocal[200] = {0};
+  uint32_t value;
 
-  char identifierRaw[10] = {0};
-  char valid = 0;
-  double trackDegrees = 0;
-  double speedKnots = 0;
+  switch (index)
+  {
+    case 1:
+      sentence.setValid(index, field.toUnsigned(sentence.totalMessages));
+      break;
 
-  // Save frame local, because we modify it
-  strncpy(frameLocal,frame,sizeof(frameLocal)-1);
+    case 2:
+      sentence.setValid(index, field.toUnsigned(sentence.messageNumber));
+      break;
 
-  // Jump to first fragment in frame
-  char *fragment = strsep(&frame, ",");
+    case 3:
+      sentence.setValid(index, field.toUnsigned(sentence.satellitesInView));
+      break;
 
-  // Loop through all fragments in frame
-  for(uint8_t i=0;i<9;i++)
+    default:
+      if (index < 4 || index > 19) break;
+
+      // Satellite entries, empty values are set to 0
+      field.toUnsigned(value);
+      switch ((index - 4) % 4)
+      {
+        case 0: sentence.satellites[(index - 4) / 4].id = value; break;
+        case 1: sentence.satellites[(index - 4) / 4].elevation = value; break;
+        case 2: sentence.satellites[(index - 4) / 4].azimuth = value; break;
+        case 3: sentence.satellites[(index - 4) / 4].snr = value; break;
+      }
+      sentence.setValid(index, true);
+      break;
+  }
+}
+
+bool GpsDecoderClass::commitGSV(const SentenceClass &sentence)
+{
+  // Number of messages, message number and satellites in view are needed to assemble the sky view
+  if(!sentence.isValid(1) || !sentence.isValid(2) || !sentence.isValid(3))
   {
-    switch (i)
-    {
-      case 0:
-        strncpy(identifierRaw,fragment,sizeof(identifierRaw)-1);
-        break;
-
-      case 1:
-        trackDegrees = atof(fragment);
-        break;
-
-      case 2:
-        valid = *fragment;
-      case 3:
-      case 4:
-        break;
-      
-      case 5:
-        speedKnots = atof(fragment);
-        break;
-      
-      case 6:
-      case 7:
-        break;
-
-      case 8:
-        continue;
-
-      // something bad happened
-      default:
-        return false;
-    }
+    return true;
+  }
+
+  // Select satellite system by talker, notify behind the flip of a complete sky view
+  SatelliteSystemClass *system = satelliteSystemByTalker(sentence.talker);
+  if(system && system->commitGSV(sentence))
+  {
+    notify(skyViewHandler, skyViewContext);
+  }
+
+  return true;
+}
+
+// Track made good and ground speed
+// GNVTG,trackDegreesTrue,T,trackDegreesMagnetic,M,speedKnots,N,speedKmh,K,mode
+void GpsDecoderClass::parseFieldVTG(SentenceClass &sentence, uint8_t index, const FieldClass &field)
+{
+  switch (index)
+  {
+    case 1:
+      sentence.setValid(index, field.toFixed(2, sentence.course));
+      break;
+
+    case 2:
+      sentence.status = field.first();
+      break;
+
+    case 5:
+      sentence.setValid(index, field.toFixed(2, sentence.speed));
+      break;
 
-    fragment = strsep(&frame, ",");
+    default:
+      break;
   }
+}
 
+bool GpsDecoderClass::commitVTG(const SentenceClass &sentence)
+{
   // If data is valid
-  if(valid == 'T')
+  if(sentence.status == 'T' && sentence.isValid(1) && sentence.isValid(5))
   {
     // Update speed
-    speed.set((double)speedKnots);
+    speed.set(sentence.speed);
     speed.commit();
 
     // Update course
-    course.set((double)trackDegrees);
+    course.set(sentence.course);
     course.commit();
   }
 
@@ -816,31 +833,80 @@ bool GpsDecoderClass::parseFrameVTG(char *frame)
 //
 // ******************************************************************************************************
 
-// Replace in a string, using a needle with its replacement
-void GpsDecoderClass::strReplace(char *stack, char *needle, char replacement)
+// Find the first char, which changes the frame decode state ($, *, ',', \r, \n or binary garbage)
+// Returns its offset or length, if there is no such char
+// Checks 32 or 16 chars at once on targets with AVX2, SSE2 or NEON
+size_t GpsDecoderClass::findControlChar(const char *buffer, size_t length)
 {
-  char *rep;
-  // As long the needle is found in stack, replace it
-  while((rep = strstr(stack,needle))!=NULL)
+  size_t i = 0;
+
+#if defined(__AVX2__)
+  const __m256i dollar = _mm256_set1_epi8('$');
+  const __m256i star = _mm256_set1_epi8('*');
+  const __m256i comma = _mm256_set1_epi8(',');
+  const __m256i space = _mm256_set1_epi8(0x20);
+  const __m256i flip = _mm256_set1_epi8((char)0x80);
+  const __m256i printableMax = _mm256_set1_epi8((char)(0x5e ^ 0x80));
+
+  for (; i + 32 <= length; i += 32)
   {
-    // Change current found needle with replacement
-    *rep = replacement;
+    __m256i chars = _mm256_loadu_si256((const __m256i *)(buffer + i));
+    // Unsigned (c - 0x20) > 0x5e is done as signed compare with flipped sign bits
+    __m256i control = _mm256_cmpgt_epi8(_mm256_xor_si256(_mm256_sub_epi8(chars, space), flip), printableMax);
+    control = _mm256_or_si256(control, _mm256_cmpeq_epi8(chars, dollar));
+    control = _mm256_or_si256(control, _mm256_cmpeq_epi8(chars, star));
+    control = _mm256_or_si256(control, _mm256_cmpeq_epi8(chars, comma));
+    uint32_t mask = (uint32_t)_mm256_movemask_epi8(control);
+    if (mask) return i + __builtin_ctz(mask);
   }
-}
+#endif
 
+#if defined(__SSE2__)
+  const __m128i dollar128 = _mm_set1_epi8('$');
+  const __m128i star128 = _mm_set1_epi8('*');
+  const __m128i comma128 = _mm_set1_epi8(',');
+  const __m128i space128 = _mm_set1_epi8(0x20);
+  const __m128i flip128 = _mm_set1_epi8((char)0x80);
+  const __m128i printableMax128 = _mm_set1_epi8((char)(0x5e ^ 0x80));
 
-// https://stackoverflow.com/questions/58244300/getting-the-error-undefined-reference-to-strsep-with-clang-and-mingw
-// MinGw does not hat strsep
-char *GpsDecoderClass::strsep(char **stringp, const char *delim)
-{
-   char *rv = *stringp;
-    if (rv) {
-        *stringp += strcspn(*stringp, delim);
-        if (**stringp)
-            *(*stringp)++ = '\0';
-        else
-            *stringp = 0; }
-    return rv;
+  for (; i + 16 <= length; i += 16)
+  {
+    __m128i chars = _mm_loadu_si128((const __m128i *)(buffer + i));
+    // Unsigned (c - 0x20) > 0x5e is done as signed compare with flipped sign bits
+    __m128i control = _mm_cmpgt_epi8(_mm_xor_si128(_mm_sub_epi8(chars, space128), flip128), printableMax128);
+    control = _mm_or_si128(control, _mm_cmpeq_epi8(chars, dollar128));
+    control = _mm_or_si128(control, _mm_cmpeq_epi8(chars, star128));
+    control = _mm_or_si128(control, _mm_cmpeq_epi8(chars, comma128));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(control);
+    if (mask) return i + __builtin_ctz(mask);
+  }
+#elif defined(__ARM_NEON)
+  const uint8x16_t dollar = vdupq_n_u8('$');
+  const uint8x16_t star = vdupq_n_u8('*');
+  const uint8x16_t comma = vdupq_n_u8(',');
+  const uint8x16_t space = vdupq_n_u8(0x20);
+  const uint8x16_t printableMax = vdupq_n_u8(0x5e);
+
+  for (; i + 16 <= length; i += 16)
+  {
+    uint8x16_t chars = vld1q_u8((const uint8_t *)(buffer + i));
+    uint8x16_t control = vcgtq_u8(vsubq_u8(chars, space), printableMax);
+    control = vorrq_u8(control, vceqq_u8(chars, dollar));
+    control = vorrq_u8(control, vceqq_u8(chars, star));
+    control = vorrq_u8(control, vceqq_u8(chars, comma));
+    // Narrow every byte of the compare result to a nibble, so the mask fits into 64 bits
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(control), 4)), 0);
+    if (mask) return i + (__builtin_ctzll(mask) >> 2);
+  }
+#endif
+
+  // Remaining chars or targets without SIMD
+  for (; i < length; i++)
+  {
+    if (buffer[i] == '$' || buffer[i] == '*' || buffer[i] == ',' || !isFrameChar(buffer[i])) return i;
+  }
+
+  return length;
 }
 
 
@@ -856,6 +922,7 @@ uint8_t GpsDecoderClass::fromHex(char a)
 }
 
 
+#ifndef GPS_DECODER_NO_FLOAT
 // returns distance in meters between two positions, both specified
 // as signed decimal-degrees latitude and longitude. Uses great-circle
 // distance computation for hypothetical sphere of radius 6372795 meters.
@@ -906,32 +973,835 @@ double GpsDecoderClass::courseTo(double lat1, double long1, double lat2, double
 // Return course as cardinal
 const char *GpsDecoderClass::cardinal(double course)
 {
-  static const char* directions[] = {"N", "NNE", "NE", "ENE", "E", "ESE", "SE", "SSE", "S", "SSW", "SW", "WSW", "W", "WNW", "NW", "NNW"};
   int direction = (int)((course + 11.25f) / 22.5f);
-  return directions[direction % 16];
+  return cardinalDirections[direction % 16];
+}
+
+
+// ******************************************************************************************************
+//
+// Accuracy tiers of distanceBetween and courseTo, see DistanceMethod
+//
+// DISTANCE_EQUIRECTANGULAR  Flat, with the meridian and prime vertical radius of WGS-84 at the mean latitude
+// DISTANCE_HAVERSINE        Great circle on a sphere of GPS_DECODER_MEAN_RADIUS
+// DISTANCE_VINCENTY         Geodesic on the WGS-84 ellipsoid, Vincenty's inverse solution. Nearly antipodal
+//                           points, where the iteration does not converge, are solved by a bisection of the
+//                           start azimuth after Karney's Lambda12
+//
+// Error envelopes against GeographicLib over 700000 position pairs: global, 0.1 m to 16000 km at all
+// latitudes and nearly antipodal. d is the distance, r = d / GPS_DECODER_MEAN_RADIUS and q = |dLong * sin(mean lat)|
+// the convergence of the meridians, both in radians. The flat tier has no envelope from q = 0.5 or r = 0.1 on.
+//
+// Tier              distance                           course                                          ns, x86-64 -O2
+// EQUIRECTANGULAR   0.15 * d * (q^2 + r^2) + 0.01 mm   1.1 * (q / 2 + r) rad                           20, course 60
+// HAVERSINE         0.57% of d                         0.2 deg below 12000 km, 2 deg below 19000 km    50 to 75
+// VINCENTY          0.1 mm                             1e-6 deg                                        200 to 420
+// distanceBetween() without method takes 40 to 70 ns.
+//
+// On 10 Hz hops of a car the flat tier is within 0.01 mm outside of the pole caps.
+// DISTANCE_AUTO takes the first tier in this order, whose envelope is within the tolerance, and calculates
+// only that tier. The envelopes are taken a priori from the latitude and longitude span, with the upper
+// bounds d <= 6.4e6 m * (dLat + dLong), the radii of curvature of WGS-84 stay below 6.4e6 m, and
+// q <= dLong * min(1, |mean lat|), all angles in radians. So it never costs more than the tier it takes,
+// but takes the next tier a bit earlier than the envelope of the real distance would.
+//
+// ******************************************************************************************************
+
+// Difference of two longitudes in -180...180 degrees into -180...180 degrees
+static double wrapLongitude(double angle)
+{
+  if (angle > 180.0) angle -= 360.0;
+  else if (angle < -180.0) angle += 360.0;
+  return angle;
+}
+
+// Scales sine and cosine of an angle to length 1
+static void normalize(double &sine, double &cosine)
+{
+  double length = sqrt(sq(sine) + sq(cosine));
+  sine /= length;
+  cosine /= length;
+}
+
+// Flat distance in meters or course in degrees
+static double equirectangular(double lat1, double long1, double lat2, double long2, bool course)
+{
+  const double e2 = GPS_DECODER_WGS84_F * (2 - GPS_DECODER_WGS84_F);
+  double meanLat = radians((lat1 + lat2) / 2);
+  double sinLat = sin(meanLat);
+  double w2 = 1 - e2 * sq(sinLat);
+  double primeVertical = GPS_DECODER_WGS84_A / sqrt(w2);      // Radius of curvature along the parallel
+  double meridian = primeVertical * (1 - e2) / w2;             // Radius of curvature along the meridian
+  double deltaLong = radians(wrapLongitude(long2 - long1));
+  double north = meridian * radians(lat2 - lat1);
+  double east = primeVertical * cos(meanLat) * deltaLong;
+  if (!course) return sqrt(sq(north) + sq(east));
+
+  double angle = atan2(east, north);
+  if (angle < 0.0)
+  {
+    angle += GPS_DECODER_TWO_PI;
+  }
+  return degrees(angle);
+}
+
+// Great circle distance in meters or course in degrees
+static double haversine(double lat1, double long1, double lat2, double long2, bool course)
+{
+  double deltaLong = radians(wrapLongitude(long2 - long1));
+  lat1 = radians(lat1);
+  lat2 = radians(lat2);
+  double clat1 = cos(lat1);
+  double clat2 = cos(lat2);
+
+  if (!course)
+  {
+    double h = sq(sin((lat2 - lat1) / 2)) + clat1 * clat2 * sq(sin(deltaLong / 2));
+    h = fmin(h, 1.0);
+    return 2 * GPS_DECODER_MEAN_RADIUS * atan2(sqrt(h), sqrt(1 - h));
+  }
+
+  double angle = atan2(sin(deltaLong) * clat2, clat1 * sin(lat2) - sin(lat1) * clat2 * cos(deltaLong));
+  if (angle < 0.0)
+  {
+    angle += GPS_DECODER_TWO_PI;
+  }
+  return degrees(angle);
+}
+
+struct VincentyArc                                             // Geodesic on the auxiliary sphere of the reduced latitudes
+{
+  double sinAlpha1, cosAlpha1, sinAlpha2, cosAlpha2;          // Azimuth at both ends
+  double sinAlpha0;                                            // Azimuth at the equator
+  double sinSigma, cosSigma, sigma;                            // Arc length
+  double cos2SigmaM;                                           // cos of twice the arc from the equator to the midpoint
+};
+
+// Longitude difference on the ellipsoid of the geodesic, which leaves point 1 with alpha1, after Karney's Lambda12
+// Needs the canonical order of vincenty(), the geodesic reaches point 2 on its way north
+static double vincentyLambda(double sinU1, double cosU1, double sinU2, double cosU2, double alpha1, VincentyArc &arc)
+{
+  const double f = GPS_DECODER_WGS84_F;
+  arc.sinAlpha1 = sin(alpha1);
+  arc.cosAlpha1 = cos(alpha1);
+  arc.sinAlpha0 = arc.sinAlpha1 * cosU1;
+  double cosAlpha0 = sqrt(sq(arc.cosAlpha1) + sq(arc.sinAlpha1 * sinU1));
+
+  // Arc and longitude on the auxiliary sphere, both from the equator crossing
+  double sinSigma1 = sinU1, cosSigma1 = arc.cosAlpha1 * cosU1;
+  double sinOmega1 = arc.sinAlpha0 * sinU1, cosOmega1 = cosSigma1;
+  normalize(sinSigma1, cosSigma1);
+  normalize(sinOmega1, cosOmega1);
+
+  arc.sinAlpha2 = cosU2 != cosU1 ? arc.sinAlpha0 / cosU2 : arc.sinAlpha1;
+  arc.cosAlpha2 = cosU2 != cosU1 || fabs(sinU2) != -sinU1 ?
+    sqrt(sq(arc.cosAlpha1 * cosU1) + (cosU1 < -sinU1 ? (cosU2 - cosU1) * (cosU1 + cosU2) : (sinU1 - sinU2) * (sinU1 + sinU2))) / cosU2 :
+    fabs(arc.cosAlpha1);
+  double sinSigma2 = sinU2, cosSigma2 = arc.cosAlpha2 * cosU2;
+  double sinOmega2 = arc.sinAlpha0 * sinU2, cosOmega2 = cosSigma2;
+  normalize(sinSigma2, cosSigma2);
+  normalize(sinOmega2, cosOmega2);
+
+  arc.sinSigma = fmax(0.0, cosSigma1 * sinSigma2 - sinSigma1 * cosSigma2);
+  arc.cosSigma = cosSigma1 * cosSigma2 + sinSigma1 * sinSigma2;
+  arc.sigma = atan2(arc.sinSigma, arc.cosSigma);
+  arc.cos2SigmaM = cosSigma1 * cosSigma2 - sinSigma1 * sinSigma2;
+  double omega = atan2(fmax(0.0, cosOmega1 * sinOmega2 - sinOmega1 * cosOmega2), cosOmega1 * cosOmega2 + sinOmega1 * sinOmega2);
+
+  double cos2Alpha = sq(cosAlpha0);
+  double c = f / 16 * cos2Alpha * (4 + f * (4 - 3 * cos2Alpha));
+  return omega - (1 - c) * f * arc.sinAlpha0 * (arc.sigma + c * arc.sinSigma * (arc.cos2SigmaM + c * arc.cosSigma * (-1 + 2 * sq(arc.cos2SigmaM))));
+}
+
+// Geodesic distance in meters or course in degrees on WGS-84, Vincenty's inverse solution
+static double vincenty(double lat1, double long1, double lat2, double long2, bool course)
+{
+  const double f = GPS_DECODER_WGS84_F;
+  const double pi = GPS_DECODER_TWO_PI / 2;
+
+  // Canonical order lat1 <= 0, |lat1| >= |lat2|, long2 >= long1, the course is turned back at the end
+  double deltaLong = wrapLongitude(long2 - long1);
+  double longSign = deltaLong < 0.0 ? -1.0 : 1.0;
+  bool swapped = fabs(lat1) < fabs(lat2);
+  if (swapped)
+  {
+    double lat = lat1;
+    lat1 = lat2;
+    lat2 = lat;
+    longSign = -longSign;
+  }
+  double latSign = lat1 > 0.0 ? -1.0 : 1.0;
+  lat1 *= latSign;
+  lat2 *= latSign;
+
+  // Reduced latitudes, the cosine stays above 0 at the poles
+  double sinU1 = (1 - f) * sin(radians(lat1)), cosU1 = cos(radians(lat1));
+  double sinU2 = (1 - f) * sin(radians(lat2)), cosU2 = cos(radians(lat2));
+  normalize(sinU1, cosU1);
+  normalize(sinU2, cosU2);
+  cosU1 = fmax(cosU1, 1e-150);
+  cosU2 = fmax(cosU2, 1e-150);
+  if (cosU2 == cosU1) sinU2 = sinU2 < 0.0 ? sinU1 : -sinU1;
+
+  double L = radians(fabs(deltaLong));
+  double lambda = L, last;
+  uint8_t iterations = 0;
+  VincentyArc arc;
+  do
+  {
+    double sinLambda = sin(lambda);
+    double cosLambda = cos(lambda);
+    arc.sinAlpha1 = cosU2 * sinLambda;
+    arc.cosAlpha1 = cosU1 * sinU2 - sinU1 * cosU2 * cosLambda;
+    arc.sinAlpha2 = cosU1 * sinLambda;
+    arc.cosAlpha2 = cosU1 * sinU2 * cosLambda - sinU1 * cosU2;
+    arc.sinSigma = sqrt(sq(arc.sinAlpha1) + sq(arc.cosAlpha1));
+    arc.cosSigma = sinU1 * sinU2 + cosU1 * cosU2 * cosLambda;
+    if (arc.sinSigma == 0.0) return 0.0;                      // Same position
+    arc.sigma = atan2(arc.sinSigma, arc.cosSigma);
+    arc.sinAlpha0 = cosU1 * cosU2 * sinLambda / arc.sinSigma;
+    double cos2Alpha = 1 - sq(arc.sinAlpha0);
+    arc.cos2SigmaM = cos2Alpha != 0.0 ? arc.cosSigma - 2 * sinU1 * sinU2 / cos2Alpha : 0.0;   // 0 along the equator
+    double c = f / 16 * cos2Alpha * (4 + f * (4 - 3 * cos2Alpha));
+    last = lambda;
+    lambda = L + (1 - c) * f * arc.sinAlpha0 * (arc.sigma + c * arc.sinSigma * (arc.cos2SigmaM + c * arc.cosSigma * (-1 + 2 * sq(arc.cos2SigmaM))));
+  } while (fabs(lambda - last) > 1e-15 && ++iterations < 100 && lambda <= pi);
+
+  if (fabs(lambda - last) > 1e-15)
+  {
+    // Nearly antipodal, the longitude difference grows monotonic with alpha1 from 0 to 180 degrees
+    double low = 0.0, high = pi;
+    for (uint8_t i = 0; i < 64; i++)
+    {
+      double alpha1 = (low + high) / 2;
+      if (vincentyLambda(sinU1, cosU1, sinU2, cosU2, alpha1, arc) < L) low = alpha1;
+      else high = alpha1;
+    }
+  }
+
+  if (course)
+  {
+    double sinAlpha = swapped ? -arc.sinAlpha2 : arc.sinAlpha1;   // Reverse of the course at point 2
+    double cosAlpha = swapped ? -arc.cosAlpha2 : arc.cosAlpha1;
+    double angle = atan2(sinAlpha * longSign, cosAlpha * latSign);
+    if (angle < 0.0)
+    {
+      angle += GPS_DECODER_TWO_PI;
+    }
+    return degrees(angle);
+  }
+
+  double u2 = (1 - sq(arc.sinAlpha0)) * (1 / sq(1 - f) - 1);
+  double A = 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+  double B = u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+  double deltaSigma = B * arc.sinSigma * (arc.cos2SigmaM + B / 4 * (arc.cosSigma * (-1 + 2 * sq(arc.cos2SigmaM)) -
+                      B / 6 * arc.cos2SigmaM * (-3 + 4 * sq(arc.sinSigma)) * (-3 + 4 * sq(arc.cos2SigmaM))));
+  return GPS_DECODER_WGS84_A * (1 - f) * A * (arc.sigma - deltaSigma);
+}
+
+// First tier, whose envelope is within tolerance at the upper bounds of distance and convergence, no tier is calculated
+static GpsDecoderClass::DistanceMethod cheapestMethod(double lat1, double long1, double lat2, double long2, bool course, double tolerance)
+{
+  double deltaLat = radians(fabs(lat2 - lat1));
+  double deltaLong = radians(fabs(wrapLongitude(long2 - long1)));
+  double distance = 6.4e6 * (deltaLat + deltaLong);
+  double r = distance / GPS_DECODER_MEAN_RADIUS;
+  double q = deltaLong * fmin(1.0, radians(fabs(lat1 + lat2) / 2));   // |sin(x)| <= |x|
+
+  if (q < 0.5 && r < 0.1)
+  {
+    double error = course ? degrees(1.1 * (q / 2 + r)) : 0.15 * distance * (sq(q) + sq(r)) + 1e-5;
+    if (error <= tolerance) return GpsDecoderClass::DISTANCE_EQUIRECTANGULAR;
+  }
+
+  double error = !course ? 0.0057 * distance : distance < 12e6 ? 0.2 : distance < 19e6 ? 2.0 : HUGE_VAL;
+  if (error <= tolerance) return GpsDecoderClass::DISTANCE_HAVERSINE;
+  return GpsDecoderClass::DISTANCE_VINCENTY;
+}
+
+
+// returns distance in meters between two positions with the tier method, tolerance in meters for DISTANCE_AUTO
+double GpsDecoderClass::distanceBetween(double lat1, double long1, double lat2, double long2, DistanceMethod method, double tolerance)
+{
+  if (method == DISTANCE_AUTO) method = cheapestMethod(lat1, long1, lat2, long2, false, tolerance);
+  if (method == DISTANCE_EQUIRECTANGULAR) return equirectangular(lat1, long1, lat2, long2, false);
+  if (method == DISTANCE_HAVERSINE) return haversine(lat1, long1, lat2, long2, false);
+  return vincenty(lat1, long1, lat2, long2, false);
+}
+
+
+// returns course in degrees from position 1 to position 2 with the tier method, tolerance in degrees for DISTANCE_AUTO
+double GpsDecoderClass::courseTo(double lat1, double long1, double lat2, double long2, DistanceMethod method, double tolerance)
+{
+  if (method == DISTANCE_AUTO) method = cheapestMethod(lat1, long1, lat2, long2, true, tolerance);
+  if (method == DISTANCE_EQUIRECTANGULAR) return equirectangular(lat1, long1, lat2, long2, true);
+  if (method == DISTANCE_HAVERSINE) return haversine(lat1, long1, lat2, long2, true);
+  return vincenty(lat1, long1, lat2, long2, true);
+}
+
+
+GpsDecoderClass::DistanceMethod GpsDecoderClass::distanceMethod(double lat1, double long1, double lat2, double long2, double tolerance)
+{
+  return cheapestMethod(lat1, long1, lat2, long2, false, tolerance);
+}
+
+
+GpsDecoderClass::DistanceMethod GpsDecoderClass::courseMethod(double lat1, double long1, double lat2, double long2, double tolerance)
+{
+  return cheapestMethod(lat1, long1, lat2, long2, true, tolerance);
+}
+
+
+// ******************************************************************************************************
+//
+// Batch geodesy, the formulas of distanceBetween and courseTo over arrays
+//
+// GCC and clang on x86-64 and AArch64 run the batches with vector extensions. The kernel is written once
+// for a vector of W lanes and compiled for AVX-512 (W = 8 double, 16 float), AVX2 with FMA (4, 8) and
+// SSE2 or NEON (2, 4). On x86-64 the widest kernel the CPU supports is selected at the first call.
+// sin, cos and atan2 are polynomials, sqrt is a Newton iteration, so the kernels need no libm.
+//
+// Largest difference to the scalar functions over 2 million random pairs, 1 cm to 20000 km apart, with all
+// three x86-64 kernels, enforced by tests/gpsDecoderBatchTest.cpp:
+// double: distance 7.5e-9 m at any distance, which is 1e-14 relative beyond 100 km. Bound 1e-8 m.
+//         course 9e-11 deg for positions more than 1 km apart, 7e-6 deg for positions 1 cm apart and
+//         2e-7 deg for nearly antipodal positions, where the course is ill-conditioned. Bounds 1e-9, 1e-5
+//         and 1e-6 deg.
+// float:  distance 3.5 m + 2e-7 relative, bound 4 m + 3e-7 relative. The longitude difference of positions
+//         on both sides of 180 degrees is near 360 and rounded in float, which costs up to 3.5 m even for
+//         close positions. Course 0.17 deg for positions more than 1 km apart and 0.0045 deg beyond 100 km,
+//         bounds 0.2 and 0.005 deg. Closer positions have no usable float course, float inputs have a
+//         resolution of about 1 m, and nearly antipodal ones neither.
+//
+// All other compilers and targets run the scalar functions in a loop.
+//
+// ******************************************************************************************************
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__aarch64__))
+  #define GPS_DECODER_BATCH_SIMD
+#endif
+
+#ifdef GPS_DECODER_BATCH_SIMD
+enum BatchOperation                                            // Formulas of the kernels
+{
+  BATCH_DISTANCE,                                              // distanceBetween(lat1, long1, lat2, long2)
+  BATCH_COURSE,                                                // courseTo(lat1, long1, lat2, long2)
+  BATCH_DISTANCE_FROM,                                         // From a prepared point, lat1 holds sin and cos of its latitude and longitude
+  BATCH_COURSE_FROM
+};
+
+template <class T> struct BatchMath;                           // Constants and polynomials of one precision
+
+template <> struct BatchMath<double>
+{
+  typedef int64_t Int;
+  static constexpr double roundMagic = 6755399441055744.0;     // 1.5 * 2^52, adding it rounds to an integer in the low bits
+  static constexpr double pio2Hi = 1.57079632673412561417e+00; // pi / 2 in three parts for the reduction
+  static constexpr double pio2Mid = 6.07710050630396597660e-11;
+  static constexpr double pio2Lo = 2.02226624879595063154e-21;
+  static constexpr double atanSplit = 0.66;                    // Above, atan(x) = pi / 4 + atan((x - 1) / (x + 1))
+  static constexpr Int rsqrtMagic = 0x5fe6eb50c7b537a9LL;
+  static const int rsqrtIterations = 4;
+
+  // sin(r) = r + r * z * sinPoly(z), cos(r) = 1 - z / 2 + z * z * cosPoly(z), z = r * r, |r| <= pi / 4
+  template <class V> static inline __attribute__((always_inline)) void sinPoly(V &p, const V &z)
+  {
+    p = ((((( 1.58962301576546568060e-10 * z - 2.50507477628578072866e-8) * z + 2.75573136213857245213e-6) * z
+              - 1.98412698295895385996e-4) * z + 8.33333333332211858878e-3) * z - 1.66666666666666307295e-1);
+  }
+  template <class V> static inline __attribute__((always_inline)) void cosPoly(V &p, const V &z)
+  {
+    p = (((((-1.13585365213876817300e-11 * z + 2.08757008419747316778e-9) * z - 2.75573141792967388112e-7) * z
+              + 2.48015872888517045348e-5) * z - 1.38888888888730564116e-3) * z + 4.16666666666665929218e-2);
+  }
+  // atan(x) for |x| <= 0.66
+  template <class V> static inline __attribute__((always_inline)) void atan(V &result, const V &x)
+  {
+    V z = x * x;
+    V p = ((((-8.750608600031904122785e-1 * z - 1.615753718733365076637e1) * z - 7.500855792314704667340e1) * z
+           - 1.228866684490136173410e2) * z - 6.485021904942025371773e1);
+    V q = (((((z + 2.485846490142306297962e1) * z + 1.650270098316988542046e2) * z + 4.328810604912902668951e2) * z
+           + 4.853903996359136964868e2) * z + 1.945506571482613964425e2);
+    result = x + x * z * p / q;
+  }
+};
+
+template <> struct BatchMath<float>
+{
+  typedef int32_t Int;
+  static constexpr float roundMagic = 12582912.0f;             // 1.5 * 2^23
+  static constexpr float pio2Hi = 1.5703125f;
+  static constexpr float pio2Mid = 4.837512969970703125e-4f;
+  static constexpr float pio2Lo = 7.54978995489188216e-8f;
+  static constexpr float atanSplit = 0.41421356f;              // tan(pi / 8)
+  static constexpr Int rsqrtMagic = 0x5f3759df;
+  static const int rsqrtIterations = 3;
+
+  template <class V> static inline __attribute__((always_inline)) void sinPoly(V &p, const V &z)
+  {
+    p = ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f);
+  }
+  template <class V> static inline __attribute__((always_inline)) void cosPoly(V &p, const V &z)
+  {
+    p = ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f);
+  }
+  // atan(x) for |x| <= tan(pi / 8)
+  template <class V> static inline __attribute__((always_inline)) void atan(V &result, const V &x)
+  {
+    V z = x * x;
+    result = ((((8.05374449538e-2f * z - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * x + x);
+  }
+};
+
+template <class T, int W> struct BatchKernel                   // distanceBetween and courseTo on W lanes
+{
+  typedef typename BatchMath<T>::Int Int;
+  typedef T V __attribute__((vector_size(sizeof(T) * W)));
+  typedef Int I __attribute__((vector_size(sizeof(T) * W)));   // Lane masks, all bits set or clear
+  typedef BatchMath<T> M;
+
+  static const Int signBit = (Int)((uint64_t)1 << (sizeof(T) * 8 - 1));
+
+  // The helpers return vectors in their first parameter. The helpers are compiled without AVX, a vector
+  // returned by value would change the ABI and GCC warns about that, even if it is always inlined.
+  static inline __attribute__((always_inline)) void select(V &result, const I &mask, const V &a, const V &b)   { result = (V)(((I)a & mask) | ((I)b & ~mask)); }
+  static inline __attribute__((always_inline)) void abs(V &result, const V &x)   { result = (V)((I)x & ~signBit); }
+
+  static inline __attribute__((always_inline)) void sqrt(V &result, const V &x)
+  {
+    // Reciprocal square root from the exponent bits, refined by Newton steps
+    V y = (V)(M::rsqrtMagic - ((I)x >> 1));
+    for (int i = 0; i < M::rsqrtIterations; i++) y = y * ((T)1.5 - (T)0.5 * x * y * y);
+    result = x * y;
+  }
+
+  static inline __attribute__((always_inline)) void sinCos(const V &x, V &sine, V &cosine)
+  {
+    // x = q * pi / 2 + r, the low bits of t are q mod 4
+    V t = x * (T)(4 / GPS_DECODER_TWO_PI) + M::roundMagic;
+    I quadrant = (I)t;
+    V q = t - M::roundMagic;
+    V r = x - q * M::pio2Hi;
+    r = r - q * M::pio2Mid;
+    r = r - q * M::pio2Lo;
+
+    V z = r * r, sinP, cosP;
+    M::sinPoly(sinP, z);
+    M::cosPoly(cosP, z);
+    V s = r + r * z * sinP;
+    V c = (T)1 - (T)0.5 * z + z * z * cosP;
+
+    I swap = (quadrant & 1) != 0;
+    V sr, cr;
+    select(sr, swap, c, s);
+    select(cr, swap, s, c);
+    sine = (V)((I)sr ^ ((quadrant & 2) << (sizeof(T) * 8 - 2)));
+    cosine = (V)((I)cr ^ (((quadrant + 1) & 2) << (sizeof(T) * 8 - 2)));
+  }
+
+  // angle must not be y or x
+  static inline __attribute__((always_inline)) void atan2(V &angle, const V &y, const V &x)
+  {
+    V zero = {}, ax, ay, low, high;
+    abs(ax, x);
+    abs(ay, y);
+    I steep = ay > ax;
+    select(low, steep, ax, ay);
+    select(high, steep, ay, ax);
+
+    // Above the split, atan(low / high) = pi / 4 + atan((low - high) / (low + high))
+    I upper = low > high * M::atanSplit;
+    V num, den, ratio;
+    select(num, upper, low - high, low);
+    select(den, upper, low + high, high);
+    select(den, den == (T)0, zero + (T)1, den);
+
+    M::atan(ratio, num / den);
+    select(angle, upper, zero + (T)(GPS_DECODER_TWO_PI / 8), zero);
+    angle = ratio + angle;
+    select(angle, steep, (T)(GPS_DECODER_TWO_PI / 4) - angle, angle);
+    select(angle, (I)x < 0, (T)(GPS_DECODER_TWO_PI / 2) - angle, angle);
+    angle = (V)(((I)angle & ~signBit) | ((I)y & signBit));
+  }
+
+  static inline __attribute__((always_inline)) void load(V &v, const T *values)   { memcpy(&v, values, sizeof(v)); }
+  static inline __attribute__((always_inline)) void store(T *values, const V &v)   { memcpy(values, &v, sizeof(v)); }
+
+  // Distance of the central angle between 1 and 2, the longitude difference is long1 - long2
+  static inline __attribute__((always_inline)) void distanceOf(V &distance, const V &sinLat1, const V &cosLat1, const V &sinLat2, const V &cosLat2, const V &sinDLong, const V &cosDLong)
+  {
+    V north = cosLat1 * sinLat2 - sinLat1 * cosLat2 * cosDLong;
+    V east = cosLat2 * sinDLong;
+    V denom = sinLat1 * sinLat2 + cosLat1 * cosLat2 * cosDLong;
+    V root;
+    sqrt(root, north * north + east * east);
+    atan2(distance, root, denom);
+    distance = distance * (T)6372795;
+  }
+
+  // Course from 1 to 2 in degrees, the longitude difference is long2 - long1
+  static inline __attribute__((always_inline)) void courseOf(V &course, const V &sinLat1, const V &cosLat1, const V &sinLat2, const V &cosLat2, const V &sinDLong, const V &cosDLong)
+  {
+    atan2(course, sinDLong * cosLat2, cosLat1 * sinLat2 - sinLat1 * cosLat2 * cosDLong);
+    select(course, course < (T)0, course + (T)GPS_DECODER_TWO_PI, course);
+    course = course * (T)GPS_DECODER_RAD_TO_DEG;
+  }
+
+  // a, b, c, d are lat1, long1, lat2, long2, or for the FROM operations lat2 and long2 in c and d
+  template <int Op>
+  static inline __attribute__((always_inline)) void formula(V &result, const V *reference, const V &a, const V &b, const V &c, const V &d)
+  {
+    V sinLat1, cosLat1, sinLat2, cosLat2, sinDLong, cosDLong;
+
+    sinCos(c * (T)GPS_DECODER_DEG_TO_RAD, sinLat2, cosLat2);
+    if (Op == BATCH_DISTANCE || Op == BATCH_COURSE)
+    {
+      sinCos(a * (T)GPS_DECODER_DEG_TO_RAD, sinLat1, cosLat1);
+      sinCos((b - d) * (T)GPS_DECODER_DEG_TO_RAD, sinDLong, cosDLong);
+    }
+    else
+    {
+      // Only the moving point needs sin and cos, long1 - long2 by the angle sum rules
+      V sinLong2, cosLong2;
+      sinCos(d * (T)GPS_DECODER_DEG_TO_RAD, sinLong2, cosLong2);
+      sinLat1 = reference[0];
+      cosLat1 = reference[1];
+      sinDLong = reference[2] * cosLong2 - reference[3] * sinLong2;
+      cosDLong = reference[3] * cosLong2 + reference[2] * sinLong2;
+    }
+
+    if (Op == BATCH_DISTANCE || Op == BATCH_DISTANCE_FROM) distanceOf(result, sinLat1, cosLat1, sinLat2, cosLat2, sinDLong, cosDLong);
+    else courseOf(result, sinLat1, cosLat1, sinLat2, cosLat2, -sinDLong, cosDLong);
+  }
+
+  // One formula over all positions, the rest behind the last full vector is padded
+  template <int Op>
+  static inline __attribute__((always_inline)) void run(const T *a, const T *b, const T *c, const T *d, T *out, size_t count)
+  {
+    V reference[4] = {}, va, vb, vc, vd, result;
+    if (Op == BATCH_DISTANCE_FROM || Op == BATCH_COURSE_FROM)
+    {
+      for (int k = 0; k < 4; k++) reference[k] = reference[k] + a[k];
+      a = b = c;                                               // Loaded, but not used
+    }
+
+    size_t i = 0;
+    for (; i + W <= count; i += W)
+    {
+      load(va, a + i);
+      load(vb, b + i);
+      load(vc, c + i);
+      load(vd, d + i);
+      formula<Op>(result, reference, va, vb, vc, vd);
+      store(out + i, result);
+    }
+
+    if (i < count)
+    {
+      T rest[5][W] = {};
+      size_t n = count - i;
+      memcpy(rest[0], a + i, n * sizeof(T));
+      memcpy(rest[1], b + i, n * sizeof(T));
+      memcpy(rest[2], c + i, n * sizeof(T));
+      memcpy(rest[3], d + i, n * sizeof(T));
+      load(va, rest[0]);
+      load(vb, rest[1]);
+      load(vc, rest[2]);
+      load(vd, rest[3]);
+      formula<Op>(result, reference, va, vb, vc, vd);
+      store(rest[4], result);
+      memcpy(out + i, rest[4], n * sizeof(T));
+    }
+  }
+};
+
+// Entry points of the kernels, the widest kernel of the CPU is selected in batchFunctions()
+#if defined(__x86_64__)
+template <class T, int Op> __attribute__((target("avx512f"))) static void batchAvx512(const T *a, const T *b, const T *c, const T *d, T *out, size_t count)
+  { BatchKernel<T, 64 / sizeof(T)>::template run<Op>(a, b, c, d, out, count); }
+template <class T, int Op> __attribute__((target("avx2,fma"))) static void batchAvx2(const T *a, const T *b, const T *c, const T *d, T *out, size_t count)
+  { BatchKernel<T, 32 / sizeof(T)>::template run<Op>(a, b, c, d, out, count); }
+#endif
+template <class T, int Op> static void batch128(const T *a, const T *b, const T *c, const T *d, T *out, size_t count)
+  { BatchKernel<T, 16 / sizeof(T)>::template run<Op>(a, b, c, d, out, count); }
+
+struct BatchFunctions
+{
+  const char *name;
+  void (*distanceDouble)(const double *, const double *, const double *, const double *, double *, size_t);
+  void (*distanceFloat)(const float *, const float *, const float *, const float *, float *, size_t);
+  void (*courseDouble)(const double *, const double *, const double *, const double *, double *, size_t);
+  void (*courseFloat)(const float *, const float *, const float *, const float *, float *, size_t);
+  void (*distanceFrom)(const double *, const double *, const double *, const double *, double *, size_t);
+  void (*courseFrom)(const double *, const double *, const double *, const double *, double *, size_t);
+};
+
+#define GPS_DECODER_BATCH_FUNCTIONS(name, kernel) \
+  { name, kernel<double, BATCH_DISTANCE>, kernel<float, BATCH_DISTANCE>, kernel<double, BATCH_COURSE>, kernel<float, BATCH_COURSE>, \
+    kernel<double, BATCH_DISTANCE_FROM>, kernel<double, BATCH_COURSE_FROM> }
+
+static BatchFunctions selectBatchFunctions()
+{
+#if defined(__x86_64__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    BatchFunctions avx512 = GPS_DECODER_BATCH_FUNCTIONS("avx512", batchAvx512);
+    return avx512;
+  }
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+  {
+    BatchFunctions avx2 = GPS_DECODER_BATCH_FUNCTIONS("avx2", batchAvx2);
+    return avx2;
+  }
+  BatchFunctions sse2 = GPS_DECODER_BATCH_FUNCTIONS("sse2", batch128);
+#else
+  BatchFunctions sse2 = GPS_DECODER_BATCH_FUNCTIONS("neon", batch128);
+#endif
+  return sse2;
+}
+
+static const BatchFunctions &batchFunctions()
+{
+  static const BatchFunctions functions = selectBatchFunctions();
+  return functions;
+}
+#endif
+
+
+void GpsDecoderClass::distanceBetween(const double *lat1, const double *long1, const double *lat2, const double *long2, double *distances, size_t count)
+{
+#ifdef GPS_DECODER_BATCH_SIMD
+  batchFunctions().distanceDouble(lat1, long1, lat2, long2, distances, count);
+#else
+  for (size_t i = 0; i < count; i++) distances[i] = distanceBetween(lat1[i], long1[i], lat2[i], long2[i]);
+#endif
 }
 
+void GpsDecoderClass::distanceBetween(const float *lat1, const float *long1, const float *lat2, const float *long2, float *distances, size_t count)
+{
+#ifdef GPS_DECODER_BATCH_SIMD
+  batchFunctions().distanceFloat(lat1, long1, lat2, long2, distances, count);
+#else
+  for (size_t i = 0; i < count; i++) distances[i] = (float)distanceBetween(lat1[i], long1[i], lat2[i], long2[i]);
+#endif
+}
 
-// Parse degrees in that funny NMEA format DDMM.MMMM
-void GpsDecoderClass::parseDegrees(const char *term, RawDegreesClass &deg)
+void GpsDecoderClass::courseTo(const double *lat1, const double *long1, const double *lat2, const double *long2, double *courses, size_t count)
 {
-  uint32_t leftOfDecimal = (uint32_t)atol(term);
-  uint16_t minutes = (uint16_t)(leftOfDecimal % 100);
-  uint32_t multiplier = 10000000UL;
-  uint32_t tenMillionthsOfMinutes = minutes * multiplier;
+#ifdef GPS_DECODER_BATCH_SIMD
+  batchFunctions().courseDouble(lat1, long1, lat2, long2, courses, count);
+#else
+  for (size_t i = 0; i < count; i++) courses[i] = courseTo(lat1[i], long1[i], lat2[i], long2[i]);
+#endif
+}
 
-  deg.deg = (int16_t)(leftOfDecimal / 100);
+void GpsDecoderClass::courseTo(const float *lat1, const float *long1, const float *lat2, const float *long2, float *courses, size_t count)
+{
+#ifdef GPS_DECODER_BATCH_SIMD
+  batchFunctions().courseFloat(lat1, long1, lat2, long2, courses, count);
+#else
+  for (size_t i = 0; i < count; i++) courses[i] = (float)courseTo(lat1[i], long1[i], lat2[i], long2[i]);
+#endif
+}
 
-  while (isdigit(*term))
-    ++term;
+const char *GpsDecoderClass::batchKernel()
+{
+#ifdef GPS_DECODER_BATCH_SIMD
+  return batchFunctions().name;
+#else
+  return "scalar";
+#endif
+}
 
-  if (*term == '.')
-    while (isdigit(*++term))
+// Batch from a prepared point, reference is sin and cos of its latitude and longitude, false if there is no kernel
+bool GpsDecoderClass::batchFrom(bool course, const double *reference, const double *lat, const double *lng, double *out, size_t count)
+{
+#ifdef GPS_DECODER_BATCH_SIMD
+  if (course) batchFunctions().courseFrom(reference, NULL, lat, lng, out, count);
+  else batchFunctions().distanceFrom(reference, NULL, lat, lng, out, count);
+  return true;
+#else
+  (void)course; (void)reference; (void)lat; (void)lng; (void)out; (void)count;
+  return false;
+#endif
+}
+#endif
+
+
+// ******************************************************************************************************
+//
+// Fixed point geodesy, no floating point at all
+//
+// Angles are binary angles, 2^32 = 360 deg, so differences wrap around without any check.
+// Sine and cosine are Q30 fixed point, 1.0 = 2^30, calculated with CORDIC. The CORDIC error is
+// below 6e-9, which is 4 cm on earth. The 1e-7 deg input resolution is 1.1 cm.
+//
+// ******************************************************************************************************
+
+
+// returns distance in cm between two positions, both specified as signed latitude
+// and longitude in 1e-7 degrees. Uses the same formula and sphere of radius 6372795 meters
+// as distanceBetween(), so the 0.5% model error stays.
+// Compared to the exact formula on that sphere the error is below 15 cm at any distance.
+uint32_t GpsDecoderClass::distanceBetweenE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2)
+{
+  int32_t sinLat1, cosLat1, sinLat2, cosLat2, sinDLong, cosDLong;
+
+  sinCos(angleFromE7(lat1), sinLat1, cosLat1);
+  sinCos(angleFromE7(lat2), sinLat2, cosLat2);
+  sinCos(angleFromE7(long1) - angleFromE7(long2), sinDLong, cosDLong);
+
+  // Products are Q60, the north and east components are squared in Q30
+  int64_t north = ((int64_t)cosLat1 * sinLat2 - (((int64_t)sinLat1 * cosLat2) >> 30) * cosDLong) >> 30;
+  int64_t east = ((int64_t)cosLat2 * sinDLong) >> 30;
+  int64_t denom = (int64_t)sinLat1 * sinLat2 + (((int64_t)cosLat1 * cosLat2) >> 30) * cosDLong;
+  int64_t delta = (int64_t)sqrtU64((uint64_t)(north * north + east * east)) << 30;
+
+  // Central angle is 0...180 deg, distance = angle * radius. CORDIC ends slightly below 0 for equal positions
+  uint32_t angle = atan2Angle(delta, denom);
+  if (angle > 0xc0000000UL) angle = 0;
+  return (uint32_t)(((uint64_t)angle * 4004145191ULL + 0x80000000UL) >> 32);   // 2 * pi * 6372795 m in cm
+}
+
+
+// returns course in centidegrees (North=0, West=27000) from position 1 to position 2,
+// both specified as signed latitude and longitude in 1e-7 degrees.
+// The error is below 0.03 deg for distances above 100 m and grows with 1/distance below,
+// it is below 0.25 deg above 10 m and about 1 deg at 1 m.
+uint16_t GpsDecoderClass::courseToE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2)
+{
+  int32_t sinLat1, cosLat1, sinLat2, cosLat2, sinDLong, cosDLong;
+
+  sinCos(angleFromE7(lat1), sinLat1, cosLat1);
+  sinCos(angleFromE7(lat2), sinLat2, cosLat2);
+  sinCos(angleFromE7(long2) - angleFromE7(long1), sinDLong, cosDLong);
+
+  // Same formula as courseTo(), products are kept in Q60
+  int64_t y = (int64_t)sinDLong * cosLat2;
+  int64_t x = (int64_t)cosLat1 * sinLat2 - (((int64_t)sinLat1 * cosLat2) >> 30) * cosDLong;
+
+  uint32_t course = (uint32_t)(((uint64_t)atan2Angle(y, x) * 36000 + 0x80000000UL) >> 32);
+  return course >= 36000 ? 0 : (uint16_t)course;
+}
+
+
+// Return course in centidegrees as cardinal
+const char *GpsDecoderClass::cardinalCentidegrees(uint16_t course)
+{
+  return cardinalDirections[((course + 1125UL) / 2250) % 16];
+}
+
+
+// Converts 1e-7 degrees to a binary angle, 2^32 / 3.6e9 in Q30
+uint32_t GpsDecoderClass::angleFromE7(int32_t degreesE7)
+{
+  return (uint32_t)(((int64_t)degreesE7 * 1281023894) >> 30);
+}
+
+
+// Sine and cosine of a binary angle in Q30 by CORDIC in rotation mode
+void GpsDecoderClass::sinCos(uint32_t angle, int32_t &sine, int32_t &cosine)
+{
+  // CORDIC converges only within +-99 deg, so rotate the other half by 180 deg
+  bool flip = (uint32_t)(angle + 0x40000000UL) > 0x80000000UL;
+  int64_t rest = (int64_t)(int32_t)(flip ? angle + 0x80000000UL : angle) << 16;
+  int32_t x = 652032874;                                 // CORDIC gain 0.60725 in Q30
+  int32_t y = 0;
+
+  for (uint8_t i = 0; i < GPS_DECODER_CORDIC_ITERATIONS; i++)
+  {
+    int32_t dx = (x + ((1L << i) >> 1)) >> i;
+    int32_t dy = (y + ((1L << i) >> 1)) >> i;
+
+    if (rest >= 0)
+    {
+      x -= dy;
+      y += dx;
+      rest -= cordicAtan[i];
+    }
+    else
     {
-      multiplier /= 10;
-      tenMillionthsOfMinutes += (*term - '0') * multiplier;
+      x += dy;
+      y -= dx;
+      rest += cordicAtan[i];
     }
+  }
+
+  sine = flip ? -y : y;
+  cosine = flip ? -x : x;
+}
+
+
+// Angle of the vector (x, y) as binary angle by CORDIC in vectoring mode, 0 = x axis
+uint32_t GpsDecoderClass::atan2Angle(int64_t y, int64_t x)
+{
+  int64_t angle = 0;
+
+  if (x == 0 && y == 0) return 0;
+
+  // Rotate into the right half plane, CORDIC converges only within +-99 deg
+  if (x < 0)
+  {
+    x = -x;
+    y = -y;
+    angle = (int64_t)1 << 47;
+  }
+
+  // Scale down to 2^29, so the CORDIC gain of 1.65 can not overflow
+  while (x >= ((int64_t)1 << 29) || y >= ((int64_t)1 << 29) || y <= -((int64_t)1 << 29))
+  {
+    x >>= 1;
+    y >>= 1;
+  }
+
+  int32_t x32 = (int32_t)x;
+  int32_t y32 = (int32_t)y;
+
+  for (uint8_t i = 0; i < GPS_DECODER_CORDIC_ITERATIONS; i++)
+  {
+    int32_t dx = (x32 + ((1L << i) >> 1)) >> i;
+    int32_t dy = (y32 + ((1L << i) >> 1)) >> i;
+
+    if (y32 > 0)
+    {
+      x32 += dy;
+      y32 -= dx;
+      angle += cordicAtan[i];
+    }
+    else
+    {
+      x32 -= dy;
+      y32 += dx;
+      angle -= cordicAtan[i];
+    }
+  }
+
+  return (uint32_t)((angle + 0x8000) >> 16);
+}
+
+
+// Integer square root, bit by bit
+uint32_t GpsDecoderClass::sqrtU64(uint64_t value)
+{
+  uint64_t root = 0;
+  uint64_t bit = (uint64_t)1 << 62;
 
-  deg.billionths = (5 * tenMillionthsOfMinutes + 1) / 3;
-  deg.negative = false;
+  while (bit > value) bit >>= 2;
+
+  while (bit)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+
+  return (uint32_t)root;
 }
+
@@ -21,13 +21,18 @@
 // Includes
 // ******************************************************************
 #include <stdint.h>
+#include <stddef.h>
 #include <stdio.h>
+#include <string.h>
 
 
 // ******************************************************************
 // Defines
 // ******************************************************************
-#define GPS_DECODER_DEBUG
+// Define GPS_DECODER_NO_DEBUG to remove the log output, the tests and benchmarks are built with it
+#ifndef GPS_DECODER_NO_DEBUG
+   #define GPS_DECODER_DEBUG
+#endif
 
 #warning needs to be changed later
 #ifdef GPS_DECODER_DEBUG
@@ -41,6 +46,9 @@
 #warning needs to be removed later
 #define millis()  5
 
+// Define GPS_DECODER_NO_FLOAT for targets without FPU, all values are then only available as integers
+// #define GPS_DECODER_NO_FLOAT
+
 
 #define GPS_DECODER_MPH_PER_KNOT          1.15077945
 #define GPS_DECODER_MPS_PER_KNOT          0.51444444
@@ -48,7 +56,56 @@
 #define GPS_DECODER_MILES_PER_METER       0.00062137112
 #define GPS_DECODER_KM_PER_METER          0.001
 #define GPS_DECODER_FEET_PER_METER        3.2808399
-#define GPS_DECODER_MAX_FIELD_SIZE        200
+#define GPS_DECODER_MAX_FIELD_SIZE        20                  // Longer fields are passed on as empty fields
+#define GPS_DECODER_FIELD_OVERFLOW        0xff
+#define GPS_DECODER_CHECKSUM_INVALID      0xff
+#define GPS_DECODER_MAX_SATELLITES        32                  // Satellites in view per satellite system, 4 per GSV message
+#define GPS_DECODER_CORDIC_ITERATIONS     30                  // Iterations of the fixed point geodesy, ~1e-9 rad
+#define GPS_DECODER_WGS84_A               6378137.0           // Semi-major axis of WGS-84 in meters
+#define GPS_DECODER_WGS84_F               (1 / 298.257223563) // Flattening of WGS-84
+#define GPS_DECODER_MEAN_RADIUS           6371008.8           // Mean earth radius in meters, sphere of DISTANCE_HAVERSINE
+
+// Sentence filter, see setSentenceFilter()
+#define GPS_DECODER_SENTENCE_GGA          0x0001
+#define GPS_DECODER_SENTENCE_RMC          0x0002
+#define GPS_DECODER_SENTENCE_GSA          0x0004
+#define GPS_DECODER_SENTENCE_GSV          0x0008
+#define GPS_DECODER_SENTENCE_VTG          0x0010
+#define GPS_DECODER_SENTENCE_OTHER        0x8000              // All sentences which are not decoded, TXT, GLL, ZDA, ...
+#define GPS_DECODER_SENTENCE_ALL          0xffff
+
+#define GPS_DECODER_TALKER_GP             0x01                // GPS
+#define GPS_DECODER_TALKER_GL             0x02                // GLONASS
+#define GPS_DECODER_TALKER_GA             0x04                // Galileo
+#define GPS_DECODER_TALKER_GB             0x08                // Baidu, GB and BD
+#define GPS_DECODER_TALKER_GN             0x10                // Combination of all used satellite systems
+#define GPS_DECODER_TALKER_OTHER          0x80                // All other and proprietary talkers
+#define GPS_DECODER_TALKER_ALL            0xff
+
+// Values of a fix record and fields of GpsDecoder<Config>
+#define GPS_DECODER_FIELD_LOCATION        0x0001
+#define GPS_DECODER_FIELD_DATE            0x0002
+#define GPS_DECODER_FIELD_TIME            0x0004
+#define GPS_DECODER_FIELD_SPEED           0x0008
+#define GPS_DECODER_FIELD_COURSE          0x0010
+#define GPS_DECODER_FIELD_ALTITUDE        0x0020
+#define GPS_DECODER_FIELD_DOP             0x0040              // hdop, vdop and pdop
+#define GPS_DECODER_FIELD_FIXED_TYPE      0x0080
+#define GPS_DECODER_FIELD_SATELLITES      0x0100              // Active satellites and satellites in view
+#define GPS_DECODER_FIELD_ALL             0xffff
+
+// End of epoch rules, see EpochClass::setRule()
+#define GPS_DECODER_EPOCH_LAST_SENTENCE   0x01                // Epoch ends behind the configured last sentence
+#define GPS_DECODER_EPOCH_TIME_CHANGE     0x02                // Epoch ends when a sentence with an other UTC time arrives
+#define GPS_DECODER_EPOCH_TIMEOUT         0x04                // Epoch ends when no sentence arrived within the timeout
+
+// Sentences and talkers, which can never be enabled at runtime
+#ifndef GPS_DECODER_SENTENCE_MASK
+   #define GPS_DECODER_SENTENCE_MASK      GPS_DECODER_SENTENCE_ALL
+#endif
+#ifndef GPS_DECODER_TALKER_MASK
+   #define GPS_DECODER_TALKER_MASK        GPS_DECODER_TALKER_ALL
+#endif
 
 #define GPS_DECODER_DEG_TO_RAD            0.017453292519943295769236907684886
 #define GPS_DECODER_RAD_TO_DEG            57.295779513082320876798154814105
@@ -62,13 +119,62 @@
 // ******************************************************************
 // Class
 // ******************************************************************
+template <class Config> class GpsDecoder;                      // Template configured variant, see gpsDecoderTemplate.h
+template <class Config> class GpsDecoderLayout;
+
 class GpsDecoderClass
 {
+   template <class Config> friend class GpsDecoder;            // Reuses the parsers and sub classes
+   template <class Config> friend class GpsDecoderLayout;
+   friend class GpsDecoderPipeline;                            // Runs the frame state machine on other threads
+
+   public:
+      struct FixRecord                                         // All values of one receiver epoch, see EpochClass
+      {
+         uint16_t valid;                                       // GPS_DECODER_FIELD_xxx received in this epoch, all others are 0
+         uint16_t sentences;                                   // GPS_DECODER_SENTENCE_xxx received in this epoch
+         uint32_t time;                                        // UTC hhmmsscc
+         uint32_t date;                                        // ddmmyy
+         int32_t latE7, lngE7;                                 // 1e-7 degrees
+         int32_t altitude;                                     // cm
+         int32_t speed;                                        // knots in hundredths
+         int32_t course;                                       // degrees in hundredths
+         int32_t hdop, vdop, pdop;                             // in hundredths
+         uint8_t fixedType;                                    // 1=Nofix, 2=2D, 3=3d
+         uint8_t satellitesUsed;                               // Active satellites of all systems
+         uint8_t satellitesInView;                             // Satellites in view of all systems
+      };
+
+      typedef void (*EventHandler)(GpsDecoderClass &decoder, void *context);   // Handler of a sentence, commit or checksum event
+      typedef void (*EpochHandler)(const FixRecord &record, void *context);     // Handler of a complete epoch
+
    private:
       // Private sub classes
+      class RawDegreesClass;
+      class SentenceClass;
+
+      class FieldClass                                         // Non owning view on the chars of one field, not 0 terminated
+      {
+         friend class GpsDecoderClass;
+
+         public:
+            bool isEmpty() const    { return len == 0; }
+            char first() const      { return len ? str[0] : 0; }
+
+            bool toUnsigned(uint32_t &value) const;                     // "123" -> 123
+            bool toFixed(uint8_t decimals, int32_t &value) const;       // "-1.5" with 2 decimals -> -150
+            bool toTime(uint32_t &value) const;                         // "hhmmss.ss" -> hhmmsscc
+            bool toDate(uint32_t &value) const;                         // "ddmmyy" -> ddmmyy
+            bool toDegrees(RawDegreesClass &deg, uint16_t maxDegrees) const;   // "DDDMM.MMMM" -> degrees and billionths, up to maxDegrees
+
+            const char *str;                                   // First char of the field
+            uint8_t len;                                       // Number of chars in the field
+      };
+
       class IntegerClass
       {
          friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
 
          public:
             bool isValid() const    { return valid; }
@@ -83,28 +189,31 @@ class GpsDecoderClass
             uint32_t lastCommitTime;
             uint32_t val, newval;
             void commit();
-            void set(const char *term);
             void set(uint32_t val);
       };
 
       class DecimalClass
       {
          friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
 
          public:
             bool isValid() const    { return valid; }
             bool isUpdated() const  { return updated; }
             uint32_t age() const    { return valid ? millis() - lastCommitTime : (uint32_t)0xffffffff; }
-            double value()          { updated = false; return val; }
+#ifndef GPS_DECODER_NO_FLOAT
+            double value()          { updated = false; return val / 100.0; }
+#endif
+            int32_t hundredths()    { updated = false; return val; }
 
             DecimalClass();
 
          private:
             bool valid, updated;
             uint32_t lastCommitTime;
-            double val, newval;
+            int32_t val, newval;                               // Fixed point value in hundredths
             void commit();
-            void set(double value);
+            void set(int32_t hundredths);
       };
 
       class AltitudeClass : public DecimalClass
@@ -112,22 +221,37 @@ class GpsDecoderClass
          friend class GpsDecoderClass;
 
          public:
+#ifndef GPS_DECODER_NO_FLOAT
          double meters()       { return value(); }
          double miles()        { return GPS_DECODER_MILES_PER_METER * value(); }
          double kilometers()   { return GPS_DECODER_KM_PER_METER * value(); }
          double feet()         { return GPS_DECODER_FEET_PER_METER * value(); }
+#endif
+         int32_t centimeters() { return hundredths(); }
+      };
+
+      class CourseClass : public DecimalClass
+      {
+         friend class GpsDecoderClass;
+
+         public:
+#ifndef GPS_DECODER_NO_FLOAT
+         double deg()            { return value(); }
+#endif
+         uint16_t centidegrees() { return (uint16_t)hundredths(); }
       };
 
       class DateClass
       {
          friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
 
          private:
             bool valid, updated;
             uint32_t date, newDate;
             uint32_t lastCommitTime;
             void commit();
-            void setDate(const char *term);
+            void setDate(uint32_t ddmmyy);
 
          public:
             bool isValid() const       { return valid; }
@@ -151,19 +275,24 @@ class GpsDecoderClass
             uint16_t deg;
             uint32_t billionths;
             bool negative;
+            int32_t toE7() const;                              // Degrees in 1e-7, deg is at most 180 so it fits
+#ifndef GPS_DECODER_NO_FLOAT
+            double toDegrees() const;                          // Degrees with the full resolution
+#endif
       };
       
       class LocationClass
       {
          friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
 
          private:
             bool valid=false, updated=false;
             RawDegreesClass rawLatData, rawLngData, rawNewLatData, rawNewLngData;
             uint32_t lastCommitTime;
             void commit();
-            void setLatitude(const char *term);
-            void setLongitude(const char *term);
+            void setLatitude(const RawDegreesClass &deg);
+            void setLongitude(const RawDegreesClass &deg);
 
          public:
             bool isValid() const    { return valid; }
@@ -171,31 +300,78 @@ class GpsDecoderClass
             uint32_t age() const    { return valid ? millis() - lastCommitTime : (uint32_t)0xffffffff; }
             const RawDegreesClass &rawLat()     { updated = false; return rawLatData; }
             const RawDegreesClass &rawLng()     { updated = false; return rawLngData; }
+            int32_t latE7();                                   // Latitude in 1e-7 degrees
+            int32_t lngE7();                                   // Longitude in 1e-7 degrees
+#ifndef GPS_DECODER_NO_FLOAT
             double lat();
             double lng();
+#endif
 
             LocationClass();
       };
 
-      class SatelliteSystemClass
+      class SatelliteSystemClass                               // Satellite table of one system, one timestamp for the whole table
       {
          friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
 
-         class satInViewEntry                                  // Contains one entry of a satellite in view list
-         { 
-            public:
-            IntegerClass id;                                   // Number of the satellite
-            IntegerClass elevation;                            // Elevation in 0...90 deg
-            IntegerClass azimuth;                              // Azimuth in 0...359 deg
-            IntegerClass snr;                                  // SNR 0 - 99 dbHz. 0 if unused
-         };
+         public:
+            class SkyViewClass                                 // Satellites in view of one complete GSV sequence
+            {
+               friend class SatelliteSystemClass;
+
+               public:
+                  uint8_t count() const                    { return entries; }                    // Number of satellites in the table
+                  uint8_t satellitesInView() const         { return inView; }                     // Total number reported, can be above the capacity
+                  uint8_t id(uint8_t index) const          { return index < entries ? ids[index] : 0; }
+                  uint8_t elevation(uint8_t index) const   { return index < entries ? elevations[index] : 0; }   // 0...90 deg
+                  uint16_t azimuth(uint8_t index) const    { return index < entries ? azimuths[index] : 0; }     // 0...359 deg
+                  uint8_t snr(uint8_t index) const         { return index < entries ? snrs[index] : 0; }         // 0...99 dbHz, 0 if not tracked
+
+                  SkyViewClass();
+
+               private:
+                  uint8_t entries;                             // Valid entries in the arrays
+                  uint8_t inView;                              // Satellites in view as reported
+                  uint8_t ids[GPS_DECODER_MAX_SATELLITES];
+                  uint8_t elevations[GPS_DECODER_MAX_SATELLITES];
+                  uint8_t snrs[GPS_DECODER_MAX_SATELLITES];
+                  uint16_t azimuths[GPS_DECODER_MAX_SATELLITES];
+                  void clear();
+            };
 
-         private:
+            bool isValid() const    { return valid; }
+            bool isUpdated() const  { return updated; }
+            uint32_t age() const    { return valid ? millis() - lastCommitTime : (uint32_t)0xffffffff; }
 
-         public:
-            IntegerClass listOfActiveSatelliteIds[12];         // List of active satellite ids
-            IntegerClass numberSatellitesInView;               // Total number of satellites in view
-            satInViewEntry listOfSatellitesInView[12];         // List of visible satellites
+            const SkyViewClass &skyView()            { updated = false; return views[front]; }   // Last complete sky view, stays consistent until the next one is complete
+            uint32_t skyViewCount() const            { return skyViewsCompleted; }               // Endless increasing number of complete sky views
+
+            uint8_t count()                          { updated = false; return views[front].count(); }
+            uint8_t satellitesInView() const         { return views[front].satellitesInView(); }
+            uint8_t id(uint8_t index) const          { return views[front].id(index); }
+            uint8_t elevation(uint8_t index) const   { return views[front].elevation(index); }
+            uint16_t azimuth(uint8_t index) const    { return views[front].azimuth(index); }
+            uint8_t snr(uint8_t index) const         { return views[front].snr(index); }
+
+            bool isActive(uint8_t id) const          { return id && ((activeSatellites >> ((id - 1) & 63)) & 1); }
+            uint64_t activeMask() const              { return activeSatellites; }           // Bit (id - 1) % 64 is set for active ids
+            uint8_t activeCount() const;                                                    // Number of satellites used for the fix
+
+            SatelliteSystemClass();
+
+         private:
+            bool valid, updated;
+            uint32_t lastCommitTime;
+            uint64_t activeSatellites;                         // Active set, bit (id - 1) % 64
+            SkyViewClass views[2];                             // Front is read, back is filled by GSV messages
+            uint8_t front;                                     // Index of the front sky view
+            uint8_t nextMessage;                               // Next GSV message of the back sky view, 0 if none is expected
+            uint8_t totalMessages;                             // Number of GSV messages of the back sky view
+            uint32_t skyViewsCompleted;                        // Endless increasing number of complete sky views
+            void commit();
+            void commitGSA(const SentenceClass &sentence);
+            bool commitGSV(const SentenceClass &sentence);     // true if a sky view is complete and flipped to the front
       };
 
       class SatellitesClass
@@ -213,15 +389,19 @@ class GpsDecoderClass
          friend class GpsDecoderClass;
 
          public:
+#ifndef GPS_DECODER_NO_FLOAT
          double knots()    { return value(); }
          double mph()      { return GPS_DECODER_MPH_PER_KNOT * value(); }
          double mps()      { return GPS_DECODER_MPS_PER_KNOT * value(); }
          double kmph()     { return GPS_DECODER_KMPH_PER_KNOT * value(); }
+#endif
+         int32_t mmps()    { return (hundredths() * 1852 + 180) / 360; }   // Millimeters per second, 1 knot = 1852 m/h
       };
 
       class TimeClass
       {
          friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
          public:
             bool isValid() const       { return valid; }
             bool isUpdated() const     { return updated; }
@@ -240,65 +420,408 @@ class GpsDecoderClass
             uint32_t time, newTime;
             uint32_t lastCommitTime;
             void commit();
-            void setTime(const char *term);
+            void setTime(uint32_t hhmmsscc);
+      };
+
+
+      class SentenceClass                                      // Parsed values of one sentence, staged until its checksum has passed
+      {
+         friend class GpsDecoderClass;
+
+         public:
+            bool isValid(uint8_t index) const          { return index < 32 && ((validFields >> index) & 1); }
+            void setValid(uint8_t index, bool valid)   { if (valid && index < 32) validFields |= (uint32_t)1 << index; }
+
+            uint32_t type;                                     // Packed sentence type "RMC", 0 if the identifier is invalid
+            uint16_t talker;                                   // Packed talker "GP"
+            uint32_t validFields;                              // Bit n is set, if field n has been parsed successfully
+
+            uint32_t time;                                     // GGA, RMC: hhmmsscc
+            uint32_t date;                                     // RMC: ddmmyy
+            char status;                                       // RMC: A = valid, VTG: T = true track
+            RawDegreesClass latitude, longitude;               // GGA, RMC
+            int32_t speed;                                     // RMC, VTG: knots in hundredths
+            int32_t course;                                    // VTG: degrees in hundredths
+            int32_t altitude;                                  // GGA: meters in hundredths
+            int32_t pdop, hdop, vdop;                          // GSA: in hundredths
+            uint32_t fixedType;                                // GSA: 1=Nofix, 2=2D, 3=3d
+            uint32_t systemId;                                 // GSA: NMEA 4.1 system id
+            uint8_t activeSatelliteIds[12];                    // GSA
+            uint32_t totalMessages;                            // GSV
+            uint32_t messageNumber;                            // GSV
+            uint32_t satellitesInView;                         // GSV
+            struct
+            {
+               uint8_t id, elevation, snr;
+               uint16_t azimuth;
+            } satellites[4];                                   // GSV
+      };
+
+      class FrameStateClass                                    // State of the frame currently received, separated from the decoded values
+      {
+         friend class GpsDecoderClass;
+         template <class Config> friend class GpsDecoder;
+
+         private:
+            uint8_t calculatedChecksum;                        // On the fly calculated checksum
+            uint8_t receivedChecksum;                          // Checksum received behind the *
+            uint8_t receivedChecksumDigits;                    // Number of received checksum digits or GPS_DECODER_CHECKSUM_INVALID
+            char currentField[GPS_DECODER_MAX_FIELD_SIZE];     // Stores the field currently received, without , -> "5230.5900"
+            uint8_t currentFieldOffset;                        // Current offset in currentField or GPS_DECODER_FIELD_OVERFLOW
+            uint8_t currentFieldIndex;                         // Index of the field currently received, 0 is the sentence identifier
+            bool waitForFrameStart;                            // Wait for frame start
+            bool blockReadChecksumInCalculation;               // Block following read chars, if a * has found in frame
+            SentenceClass currentSentence;                     // Values of the sentence currently received
+
+            void start();                                      // A $ has been received, reset the frame state
+            void addToChecksum(const char *chars, size_t count);   // Xor chars into the calculated checksum
+            void appendToField(const char *chars, size_t count);   // Add ordinary chars to the current field and checksum
+            void readChecksum(char a);                         // Add a char behind the * to the received checksum
+
+         public:
+            FrameStateClass();
+      };
+
+      class EpochClass                                         // Collects the sentences of one receiver epoch into one fix record
+      {
+         friend class GpsDecoderClass;
+
+         public:
+            bool isValid() const    { return valid; }
+            bool isUpdated() const  { return updated; }
+            uint32_t age() const    { return valid ? millis() - lastCommitTime : (uint32_t)0xffffffff; }
+            uint32_t count() const  { return epochCount; }   // Endless increasing number of complete epochs
+
+            bool read(FixRecord &record);                      // Copies the last complete epoch, false if it has been read before
+            void setRule(uint8_t rules, uint16_t lastSentence, uint16_t timeout);   // GPS_DECODER_EPOCH_xxx, GPS_DECODER_SENTENCE_xxx, ms
+
+            EpochClass();
+
+         private:
+            bool valid, updated;
+            uint32_t lastCommitTime;
+            uint32_t epochCount;
+            FixRecord record;                                  // Last complete epoch
+            FixRecord next;                                    // Epoch currently collected, open if any sentence is set
+            EpochHandler handler;                              // Called with every complete epoch, NULL if not registered
+            void *handlerContext;
+            uint32_t lastSentenceTime;                         // millis() of the last sentence of the open epoch
+            uint8_t rules;                                     // GPS_DECODER_EPOCH_xxx
+            uint16_t lastSentence;                             // GPS_DECODER_SENTENCE_xxx which end an epoch
+            uint16_t timeout;                                  // ms without sentence, which end an epoch
+            void begin(const SentenceClass &sentence);
+            void add(const SentenceClass &sentence, const SatellitesClass &satellites);
+            void commit();
+            void checkTimeout();
+      };
+
+
+      enum FrameEvent                                          // Result of the frame state machine, see commitFrame
+      {
+         FRAME_NONE,                                           // Frame is not finished yet, or there is no frame
+         FRAME_SKIPPED,                                        // Sentence or talker is filtered, the rest of the frame is skipped
+         FRAME_NO_CHECKSUM,                                    // \n without *
+         FRAME_INCOMPLETE_CHECKSUM,                            // \n without two checksum digits
+         FRAME_INVALID_CHECKSUM,                               // \n, checksum does not match
+         FRAME_PASSED                                          // \n, checksum passed, the sentence can be committed
       };
 
 
       // parsing state variables
-      uint8_t calculatedChecksum;                                           // On the fly calculated checksum
-      char currentFrame[GPS_DECODER_MAX_FIELD_SIZE];                        // Stores a complete gps frame without $,\r,\n -> "GPRMC,162614,A,5230.5900,N,01322.3900,E,10.0,90.0,131006,1.2,E,A*13"
-      uint8_t currentFrameOffset;                                           // Current offset in currentFrame
-      bool waitForFrameStart;                                               // Wait for frame start
-      bool blockReadChecksumInCalculation;                                  // Block following read chars, if a * has found in frame
+      FrameStateClass frame;                                                // State of the frame currently received
+      uint16_t sentenceFilter;                                              // GPS_DECODER_SENTENCE_xxx bits of the decoded sentences
+      uint8_t talkerFilter;                                                 // GPS_DECODER_TALKER_xxx bits of the decoded talkers
 
       // statistics
       uint32_t decodedCharCount;                                            // Endless increasing number of encoded chars
       uint32_t sentencesWithFixCount;                                       // Endless increasing number of fixed sentences
       uint32_t failedChecksumCount;                                         // Endless increasing number of failed checksum messages
       uint32_t passedChecksumCount;                                         // Endless increasing number of passed checksum messages
+      uint32_t skippedSentenceCount;                                        // Endless increasing number of sentences skipped by the filter
+
+      // event handlers, NULL if not registered
+      EventHandler ggaHandler, rmcHandler, locationHandler, checksumFailureHandler, skyViewHandler;
+      void *ggaContext, *rmcContext, *locationContext, *checksumFailureContext, *skyViewContext;
 
       // internal utilities
-      uint8_t fromHex(char a);                                              // get nibble from ASCII hex "A" -> 10
-      static void parseDegrees(const char *term, RawDegreesClass &deg);     // Parse term into degrees
-      static void strReplace(char *stack, char *needle, char replacement);  // Replace a char in a string with another char
-      static char *strsep(char **stringp, const char *delim);               // WinGW does not have strsep
+      static constexpr uint16_t talkerCode(char a, char b)                  // Packs a talker "GP" into 16 bit
+         { return (uint16_t)(((uint8_t)a << 8) | (uint8_t)b); }
+      static constexpr uint32_t sentenceCode(char a, char b, char c)        // Packs a sentence type "RMC" into 24 bit
+         { return ((uint32_t)(uint8_t)a << 16) | ((uint32_t)(uint8_t)b << 8) | (uint8_t)c; }
+      static uint8_t fromHex(char a);                                       // get nibble from ASCII hex "A" -> 10
+      static bool isFrameChar(char a) { return (uint8_t)(a - 0x20) <= 0x5e; } // Only printable ASCII chars are allowed within a frame
+      static size_t findControlChar(const char *buffer, size_t length);    // Offset of the first $,*,',',\r,\n or binary char in buffer
+      static FieldClass fieldView(const char *chars, size_t count);         // View on the chars of a field, empty if it is too long
+
+      // State machine of decode, shared with GpsDecoder<Config>. Finished fields are passed to scanner.scanField(frame, field)
+      template <class Scanner> static FrameEvent scanChar(FrameStateClass &frame, char currentChar, Scanner &scanner);                          // One char, without counting it
+      template <class Scanner> static FrameEvent scanFrame(FrameStateClass &frame, const char *buffer, size_t length, size_t &used, Scanner &scanner); // Buffer up to the first event
+      FrameEvent scanChar(FrameStateClass &frame, char currentChar) const                                  // State machine of decode with the sentence filter
+         { return scanChar(frame, currentChar, *this); }
+      FrameEvent scanFrame(FrameStateClass &frame, const char *buffer, size_t length, size_t &used) const  // State machine over a buffer with the sentence filter
+         { return scanFrame(frame, buffer, length, used, *this); }
+      FrameEvent scanField(FrameStateClass &frame, const FieldClass &field) const;                        // Parse a field into the current sentence and continue with the next
+      bool commitFrame(FrameEvent event, const FrameStateClass &frame);                                  // Counts, reports and commits a finished frame
+      bool isSentenceEnabled(const SentenceClass &sentence) const;          // Check sentence identifier against the sentence filter
+      static uint16_t sentenceFilterBit(uint32_t type);                     // GPS_DECODER_SENTENCE_xxx bit of a sentence type
+      static uint8_t talkerFilterBit(uint16_t talker);                      // GPS_DECODER_TALKER_xxx bit of a talker
+      void notify(EventHandler handler, void *context)                      // Call an event handler, if it is registered
+         { if (handler) handler(*this, context); }
+      SatelliteSystemClass *satelliteSystemById(uint32_t systemId);         // Satellite system for a NMEA system id or NULL
+      SatelliteSystemClass *satelliteSystemByTalker(uint16_t talker);       // Satellite system for a talker or NULL
+
+      static uint32_t angleFromE7(int32_t degreesE7);                       // 1e-7 degrees -> binary angle, 2^32 = 360 deg
+      static void sinCos(uint32_t angle, int32_t &sine, int32_t &cosine);   // CORDIC sine and cosine of a binary angle in Q30
+      static uint32_t atan2Angle(int64_t y, int64_t x);                     // CORDIC atan2 as binary angle
+      static uint32_t sqrtU64(uint64_t value);                              // Integer square root
+#ifndef GPS_DECODER_NO_FLOAT
+      static bool batchFrom(bool course, const double *reference, const double *lat, const double *lng, double *out, size_t count);   // Kernel of PreparedPointClass batches
+#endif
+
+      static void parseField(SentenceClass &sentence, uint8_t index, const FieldClass &field);     // Parses one field into the staged values of sentence
+      static void parseFieldGGA(SentenceClass &sentence, uint8_t index, const FieldClass &field);  // Subfunction of parseField
+      static void parseFieldRMC(SentenceClass &sentence, uint8_t index, const FieldClass &field);  // Subfunction of parseField
+      static void parseFieldGSA(SentenceClass &sentence, uint8_t index, const FieldClass &field);  // Subfunction of parseField
+      static void parseFieldGSV(SentenceClass &sentence, uint8_t index, const FieldClass &field);  // Subfunction of parseField
+      static void parseFieldVTG(SentenceClass &sentence, uint8_t index, const FieldClass &field);  // Subfunction of parseField
 
-      bool parseFrame();                                                    // Parses a frame and updates sub classes. Returns true, if checksum is valid, else false
-      bool parseFrameGGA(char *frame);                                      // Subfunction of parseFrame
-      bool parseFrameRMC(char *frame);                                      // Subfunction of parseFrame
-      bool parseFrameGSA(char *frame);                                      // Subfunction of parseFrame
-      bool parseFrameGSV(char *frame);                                      // Subfunction of parseFrame
-      bool parseFrameVTG(char *frame);                                      // Subfunction of parseFrame
+      bool commitSentence(const SentenceClass &sentence);                   // Updates sub classes from a sentence, which passed the checksum test
+      bool commitGGA(const SentenceClass &sentence);                        // Subfunction of commitSentence
+      bool commitRMC(const SentenceClass &sentence);                        // Subfunction of commitSentence
+      bool commitGSA(const SentenceClass &sentence);                        // Subfunction of commitSentence
+      bool commitGSV(const SentenceClass &sentence);                        // Subfunction of commitSentence
+      bool commitVTG(const SentenceClass &sentence);                        // Subfunction of commitSentence
 
 
    public:
+#ifndef GPS_DECODER_NO_FLOAT
+      class PreparedPointClass                                 // Position with cached sin and cos, for many distances and courses from one point
+      {
+         friend class GpsDecoderClass;
+
+         public:
+            PreparedPointClass();                              // 0, 0
+            PreparedPointClass(double lat, double lng);
+
+            void set(double lat, double lng);
+            void set(const LocationClass &location);           // Current location of a decoder, does not clear its updated flag
+            double lat() const   { return latitude; }
+            double lng() const   { return longitude; }
+
+            double distanceTo(const PreparedPointClass &point) const;   // As distanceBetween, without any sin and cos
+            double courseTo(const PreparedPointClass &point) const;     // As courseTo from this point, without any sin and cos
+            double distanceTo(double lat, double lng) const;            // Only sin and cos of lat and lng
+            double courseTo(double lat, double lng) const;
+            void distanceTo(const double *lat, const double *lng, double *distances, size_t count) const;   // Batch, see batchKernel()
+            void courseTo(const double *lat, const double *lng, double *courses, size_t count) const;
+            size_t nearest(const PreparedPointClass *points, size_t count, double *distance = NULL) const;   // Index of the nearest point, count if there is none
+
+         private:
+            double latitude, longitude;                        // Degrees
+            double trig[4];                                    // sin(lat), cos(lat), sin(lng), cos(lng)
+            double x, y, z;                                    // Unit vector, nearest() compares chord lengths
+      };
+#endif
+
       GpsDecoderClass();                                                    // Constructor
 
       bool decode(char currentChar);                                        // process one character received from GPS
+      size_t decode(const char *buffer, size_t length);                     // process a buffer received from GPS, returns number of decoded frames
 
       uint32_t charsProcessed()   const { return decodedCharCount; }        // Returns total number of processed chars, since class has been created
       uint32_t sentencesWithFix() const { return sentencesWithFixCount; }   // Returns total number of fixed sentences, since class has been created
       uint32_t failedChecksum()   const { return failedChecksumCount; }     // Returns total number of failed checksum messages
       uint32_t passedChecksum()   const { return passedChecksumCount; }     // Returns total number of failed checksum messages
+      uint32_t skippedSentences() const { return skippedSentenceCount; }    // Returns total number of sentences skipped by the sentence filter
+
+      void setSentenceFilter(uint16_t sentences, uint8_t talkers);          // Only decode these GPS_DECODER_SENTENCE_xxx and GPS_DECODER_TALKER_xxx
+      void currentFix(FixRecord &record) const;                             // Last committed values of all fields, see gpsDecoder.cpp
+
+      void onGGA(EventHandler handler, void *context = NULL);               // Called behind every committed GGA, NULL unregisters
+      void onRMC(EventHandler handler, void *context = NULL);               // Called behind every committed RMC
+      void onLocation(EventHandler handler, void *context = NULL);          // Called behind every location commit and the rest of its sentence
+      void onChecksumFailure(EventHandler handler, void *context = NULL);   // Called with every failed checksum
+      void onSkyView(EventHandler handler, void *context = NULL);           // Called with every complete sky view, the system isUpdated()
+      void onEpoch(EpochHandler handler, void *context = NULL);             // Called with every complete epoch, see EpochClass
+
+#ifndef GPS_DECODER_NO_FLOAT
+      enum DistanceMethod                                      // Accuracy tiers of distanceBetween and courseTo, see gpsDecoder.cpp for the error envelopes
+      {
+         DISTANCE_EQUIRECTANGULAR,                             // Flat with the WGS-84 radii at the mean latitude, for short hops
+         DISTANCE_HAVERSINE,                                   // Sphere of the mean earth radius, 0.57% of the distance
+         DISTANCE_VINCENTY,                                    // WGS-84 ellipsoid, 0.1 mm
+         DISTANCE_AUTO                                         // Cheapest tier within the tolerance, chosen from the position spans
+      };
 
       static double distanceBetween(double lat1, double long1, double lat2, double long2);   // Distance between to coordinates
       static double courseTo(double lat1, double long1, double lat2, double long2);          // CourseClass in degrees between course 1 and 2
       static const char *cardinal(double course);                                            // Converts course to cardinal "N", "NW"
 
+      // Distance in meters and course in degrees with a DistanceMethod, tolerance in meters or degrees is only used by DISTANCE_AUTO
+      static double distanceBetween(double lat1, double long1, double lat2, double long2, DistanceMethod method, double tolerance = 0.0);
+      static double courseTo(double lat1, double long1, double lat2, double long2, DistanceMethod method, double tolerance = 0.0);
+      static DistanceMethod distanceMethod(double lat1, double long1, double lat2, double long2, double tolerance);   // Tier DISTANCE_AUTO takes for a distance
+      static DistanceMethod courseMethod(double lat1, double long1, double lat2, double long2, double tolerance);     // Tier DISTANCE_AUTO takes for a course
+
+      // Batches of distanceBetween and courseTo, out[i] is the result for the positions [i], see batchKernel()
+      static void distanceBetween(const double *lat1, const double *long1, const double *lat2, const double *long2, double *distances, size_t count);
+      static void distanceBetween(const float *lat1, const float *long1, const float *lat2, const float *long2, float *distances, size_t count);
+      static void courseTo(const double *lat1, const double *long1, const double *lat2, const double *long2, double *courses, size_t count);
+      static void courseTo(const float *lat1, const float *long1, const float *lat2, const float *long2, float *courses, size_t count);
+      static const char *batchKernel();                                                      // Kernel used by the batches: "avx512", "avx2", "sse2", "neon" or "scalar"
+#endif
+      static uint32_t distanceBetweenE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2);  // Distance in cm, positions in 1e-7 degrees
+      static uint16_t courseToE7(int32_t lat1, int32_t long1, int32_t lat2, int32_t long2);         // Course in centidegrees, positions in 1e-7 degrees
+      static const char *cardinalCentidegrees(uint16_t course);                                    // Converts course in centidegrees to cardinal
+
       LocationClass location;                                              // Location data
       DateClass date;                                                      // Date data
       TimeClass time;                                                      // Time data
       SpeedClass speed;                                                    // Speed data
-      DecimalClass course;                                                 // Course data
+      CourseClass course;                                                  // Course data
       AltitudeClass altitude;                                              // Altitude data
       SatellitesClass satellites;                                          // Satellites data
       DecimalClass hdop;                                                   // HDOP
       DecimalClass vdop;                                                   // VDOP
       DecimalClass pdop;                                                   // PDOP
       IntegerClass fixedType;                                              // 1=Nofix, 2=2D, 3=3d
+      EpochClass epoch;                                                    // All values of the last complete epoch
 };
 
 
 
+// ******************************************************************
+// Template methods
+// ******************************************************************
+
+// Run the state machine over a buffer, until a frame has been finished or skipped
+// Only the frame state is changed, so it can run on any thread. used is set to the number of processed chars
+template <class Scanner>
+GpsDecoderClass::FrameEvent GpsDecoderClass::scanFrame(FrameStateClass &frame, const char *buffer, size_t length, size_t &used, Scanner &scanner)
+{
+   const char *start = buffer;
+   const char *end = buffer + length;
+   FrameEvent event = FRAME_NONE;
+
+   while (buffer < end && event == FRAME_NONE)
+   {
+      // Outside of a frame only a $ is of interest, so skip everything else in one go
+      if (!frame.waitForFrameStart)
+      {
+         buffer = (const char *)memchr(buffer, '$', end - buffer);
+         if (!buffer)
+         {
+            buffer = end;
+            break;
+         }
+      }
+      // Handle all ordinary chars of a field up to the next char which changes the decoder state
+      else if (!frame.blockReadChecksumInCalculation)
+      {
+         size_t span = findControlChar(buffer, end - buffer);
+         const char *control = buffer + span;
+
+         // Field is complete within the buffer, so parse it right there without copying it
+         if (frame.currentFieldOffset == 0 && control < end && (*control == ',' || *control == '*'))
+         {
+            frame.addToChecksum(buffer, span);
+            event = scanner.scanField(frame, fieldView(buffer, span));
+
+            if (*control == ',')
+            {
+               frame.calculatedChecksum ^= ',';
+            }
+            else
+            {
+               frame.blockReadChecksumInCalculation = true;
+            }
+            buffer = control + 1;
+            continue;
+         }
+
+         frame.appendToField(buffer, span);
+         buffer = control;
+         if (buffer == end) break;
+      }
+
+      // Char changes the decoder state
+      event = scanChar(frame, *buffer++, scanner);
+   }
+
+   used = buffer - start;
+   return event;
+}
+
+
+// Process one char, without counting it
+template <class Scanner>
+GpsDecoderClass::FrameEvent GpsDecoderClass::scanChar(FrameStateClass &frame, char currentChar, Scanner &scanner)
+{
+   // Try to get find a valid sentence in data stream
+   switch(currentChar)
+   {
+      // sentence begin
+      case '$':
+         frame.start();
+      break;
+
+      // Dont care about \r completely
+      case '\r':
+      break;
+
+      // last line
+      case '\n':
+         // if no frame start has been detected earlier break immediately
+         if (!frame.waitForFrameStart) break;
+
+         // Frame now went through, check if * is existend and the checksum is valid
+         frame.waitForFrameStart = false;
+         if (!frame.blockReadChecksumInCalculation) return FRAME_NO_CHECKSUM;
+         if (frame.receivedChecksumDigits != 2) return FRAME_INCOMPLETE_CHECKSUM;
+         if (frame.receivedChecksum != frame.calculatedChecksum) return FRAME_INVALID_CHECKSUM;
+         return FRAME_PASSED;
+      break;
+
+      // ordinary characters
+      default:
+         // if no frame start has been detected earlier break immediately
+         if (!frame.waitForFrameStart) break;
+
+         // Binary garbage is never part of a frame, drop the frame and wait for the next $
+         if (!isFrameChar(currentChar))
+         {
+            frame.waitForFrameStart = false;
+            break;
+         }
+
+         // If a * has been received prior, this is the checksum of the frame
+         if (frame.blockReadChecksumInCalculation)
+         {
+            frame.readChecksum(currentChar);
+         }
+         // * ends the last field and is not in the checksum calculation
+         else if (currentChar == '*')
+         {
+            frame.blockReadChecksumInCalculation = true;
+            return scanner.scanField(frame, fieldView(frame.currentField, frame.currentFieldOffset));
+         }
+         // , ends the current field
+         else if (currentChar == ',')
+         {
+            frame.calculatedChecksum ^= ',';
+            return scanner.scanField(frame, fieldView(frame.currentField, frame.currentFieldOffset));
+         }
+         // Fill up current field
+         else
+         {
+            frame.appendToField(&currentChar, 1);
+         }
+      break;
+   }
+
+   return FRAME_NONE;
+}
+
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,1014 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains a lossless codec for raw NMEA logs, which knows the sentence structure
+///
+/// Only for hosts, not needed and not included on MCUs. The decompressed log is byte exact the
+/// original, including broken sentences and binary garbage between them.
+///
+/// Every line "$<identifier>,<field>,...*HH\r\n" with a correct checksum is split into fields.
+/// Each field is coded against the same field of the previous sentence with the same identifier:
+/// unchanged, empty, number as difference to the previous value or to the previous difference,
+/// or text. The checksum is not stored, it is calculated again. All other lines are stored raw.
+/// Everything is coded with an adaptive binary range coder, the probabilities depend on the
+/// identifier and field index, so a steady 1 Hz log needs only a few bits for most fields.
+///
+/// GpsDecoderArchive::Compressor compressor(writeFile, file);   // Handler gets the compressed bytes
+/// compressor.write(buffer, length);                            // Any pieces of the log
+/// compressor.finish();
+///
+/// GpsDecoderArchive::Decompressor decompressor(writeFile, file);   // Handler gets the original bytes
+/// decompressor.write(compressed, length);                          // Any pieces of the compressed stream
+/// if (!decompressor.finish()) error();                             // Corrupt or incomplete stream
+///
+/// Stream layout: "GPSZ", version 8 bit, blocks of varint size and range coded lines, varint 0.
+/// The probabilities are kept over the blocks, the range coder starts again in every block, so
+/// the decompressor only needs to buffer one block.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_ARCHIVE_H_
+#define GPS_DECODER_ARCHIVE_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_ARCHIVE_BLOCK         (64UL << 10)        // Compressed bytes per block
+#define GPS_DECODER_ARCHIVE_MAX_LINE      1024                // Longer lines are stored raw in pieces
+#define GPS_DECODER_ARCHIVE_FIELDS        32                  // Sentences with more fields are stored raw
+#define GPS_DECODER_ARCHIVE_VERSION       1
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class GpsDecoderArchive
+{
+   private:
+      static const size_t SLOT_BITS = 6;
+      static const size_t SLOTS = 1 << SLOT_BITS;              // Identifiers with own history, the oldest is replaced
+      static const size_t MAX_IDENTIFIER = 15;
+      static const size_t MAX_DIGITS = 18;                     // Longer numbers are text
+      static const size_t HEADER_SIZE = 5;
+
+      enum LineKind                                            // 2 bit, context is the slot of the line in front
+      {
+         LINE_SENTENCE,                                        // Sentence with a known identifier, slot follows
+         LINE_NEW_SENTENCE,                                    // Sentence with a new identifier, identifier follows
+         LINE_RAW,                                             // Raw bytes, up to and including \n
+         LINE_END_OF_BLOCK
+      };
+
+      enum FieldKind                                           // 3 bit, context is slot and field index
+      {
+         FIELD_END,                                            // No more fields
+         FIELD_SAME,                                           // Same chars as the field of the previous sentence
+         FIELD_EMPTY,
+         FIELD_DELTA,                                          // Number in the previous format, value - previous value
+         FIELD_DELTA2,                                         // Number in the previous format, value - previous value - previous difference
+         FIELD_NUMBER,                                         // Number in a new format, format and value - previous value
+         FIELD_TEXT                                            // Length and chars
+      };
+
+      enum Terminator                                          // 2 bit, bit 0 = *HH, bit 1 = \r, always \n
+      {
+         TERMINATOR_LF = 0,
+         TERMINATOR_CHECKSUM = 1,
+         TERMINATOR_CR = 2
+      };
+
+      struct NumberModel                                       // Probabilities of an unsigned number
+      {
+         uint16_t length[128];                                 // Bit length 0..64
+         uint16_t high[65][4];                                 // Two bits behind the leading 1, per bit length
+      };
+
+      struct FieldModel                                        // Probabilities of one field of one slot
+      {
+         uint16_t kind[8];
+         uint16_t negative, dot, integerDigits[32], decimals[32];
+         NumberModel value;
+      };
+
+      struct Format                                            // Layout of a number field "-012.340"
+      {
+         bool negative, dot;
+         uint8_t integerDigits, decimals;
+
+         bool operator==(const Format &other) const
+            { return negative == other.negative && dot == other.dot && integerDigits == other.integerDigits && decimals == other.decimals; }
+      };
+
+      struct FieldState                                        // Last number of one field
+      {
+         bool numeric;
+         Format format;
+         int64_t value;                                        // All digits without the ., negative with -
+         int64_t delta;                                        // Difference of the last two numbers, 0 if there are none
+      };
+
+      struct Slot                                              // History of one identifier
+      {
+         uint8_t identifierLength;
+         char identifier[MAX_IDENTIFIER];
+         uint8_t fieldCount;                                   // Fields of the previous sentence
+         uint16_t fieldStart[GPS_DECODER_ARCHIVE_FIELDS];      // Chars of the previous sentence in text
+         uint8_t fieldLength[GPS_DECODER_ARCHIVE_FIELDS];
+         char text[GPS_DECODER_ARCHIVE_MAX_LINE];
+         FieldState fields[GPS_DECODER_ARCHIVE_FIELDS];
+      };
+
+      struct Sentence                                          // View on a line, which can be coded as sentence
+      {
+         const char *identifier;
+         uint8_t identifierLength;
+         uint8_t fieldCount;
+         const char *field[GPS_DECODER_ARCHIVE_FIELDS];
+         uint8_t fieldLength[GPS_DECODER_ARCHIVE_FIELDS];
+         uint8_t terminator;
+      };
+
+      // Probabilities and history, equal in compressor and decompressor after every line
+      class Model
+      {
+         public:
+            Model() : fields(SLOTS * GPS_DECODER_ARCHIVE_FIELDS), slots(SLOTS)   { reset(); }
+
+            void reset()
+            {
+               initialize(&fields[0], fields.size() * sizeof(FieldModel));
+               initialize(lineKind, sizeof(lineKind));
+               initialize(slotIndex, sizeof(slotIndex));
+               initialize(terminator, sizeof(terminator));
+               initialize(identifierLength, sizeof(identifierLength));
+               initialize(bytes, sizeof(bytes));
+               initialize(&textLength, sizeof(textLength));
+               initialize(&rawLength, sizeof(rawLength));
+               for (size_t i = 0; i < SLOTS; i++) slots[i].identifierLength = 0;
+               slotCount = 0;
+               nextSlot = 0;
+               previousSlot = SLOTS;
+            }
+
+            FieldModel &field(size_t slot, size_t index)   { return fields[slot * GPS_DECODER_ARCHIVE_FIELDS + index]; }
+
+            // Slot of an identifier, SLOTS if it is unknown
+            size_t find(const char *identifier, uint8_t length) const
+            {
+               for (size_t i = 0; i < slotCount; i++)
+               {
+                  if (slots[i].identifierLength == length && memcmp(slots[i].identifier, identifier, length) == 0) return i;
+               }
+               return SLOTS;
+            }
+
+            // Slot for a new identifier, replaces the oldest if all are used
+            size_t add(const char *identifier, uint8_t length)
+            {
+               size_t slot = nextSlot;
+               nextSlot = (nextSlot + 1) % SLOTS;
+               if (slotCount < SLOTS) slotCount++;
+
+               Slot &s = slots[slot];
+               s.identifierLength = length;
+               memcpy(s.identifier, identifier, length);
+               s.fieldCount = 0;
+               memset(s.fields, 0, sizeof(s.fields));
+               return slot;
+            }
+
+            // Remember the fields of a coded sentence
+            void update(size_t slot, const Sentence &sentence)
+            {
+               Slot &s = slots[slot];
+               uint16_t offset = 0;
+
+               for (uint8_t i = 0; i < sentence.fieldCount; i++)
+               {
+                  s.fieldStart[i] = offset;
+                  s.fieldLength[i] = sentence.fieldLength[i];
+                  memcpy(s.text + offset, sentence.field[i], sentence.fieldLength[i]);
+                  offset += sentence.fieldLength[i];
+
+                  FieldState &state = s.fields[i];
+                  Format format;
+                  int64_t value;
+                  if (parseNumber(sentence.field[i], sentence.fieldLength[i], format, value))
+                  {
+                     state.delta = state.numeric ? (int64_t)((uint64_t)value - (uint64_t)state.value) : 0;
+                     state.numeric = true;
+                     state.format = format;
+                     state.value = value;
+                  }
+                  else
+                  {
+                     state.numeric = false;
+                     state.delta = 0;
+                  }
+               }
+               s.fieldCount = sentence.fieldCount;
+               previousSlot = slot;
+            }
+
+            bool isSame(size_t slot, uint8_t index, const char *field, uint8_t length) const
+            {
+               const Slot &s = slots[slot];
+               return index < s.fieldCount && s.fieldLength[index] == length && memcmp(s.text + s.fieldStart[index], field, length) == 0;
+            }
+
+            std::vector<FieldModel> fields;
+            std::vector<Slot> slots;
+            size_t slotCount;                                  // Used slots
+            size_t nextSlot;                                   // Slot for the next new identifier
+            size_t previousSlot;                               // Slot of the line in front, SLOTS for raw lines
+            uint16_t lineKind[SLOTS + 1][4];
+            uint16_t slotIndex[SLOTS + 1][SLOTS];
+            uint16_t terminator[SLOTS][4];
+            uint16_t identifierLength[16];
+            uint16_t bytes[256][256];                          // Chars of text, identifiers and raw lines, context is the char in front
+            NumberModel textLength, rawLength;
+
+         private:
+            static void initialize(void *probabilities, size_t size)
+            {
+               uint16_t *p = (uint16_t *)probabilities;
+               for (size_t i = 0; i < size / sizeof(uint16_t); i++) p[i] = PROBABILITY_ONE / 2;
+            }
+      };
+
+      static const uint32_t PROBABILITY_BITS = 11;
+      static const uint16_t PROBABILITY_ONE = 1 << PROBABILITY_BITS;
+      static const uint8_t ADAPTION_SHIFT = 5;
+      static const uint32_t RANGE_TOP = 1UL << 24;
+
+      class RangeEncoder
+      {
+         public:
+            RangeEncoder()   { reset(); }
+
+            void reset()
+            {
+               out.clear();
+               low = 0;
+               range = 0xffffffff;
+               cache = 0;
+               cacheSize = 1;
+            }
+
+            void bit(uint16_t &probability, uint32_t value)
+            {
+               uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+               if (!value)
+               {
+                  range = bound;
+                  probability += (PROBABILITY_ONE - probability) >> ADAPTION_SHIFT;
+               }
+               else
+               {
+                  low += bound;
+                  range -= bound;
+                  probability -= probability >> ADAPTION_SHIFT;
+               }
+               normalize();
+            }
+
+            void directBits(uint64_t value, uint8_t count)
+            {
+               while (count--)
+               {
+                  range >>= 1;
+                  if ((value >> count) & 1) low += range;
+                  normalize();
+               }
+            }
+
+            // Bits of value, highest first, probabilities has 1 << bits entries
+            void tree(uint16_t *probabilities, uint8_t bits, uint32_t value)
+            {
+               uint32_t m = 1;
+               while (bits--)
+               {
+                  uint32_t b = (value >> bits) & 1;
+                  bit(probabilities[m], b);
+                  m = (m << 1) | b;
+               }
+            }
+
+            void number(NumberModel &model, uint64_t value)
+            {
+               uint8_t length = 0;
+               while (length < 64 && (value >> length)) length++;
+
+               tree(model.length, 7, length);
+               if (length > 1)
+               {
+                  uint8_t rest = length - 1;
+                  uint8_t high = rest < 2 ? rest : 2;
+                  tree(model.high[length], high, (uint32_t)(value >> (rest - high)) & ((1 << high) - 1));
+                  directBits(value, rest - high);
+               }
+            }
+
+            void flush()
+            {
+               for (int i = 0; i < 5; i++) shiftLow();
+            }
+
+            std::vector<uint8_t> out;
+
+         private:
+            uint64_t low;
+            uint32_t range;
+            uint8_t cache;
+            uint64_t cacheSize;
+
+            void normalize()
+            {
+               while (range < RANGE_TOP)
+               {
+                  range <<= 8;
+                  shiftLow();
+               }
+            }
+
+            void shiftLow()
+            {
+               if ((uint32_t)low < 0xff000000 || (low >> 32) != 0)
+               {
+                  uint8_t carry = (uint8_t)(low >> 32);
+                  uint8_t temp = cache;
+                  do
+                  {
+                     out.push_back((uint8_t)(temp + carry));
+                     temp = 0xff;
+                  } while (--cacheSize != 0);
+                  cache = (uint8_t)(low >> 24);
+               }
+               cacheSize++;
+               low = (low & 0x00ffffff) << 8;
+            }
+      };
+
+      class RangeDecoder
+      {
+         public:
+            RangeDecoder(const uint8_t *data, size_t length) : read(data), end(data + length), range(0xffffffff), code(0), overrun(false)
+            {
+               for (int i = 0; i < 5; i++) code = (code << 8) | next();
+            }
+
+            uint32_t bit(uint16_t &probability)
+            {
+               uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+               uint32_t value;
+               if (code < bound)
+               {
+                  range = bound;
+                  probability += (PROBABILITY_ONE - probability) >> ADAPTION_SHIFT;
+                  value = 0;
+               }
+               else
+               {
+                  code -= bound;
+                  range -= bound;
+                  probability -= probability >> ADAPTION_SHIFT;
+                  value = 1;
+               }
+               normalize();
+               return value;
+            }
+
+            uint64_t directBits(uint8_t count)
+            {
+               uint64_t value = 0;
+               while (count--)
+               {
+                  range >>= 1;
+                  uint32_t b = code >= range;
+                  if (b) code -= range;
+                  value = (value << 1) | b;
+                  normalize();
+               }
+               return value;
+            }
+
+            uint32_t tree(uint16_t *probabilities, uint8_t bits)
+            {
+               uint32_t m = 1;
+               for (uint8_t i = 0; i < bits; i++) m = (m << 1) | bit(probabilities[m]);
+               return m - (1U << bits);
+            }
+
+            // false if the bit length is invalid
+            bool number(NumberModel &model, uint64_t &value)
+            {
+               uint8_t length = (uint8_t)tree(model.length, 7);
+               if (length > 64) return false;
+
+               value = length ? 1 : 0;
+               if (length > 1)
+               {
+                  uint8_t rest = length - 1;
+                  uint8_t high = rest < 2 ? rest : 2;
+                  value = (value << high) | tree(model.high[length], high);
+                  value = (value << (rest - high)) | directBits(rest - high);
+               }
+               return true;
+            }
+
+            bool isOverrun() const   { return overrun; }   // More bytes read than the block has
+
+         private:
+            const uint8_t *read, *end;
+            uint32_t range, code;
+            bool overrun;
+
+            uint8_t next()
+            {
+               if (read < end) return *read++;
+               overrun = true;
+               return 0;
+            }
+
+            void normalize()
+            {
+               while (range < RANGE_TOP)
+               {
+                  range <<= 8;
+                  code = (code << 8) | next();
+               }
+            }
+      };
+
+   public:
+      typedef void (*OutputHandler)(const uint8_t *data, size_t length, void *context);   // Gets the output in pieces
+
+      class Compressor
+      {
+         public:
+            Compressor(OutputHandler handler, void *context = NULL) : handler(handler), context(context), headerWritten(false), blockLines(0), inputBytes(0), outputBytes(0) {}
+
+            // Compress any piece of the log
+            void write(const char *data, size_t length)
+            {
+               writeHeader();
+               inputBytes += length;
+
+               while (length)
+               {
+                  const char *newLine = (const char *)memchr(data, '\n', length);
+                  size_t lineLength = newLine ? (size_t)(newLine - data) + 1 : length;
+
+                  if (pending.empty() && newLine && lineLength <= GPS_DECODER_ARCHIVE_MAX_LINE)
+                  {
+                     // Whole line in the input, no copy
+                     line(data, lineLength);
+                  }
+                  else
+                  {
+                     size_t space = GPS_DECODER_ARCHIVE_MAX_LINE - pending.size();
+                     if (lineLength > space) lineLength = space;
+                     pending.insert(pending.end(), data, data + lineLength);
+
+                     if (pending.size() == GPS_DECODER_ARCHIVE_MAX_LINE || pending.back() == '\n')
+                     {
+                        line(&pending[0], pending.size());
+                        pending.clear();
+                     }
+                  }
+                  data += lineLength;
+                  length -= lineLength;
+               }
+            }
+
+            // Compress a line without \n at the end and write the end of the stream
+            void finish()
+            {
+               writeHeader();
+               if (!pending.empty())
+               {
+                  line(&pending[0], pending.size());
+                  pending.clear();
+               }
+               if (blockLines) writeBlock();
+
+               uint8_t end = 0;
+               output(&end, 1);
+            }
+
+            uint64_t bytesIn() const    { return inputBytes; }    // Bytes of the log
+            uint64_t bytesOut() const   { return outputBytes; }   // Bytes of the compressed stream
+
+         private:
+            OutputHandler handler;
+            void *context;
+            bool headerWritten;
+            size_t blockLines;                                 // Lines in the current block
+            uint64_t inputBytes, outputBytes;
+            std::vector<char> pending;                         // Start of a line, which is not complete yet
+            Model model;
+            RangeEncoder encoder;
+
+            void output(const uint8_t *data, size_t length)
+            {
+               outputBytes += length;
+               handler(data, length, context);
+            }
+
+            void writeHeader()
+            {
+               if (headerWritten) return;
+
+               uint8_t header[HEADER_SIZE] = { 'G', 'P', 'S', 'Z', GPS_DECODER_ARCHIVE_VERSION };
+               output(header, sizeof(header));
+               headerWritten = true;
+            }
+
+            void writeBlock()
+            {
+               encoder.tree(model.lineKind[model.previousSlot], 2, LINE_END_OF_BLOCK);
+               encoder.flush();
+
+               uint8_t size[10];
+               size_t used = 0;
+               for (size_t value = encoder.out.size(); ; value >>= 7)
+               {
+                  size[used++] = (uint8_t)(value >= 0x80 ? (value & 0x7f) | 0x80 : value);
+                  if (value < 0x80) break;
+               }
+               output(size, used);
+               output(&encoder.out[0], encoder.out.size());
+
+               encoder.reset();
+               blockLines = 0;
+            }
+
+            void line(const char *data, size_t length)
+            {
+               Sentence sentence;
+               if (split(data, length, sentence)) compressSentence(sentence);
+               else compressRaw(data, length);
+
+               blockLines++;
+               if (encoder.out.size() >= GPS_DECODER_ARCHIVE_BLOCK) writeBlock();
+            }
+
+            void compressRaw(const char *data, size_t length)
+            {
+               encoder.tree(model.lineKind[model.previousSlot], 2, LINE_RAW);
+               encoder.number(model.rawLength, length - 1);
+               compressChars(data, length, 0);
+               model.previousSlot = SLOTS;
+            }
+
+            void compressChars(const char *data, size_t length, uint8_t previous)
+            {
+               for (size_t i = 0; i < length; i++)
+               {
+                  encoder.tree(model.bytes[previous], 8, (uint8_t)data[i]);
+                  previous = (uint8_t)data[i];
+               }
+            }
+
+            void compressSentence(const Sentence &sentence)
+            {
+               size_t slot = model.find(sentence.identifier, sentence.identifierLength);
+               if (slot < SLOTS)
+               {
+                  encoder.tree(model.lineKind[model.previousSlot], 2, LINE_SENTENCE);
+                  encoder.tree(model.slotIndex[model.previousSlot], SLOT_BITS, (uint32_t)slot);
+               }
+               else
+               {
+                  encoder.tree(model.lineKind[model.previousSlot], 2, LINE_NEW_SENTENCE);
+                  encoder.tree(model.identifierLength, 4, sentence.identifierLength);
+                  compressChars(sentence.identifier, sentence.identifierLength, '$');
+                  slot = model.add(sentence.identifier, sentence.identifierLength);
+               }
+
+               for (uint8_t i = 0; i < sentence.fieldCount; i++) compressField(slot, i, sentence.field[i], sentence.fieldLength[i]);
+               encoder.tree(model.field(slot, sentence.fieldCount < GPS_DECODER_ARCHIVE_FIELDS ? sentence.fieldCount : 0).kind, 3, FIELD_END);
+               encoder.tree(model.terminator[slot], 2, sentence.terminator);
+
+               model.update(slot, sentence);
+            }
+
+            void compressField(size_t slot, uint8_t index, const char *field, uint8_t length)
+            {
+               FieldModel &m = model.field(slot, index);
+               const FieldState &state = model.slots[slot].fields[index];
+               Format format;
+               int64_t value;
+
+               if (model.isSame(slot, index, field, length))
+               {
+                  encoder.tree(m.kind, 3, FIELD_SAME);
+               }
+               else if (length == 0)
+               {
+                  encoder.tree(m.kind, 3, FIELD_EMPTY);
+               }
+               else if (parseNumber(field, length, format, value))
+               {
+                  int64_t delta = (int64_t)((uint64_t)value - (uint64_t)state.value);
+                  if (state.numeric && state.format == format)
+                  {
+                     int64_t delta2 = (int64_t)((uint64_t)delta - (uint64_t)state.delta);
+                     if (state.delta && magnitude(delta2) < magnitude(delta))
+                     {
+                        encoder.tree(m.kind, 3, FIELD_DELTA2);
+                        encoder.number(m.value, zigzag(delta2));
+                     }
+                     else
+                     {
+                        encoder.tree(m.kind, 3, FIELD_DELTA);
+                        encoder.number(m.value, zigzag(delta));
+                     }
+                  }
+                  else
+                  {
+                     encoder.tree(m.kind, 3, FIELD_NUMBER);
+                     encoder.bit(m.negative, format.negative);
+                     encoder.bit(m.dot, format.dot);
+                     encoder.tree(m.integerDigits, 5, format.integerDigits);
+                     encoder.tree(m.decimals, 5, format.decimals);
+                     encoder.number(m.value, zigzag(state.numeric ? delta : value));
+                  }
+               }
+               else
+               {
+                  encoder.tree(m.kind, 3, FIELD_TEXT);
+                  encoder.number(model.textLength, length);
+                  compressChars(field, length, ',');
+               }
+            }
+      };
+
+      class Decompressor
+      {
+         public:
+            Decompressor(OutputHandler handler, void *context = NULL) : handler(handler), context(context), headerRead(false), ended(false), failed(false) {}
+
+            // Decompress any piece of the compressed stream, returns false if it is corrupt
+            bool write(const uint8_t *data, size_t length)
+            {
+               if (failed) return false;
+               if (ended && length)
+               {
+                  failed = true;
+                  return false;
+               }
+
+               input.insert(input.end(), data, data + length);
+
+               size_t used = 0;
+               if (!headerRead)
+               {
+                  if (input.size() < HEADER_SIZE) return true;
+                  if (memcmp(&input[0], "GPSZ", 4) != 0 || input[4] != GPS_DECODER_ARCHIVE_VERSION)
+                  {
+                     failed = true;
+                     return false;
+                  }
+                  headerRead = true;
+                  used = HEADER_SIZE;
+               }
+
+               while (!ended && used < input.size())
+               {
+                  // Varint block size, a block is never much larger than GPS_DECODER_ARCHIVE_BLOCK
+                  uint64_t size = 0;
+                  size_t sizeBytes = 0;
+                  bool complete = false;
+                  while (!complete && used + sizeBytes < input.size() && sizeBytes < 4)
+                  {
+                     uint8_t byte = input[used + sizeBytes];
+                     size |= (uint64_t)(byte & 0x7f) << (7 * sizeBytes);
+                     complete = !(byte & 0x80);
+                     sizeBytes++;
+                  }
+                  if (size > 4 * GPS_DECODER_ARCHIVE_BLOCK || (!complete && sizeBytes == 4))
+                  {
+                     failed = true;
+                     break;
+                  }
+                  if (!complete) break;
+                  if (size == 0)
+                  {
+                     ended = true;
+                     used += sizeBytes;
+                     break;
+                  }
+                  if (input.size() - used - sizeBytes < size) break;
+
+                  if (!decompressBlock(&input[used + sizeBytes], (size_t)size))
+                  {
+                     failed = true;
+                     break;
+                  }
+                  used += sizeBytes + (size_t)size;
+               }
+
+               input.erase(input.begin(), input.begin() + used);
+               if (ended && !input.empty()) failed = true;
+               return !failed;
+            }
+
+            // true if the whole stream has been decompressed without error
+            bool finish() const   { return headerRead && ended && !failed; }
+
+         private:
+            OutputHandler handler;
+            void *context;
+            bool headerRead, ended, failed;
+            std::vector<uint8_t> input;                        // Start of a block, which is not complete yet
+            std::vector<char> output;                          // Lines of the current block
+            Model model;
+
+            bool decompressBlock(const uint8_t *data, size_t length)
+            {
+               RangeDecoder decoder(data, length);
+
+               output.clear();
+               for (;;)
+               {
+                  uint32_t kind = decoder.tree(model.lineKind[model.previousSlot], 2);
+                  if (kind == LINE_END_OF_BLOCK) break;
+
+                  bool ok;
+                  if (kind == LINE_RAW) ok = decompressRaw(decoder);
+                  else ok = decompressSentence(decoder, kind == LINE_NEW_SENTENCE);
+
+                  if (!ok || decoder.isOverrun()) return false;
+               }
+               if (decoder.isOverrun()) return false;
+
+               if (!output.empty()) handler((const uint8_t *)&output[0], output.size(), context);
+               return true;
+            }
+
+            bool decompressRaw(RangeDecoder &decoder)
+            {
+               uint64_t length;
+               if (!decoder.number(model.rawLength, length) || length >= GPS_DECODER_ARCHIVE_MAX_LINE) return false;
+
+               decompressChars(decoder, (size_t)length + 1, 0);
+               model.previousSlot = SLOTS;
+               return true;
+            }
+
+            void decompressChars(RangeDecoder &decoder, size_t length, uint8_t previous)
+            {
+               for (size_t i = 0; i < length; i++)
+               {
+                  previous = (uint8_t)decoder.tree(model.bytes[previous], 8);
+                  output.push_back((char)previous);
+               }
+            }
+
+            bool decompressSentence(RangeDecoder &decoder, bool newIdentifier)
+            {
+               size_t begin = output.size();
+               size_t slot;
+
+               output.push_back('$');
+               if (newIdentifier)
+               {
+                  uint8_t length = (uint8_t)decoder.tree(model.identifierLength, 4);
+                  if (length == 0) return false;
+                  decompressChars(decoder, length, '$');
+                  slot = model.add(&output[begin + 1], length);
+               }
+               else
+               {
+                  slot = decoder.tree(model.slotIndex[model.previousSlot], SLOT_BITS);
+                  if (slot >= model.slotCount) return false;
+                  const Slot &s = model.slots[slot];
+                  output.insert(output.end(), s.identifier, s.identifier + s.identifierLength);
+               }
+
+               // Field chars are appended to output, the views are made when they are complete
+               size_t fieldStart[GPS_DECODER_ARCHIVE_FIELDS];
+               Sentence sentence;
+               sentence.fieldCount = 0;
+
+               for (;;)
+               {
+                  uint8_t index = sentence.fieldCount;
+                  FieldModel &m = model.field(slot, index < GPS_DECODER_ARCHIVE_FIELDS ? index : 0);
+                  uint32_t kind = decoder.tree(m.kind, 3);
+                  if (kind == FIELD_END) break;
+                  if (index == GPS_DECODER_ARCHIVE_FIELDS || decoder.isOverrun()) return false;
+
+                  output.push_back(',');
+                  fieldStart[index] = output.size();
+                  if (!decompressField(decoder, slot, index, kind, m)) return false;
+
+                  size_t length = output.size() - fieldStart[index];
+                  if (output.size() - begin > GPS_DECODER_ARCHIVE_MAX_LINE || length > 0xff) return false;
+                  sentence.fieldLength[index] = (uint8_t)length;
+                  sentence.fieldCount++;
+               }
+
+               uint8_t terminator = (uint8_t)decoder.tree(model.terminator[slot], 2);
+               if (terminator & TERMINATOR_CHECKSUM)
+               {
+                  static const char hex[] = "0123456789ABCDEF";
+                  uint8_t checksum = 0;
+                  for (size_t i = begin + 1; i < output.size(); i++) checksum ^= (uint8_t)output[i];
+                  output.push_back('*');
+                  output.push_back(hex[checksum >> 4]);
+                  output.push_back(hex[checksum & 15]);
+               }
+               if (terminator & TERMINATOR_CR) output.push_back('\r');
+               output.push_back('\n');
+               if (output.size() - begin > GPS_DECODER_ARCHIVE_MAX_LINE) return false;
+
+               for (uint8_t i = 0; i < sentence.fieldCount; i++) sentence.field[i] = &output[fieldStart[i]];
+               model.update(slot, sentence);
+               return true;
+            }
+
+            bool decompressField(RangeDecoder &decoder, size_t slot, uint8_t index, uint32_t kind, FieldModel &m)
+            {
+               const Slot &s = model.slots[slot];
+               const FieldState &state = s.fields[index];
+               Format format;
+               uint64_t code;
+               int64_t value;
+
+               switch (kind)
+               {
+                  case FIELD_SAME:
+                     if (index >= s.fieldCount) return false;
+                     output.insert(output.end(), s.text + s.fieldStart[index], s.text + s.fieldStart[index] + s.fieldLength[index]);
+                     return true;
+
+                  case FIELD_EMPTY:
+                     return true;
+
+                  case FIELD_DELTA:
+                  case FIELD_DELTA2:
+                     if (!state.numeric || !decoder.number(m.value, code)) return false;
+                     value = (int64_t)((uint64_t)state.value + (uint64_t)unzigzag(code));
+                     if (kind == FIELD_DELTA2) value = (int64_t)((uint64_t)value + (uint64_t)state.delta);
+                     return printNumber(state.format, value);
+
+                  case FIELD_NUMBER:
+                     format.negative = decoder.bit(m.negative) != 0;
+                     format.dot = decoder.bit(m.dot) != 0;
+                     format.integerDigits = (uint8_t)decoder.tree(m.integerDigits, 5);
+                     format.decimals = (uint8_t)decoder.tree(m.decimals, 5);
+                     if (!decoder.number(m.value, code)) return false;
+                     value = unzigzag(code);
+                     if (state.numeric) value = (int64_t)((uint64_t)value + (uint64_t)state.value);
+                     return printNumber(format, value);
+
+                  case FIELD_TEXT:
+                     if (!decoder.number(model.textLength, code) || code == 0 || code > 0xff) return false;
+                     decompressChars(decoder, (size_t)code, ',');
+                     return true;
+               }
+               return false;
+            }
+
+            // Append a number in a format, false if it does not fit
+            bool printNumber(const Format &format, int64_t value)
+            {
+               uint8_t digits = format.integerDigits + format.decimals;
+               if (digits == 0 || digits > MAX_DIGITS || (format.decimals && !format.dot)) return false;
+               if (value < 0 ? !format.negative : (format.negative && value != 0)) return false;
+
+               uint64_t absolute = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+               char text[MAX_DIGITS];
+               for (uint8_t i = digits; i > 0; i--)
+               {
+                  text[i - 1] = (char)('0' + absolute % 10);
+                  absolute /= 10;
+               }
+               if (absolute) return false;
+
+               if (format.negative) output.push_back('-');
+               output.insert(output.end(), text, text + format.integerDigits);
+               if (format.dot) output.push_back('.');
+               output.insert(output.end(), text + format.integerDigits, text + digits);
+               return true;
+            }
+      };
+
+   private:
+      // Split a line into identifier and fields, false if it has to be stored raw
+      static bool split(const char *line, size_t length, Sentence &sentence)
+      {
+         if (length < 3 || line[0] != '$' || line[length - 1] != '\n') return false;
+
+         size_t end = length - 1;
+         sentence.terminator = TERMINATOR_LF;
+         if (line[end - 1] == '\r')
+         {
+            sentence.terminator |= TERMINATOR_CR;
+            end--;
+         }
+
+         // Printable chars, at most one * and only in front of the checksum
+         uint8_t checksum = 0;
+         size_t star = end;
+         for (size_t i = 1; i < end; i++)
+         {
+            uint8_t c = (uint8_t)line[i];
+            if ((uint8_t)(c - 0x20) > 0x5e) return false;
+            if (c == '*')
+            {
+               star = i;
+               break;
+            }
+            checksum ^= c;
+         }
+         if (star < end)
+         {
+            static const char hex[] = "0123456789ABCDEF";
+            if (star + 3 != end || line[star + 1] != hex[checksum >> 4] || line[star + 2] != hex[checksum & 15]) return false;
+            sentence.terminator |= TERMINATOR_CHECKSUM;
+         }
+
+         const char *read = line + 1;
+         const char *stop = line + star;
+         const char *comma = (const char *)memchr(read, ',', stop - read);
+         const char *identifierEnd = comma ? comma : stop;
+         if (identifierEnd == read || identifierEnd - read > (ptrdiff_t)MAX_IDENTIFIER) return false;
+
+         sentence.identifier = read;
+         sentence.identifierLength = (uint8_t)(identifierEnd - read);
+         sentence.fieldCount = 0;
+
+         while (comma)
+         {
+            read = comma + 1;
+            comma = (const char *)memchr(read, ',', stop - read);
+            const char *fieldEnd = comma ? comma : stop;
+            if (sentence.fieldCount == GPS_DECODER_ARCHIVE_FIELDS || fieldEnd - read > 0xff) return false;
+
+            sentence.field[sentence.fieldCount] = read;
+            sentence.fieldLength[sentence.fieldCount] = (uint8_t)(fieldEnd - read);
+            sentence.fieldCount++;
+         }
+         return true;
+      }
+
+      // "-012.340" -> -12340, false if the field is no number of up to MAX_DIGITS digits
+      static bool parseNumber(const char *field, uint8_t length, Format &format, int64_t &value)
+      {
+         uint8_t i = 0;
+         uint64_t digits = 0;
+
+         format.negative = length && field[0] == '-';
+         format.dot = false;
+         format.integerDigits = 0;
+         format.decimals = 0;
+         if (format.negative) i++;
+
+         for (; i < length; i++)
+         {
+            char c = field[i];
+            if (c == '.' && !format.dot)
+            {
+               format.dot = true;
+               continue;
+            }
+            if (c < '0' || c > '9' || format.integerDigits + format.decimals == MAX_DIGITS) return false;
+
+            digits = digits * 10 + (uint64_t)(c - '0');
+            if (format.dot) format.decimals++;
+            else format.integerDigits++;
+         }
+         if (format.integerDigits + format.decimals == 0) return false;
+
+         value = format.negative ? -(int64_t)digits : (int64_t)digits;
+         return true;
+      }
+
+      static uint64_t zigzag(int64_t value)     { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+      static int64_t unzigzag(uint64_t value)   { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+      static uint64_t magnitude(int64_t value)  { return value < 0 ? 0 - (uint64_t)value : (uint64_t)value; }
+};
+
+
+
+
+#endif
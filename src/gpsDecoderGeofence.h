@@ -0,0 +1,480 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains a geofence engine with enter, exit and dwell events for polygons and circles
+///
+/// Only for hosts, not needed and not included on MCUs. The fences are indexed in a packed uniform
+/// grid: cells of GPS_DECODER_GEOFENCE_CELL 1e-7 degrees, each with the fences it touches, sorted by
+/// cell in one array. Every fence of a cell is marked, if the cell is completely inside of it.
+/// A fix checks only the fences of its cell, and those which cover the cell without any
+/// point in polygon test. The fences of the cell are looked up again only when a fix leaves the cell.
+/// Fences spanning more than GPS_DECODER_GEOFENCE_MAX_CELLS cells are checked with every fix.
+///
+/// GpsDecoderGeofence fences;
+/// fences.addPolygon(17, lats, lngs, 5);                      // Depot 17, corners in 1e-7 degrees
+/// fences.addCircle(18, 500159000, 82491000, 150.0, 30000);   // 150 m around a gate, dwell after 5 minutes
+/// fences.onEvent(handler, &context);
+/// decoder.onLocation(GpsDecoderGeofence::onLocation, &fences);   // Or onEpoch with publish
+///
+/// Polygons are plane in degrees, so edges follow the lines of constant latitude and longitude. Circles
+/// are flat around their center, like DISTANCE_EQUIRECTANGULAR, for radii up to some km. Fences
+/// must not cross +-180 degrees longitude, split them there. Time is centiseconds since 01.01.2000 UTC,
+/// see GpsDecoderTrack::timestamp. A fence is dwelled once per visit, at the first fix at least its
+/// dwell time behind the enter.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_GEOFENCE_H_
+#define GPS_DECODER_GEOFENCE_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "gpsDecoderTrack.h"
+#include <algorithm>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_GEOFENCE_CELL         100000              // Default cell size in 1e-7 degrees, 0.01 deg ~ 1.1 km
+#define GPS_DECODER_GEOFENCE_MAX_CELLS    4096                // Larger fences are not put into the grid
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class GpsDecoderGeofence
+{
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      enum EventType
+      {
+         GEOFENCE_ENTER,                                       // First fix inside of the fence
+         GEOFENCE_EXIT,                                        // First fix outside again
+         GEOFENCE_DWELL                                        // Inside for the dwell time of the fence
+      };
+
+      struct Event
+      {
+         EventType type;
+         uint32_t id;                                          // Id of the fence
+         uint64_t time;                                        // Time of the fix, centiseconds since 01.01.2000 UTC
+         int32_t latE7, lngE7;                                 // Position of the fix
+      };
+
+      typedef void (*EventHandler)(const Event &event, void *context);
+
+      GpsDecoderGeofence(int32_t cellSizeE7 = GPS_DECODER_GEOFENCE_CELL) :
+         cellSize(cellSizeE7), dirty(false), generation(0), currentCell(NO_CELL), candidatesBegin(0), candidatesEnd(0),
+         lastLocationTime(0), handler(NULL), handlerContext(NULL) {}
+
+      // Polygon of count corners in 1e-7 degrees, closed from the last to the first corner, returns false below 3 corners
+      // dwell in centiseconds, 0 for no dwell event
+      bool addPolygon(uint32_t id, const int32_t *latE7, const int32_t *lngE7, size_t count, uint64_t dwell = 0)
+      {
+         if (count < 3) return false;
+
+         Fence fence = newFence(id, dwell);
+         fence.first = (uint32_t)(corners.size() / 2);
+         fence.count = (uint32_t)count;
+         fence.minLat = fence.maxLat = latE7[0];
+         fence.minLng = fence.maxLng = lngE7[0];
+         for (size_t i = 0; i < count; i++)
+         {
+            corners.push_back(latE7[i]);
+            corners.push_back(lngE7[i]);
+            fence.minLat = std::min(fence.minLat, latE7[i]);
+            fence.maxLat = std::max(fence.maxLat, latE7[i]);
+            fence.minLng = std::min(fence.minLng, lngE7[i]);
+            fence.maxLng = std::max(fence.maxLng, lngE7[i]);
+         }
+         addFence(fence);
+         return true;
+      }
+
+      // Circle of radius meters around a center in 1e-7 degrees, returns false for radius <= 0
+      bool addCircle(uint32_t id, int32_t latE7, int32_t lngE7, double radius, uint64_t dwell = 0)
+      {
+         if (!(radius > 0.0)) return false;
+
+         // Meters per 1e-7 degrees with the radii of curvature of WGS-84 at the center, see DISTANCE_EQUIRECTANGULAR
+         const double e2 = GPS_DECODER_WGS84_F * (2 - GPS_DECODER_WGS84_F);
+         double lat = radians(latE7 * 1e-7);
+         double w2 = 1 - e2 * sq(sin(lat));
+         double primeVertical = GPS_DECODER_WGS84_A / sqrt(w2);
+
+         Fence fence = newFence(id, dwell);
+         fence.lat = latE7;
+         fence.lng = lngE7;
+         fence.radius2 = sq(radius);
+         fence.scaleLat = radians(1e-7) * primeVertical * (1 - e2) / w2;
+         fence.scaleLng = radians(1e-7) * primeVertical * cos(lat);
+
+         // Box with 1% margin, over all longitudes close to the poles
+         double deltaLat = 1.01 * radius / fence.scaleLat;
+         double deltaLng = fence.scaleLng > 0.0 ? 1.01 * radius / fence.scaleLng : HUGE_VAL;
+         fence.minLat = (int32_t)std::max(floor(latE7 - deltaLat), -900000000.0);
+         fence.maxLat = (int32_t)std::min(ceil(latE7 + deltaLat), 900000000.0);
+         fence.minLng = (int32_t)std::max(floor(lngE7 - deltaLng), -1800000000.0);
+         fence.maxLng = (int32_t)std::min(ceil(lngE7 + deltaLng), 1800000000.0);
+         if (fence.minLat == -900000000 || fence.maxLat == 900000000)
+         {
+            fence.minLng = -1800000000;
+            fence.maxLng = 1800000000;
+         }
+         addFence(fence);
+         return true;
+      }
+
+      // Remove all fences, the next fix is outside of all fences without exit events
+      void clear()
+      {
+         fences.clear();
+         states.clear();
+         corners.clear();
+         cells.clear();
+         cellStarts.clear();
+         entries.clear();
+         largeFences.clear();
+         inside.clear();
+         dirty = false;
+         currentCell = NO_CELL;
+         candidatesBegin = candidatesEnd = 0;
+      }
+
+      size_t size() const   { return fences.size(); }
+
+      void onEvent(EventHandler eventHandler, void *context = NULL)
+      {
+         handler = eventHandler;
+         handlerContext = context;
+      }
+
+      // Index the fences, done by the next fix after fences were added
+      void build()
+      {
+         std::vector<std::pair<uint64_t, uint32_t> > marks;   // Cell and fence with the inside mark
+         std::vector<uint8_t> touched;
+
+         largeFences.clear();
+         for (uint32_t index = 0; index < fences.size(); index++)
+         {
+            const Fence &fence = fences[index];
+            int64_t row0 = row(fence.minLat), row1 = row(fence.maxLat);
+            int64_t col0 = column(fence.minLng), col1 = column(fence.maxLng);
+            int64_t rows = row1 - row0 + 1, cols = col1 - col0 + 1;
+            if (rows * cols > GPS_DECODER_GEOFENCE_MAX_CELLS)
+            {
+               largeFences.push_back(index);
+               continue;
+            }
+
+            if (fence.count) touchedCells(fence, row0, col0, rows, cols, touched);
+            for (int64_t r = 0; r < rows; r++)
+            {
+               for (int64_t c = 0; c < cols; c++)
+               {
+                  int64_t minLat = cellLat(row0 + r), minLng = cellLng(col0 + c);
+                  bool partial, full;
+                  if (fence.count)
+                  {
+                     // Cells without an edge are completely inside or outside
+                     partial = touched[r * cols + c] != 0;
+                     full = !partial && containsPolygon(fence, minLat + cellSize / 2, minLng + cellSize / 2);
+                  }
+                  else circleCell(fence, minLat, minLng, partial, full);
+
+                  if (partial || full) marks.push_back(std::make_pair(key(row0 + r, col0 + c), index | (full ? FULL : 0)));
+               }
+            }
+         }
+
+         std::sort(marks.begin(), marks.end());
+         cells.clear();
+         cellStarts.clear();
+         entries.clear();
+         entries.reserve(marks.size());
+         for (size_t i = 0; i < marks.size(); i++)
+         {
+            if (cells.empty() || cells.back() != marks[i].first)
+            {
+               cells.push_back(marks[i].first);
+               cellStarts.push_back((uint32_t)i);
+            }
+            entries.push_back(marks[i].second);
+         }
+         cellStarts.push_back((uint32_t)entries.size());
+
+         dirty = false;
+         currentCell = NO_CELL;
+      }
+
+      // Check a fix against all fences and call the event handler, exits come in front of enters
+      void update(uint64_t time, int32_t latE7, int32_t lngE7)
+      {
+         if (dirty) build();
+         generation++;
+
+         // Candidates are looked up only when the fix leaves the cell
+         uint64_t cell = key(row(latE7), column(lngE7));
+         if (cell != currentCell)
+         {
+            size_t found = std::lower_bound(cells.begin(), cells.end(), cell) - cells.begin();
+            currentCell = cell;
+            candidatesBegin = candidatesEnd = 0;
+            if (found < cells.size() && cells[found] == cell)
+            {
+               candidatesBegin = cellStarts[found];
+               candidatesEnd = cellStarts[found + 1];
+            }
+         }
+
+         current.clear();
+         for (uint32_t i = candidatesBegin; i < candidatesEnd; i++)
+         {
+            uint32_t index = entries[i] & ~FULL;
+            if ((entries[i] & FULL) || contains(fences[index], latE7, lngE7)) mark(index);
+         }
+         for (size_t i = 0; i < largeFences.size(); i++)
+         {
+            if (contains(fences[largeFences[i]], latE7, lngE7)) mark(largeFences[i]);
+         }
+
+         for (size_t i = 0; i < inside.size(); i++)
+         {
+            State &state = states[inside[i]];
+            if (state.seen == generation) continue;
+            state.inside = false;
+            notify(GEOFENCE_EXIT, inside[i], time, latE7, lngE7);
+         }
+         for (size_t i = 0; i < current.size(); i++)
+         {
+            State &state = states[current[i]];
+            if (!state.inside)
+            {
+               state.inside = true;
+               state.dwelled = false;
+               state.enterTime = time;
+               notify(GEOFENCE_ENTER, current[i], time, latE7, lngE7);
+            }
+            else if (!state.dwelled && fences[current[i]].dwell && time >= state.enterTime + fences[current[i]].dwell)
+            {
+               state.dwelled = true;
+               notify(GEOFENCE_DWELL, current[i], time, latE7, lngE7);
+            }
+         }
+         inside.swap(current);
+      }
+
+      // Check the position of a record, returns false if it has no date, time or location
+      bool update(const FixRecord &record)
+      {
+         uint64_t time = GpsDecoderTrack::timestamp(record);
+         if (!time || !(record.valid & GPS_DECODER_FIELD_LOCATION)) return false;
+
+         update(time, record.latE7, record.lngE7);
+         return true;
+      }
+
+      // Append the ids of all fences, the last fix is inside of, returns their number
+      size_t insideIds(std::vector<uint32_t> &ids) const
+      {
+         for (size_t i = 0; i < inside.size(); i++) ids.push_back(fences[inside[i]].id);
+         return inside.size();
+      }
+
+      // Location handler, context is the geofence, see GpsDecoderClass::onLocation
+      // A position right behind midnight is moved to the next day, see GpsDecoderTrack::locationTime
+      static void onLocation(GpsDecoderClass &decoder, void *geofence)
+      {
+         GpsDecoderGeofence *self = static_cast<GpsDecoderGeofence *>(geofence);
+         uint64_t time = GpsDecoderTrack::locationTime(decoder, self->lastLocationTime);
+         if (time == 0) return;
+
+         self->lastLocationTime = time;
+         self->update(time, decoder.location.latE7(), decoder.location.lngE7());
+      }
+
+      // Epoch handler, context is the geofence, see GpsDecoderClass::onEpoch
+      static void publish(const FixRecord &record, void *geofence)   { static_cast<GpsDecoderGeofence *>(geofence)->update(record); }
+
+   private:
+      static const uint32_t FULL = 0x80000000;                // Entry mark, the cell is completely inside of the fence
+      static const uint64_t NO_CELL = ~(uint64_t)0;
+
+      struct Fence
+      {
+         uint32_t id;
+         uint32_t first, count;                                // Corners of a polygon, count is 0 for a circle
+         int32_t minLat, maxLat, minLng, maxLng;               // Box
+         int32_t lat, lng;                                     // Center of a circle
+         double radius2;                                       // Square of the radius in meters
+         double scaleLat, scaleLng;                            // Meters per 1e-7 degrees at the center
+         uint64_t dwell;                                       // Centiseconds, 0 for no dwell event
+      };
+
+      struct State
+      {
+         uint64_t enterTime;
+         uint32_t seen;                                        // Generation of the last fix inside
+         bool inside, dwelled;
+      };
+
+      int32_t cellSize;
+      std::vector<Fence> fences;
+      std::vector<State> states;                               // Per fence
+      std::vector<int32_t> corners;                            // lat, lng of all polygons
+      std::vector<uint64_t> cells;                             // Sorted cells with fences
+      std::vector<uint32_t> cellStarts;                        // First entry of every cell, one more for the end
+      std::vector<uint32_t> entries;                           // Fence index with the FULL mark
+      std::vector<uint32_t> largeFences;                       // Not in the grid
+      std::vector<uint32_t> inside, current;                   // Fences of the last and of this fix
+      bool dirty;                                              // Fences were added behind build()
+      uint32_t generation;                                     // Number of the fix
+      uint64_t currentCell;
+      uint32_t candidatesBegin, candidatesEnd;                 // Entries of currentCell
+      uint64_t lastLocationTime;                               // Time of the last onLocation
+      EventHandler handler;
+      void *handlerContext;
+
+      Fence newFence(uint32_t id, uint64_t dwell) const
+      {
+         Fence fence;
+         memset(&fence, 0, sizeof(fence));
+         fence.id = id;
+         fence.dwell = dwell;
+         return fence;
+      }
+
+      void addFence(const Fence &fence)
+      {
+         State state = { 0, 0, false, false };
+         fences.push_back(fence);
+         states.push_back(state);
+         dirty = true;
+      }
+
+      int64_t row(int32_t latE7) const      { return ((int64_t)latE7 + 900000000) / cellSize; }
+      int64_t column(int32_t lngE7) const   { return ((int64_t)lngE7 + 1800000000) / cellSize; }
+      int64_t cellLat(int64_t r) const      { return r * cellSize - 900000000; }
+      int64_t cellLng(int64_t c) const      { return c * cellSize - 1800000000; }
+      static uint64_t key(int64_t r, int64_t c)   { return ((uint64_t)r << 32) | (uint64_t)c; }
+
+      void mark(uint32_t index)
+      {
+         states[index].seen = generation;
+         current.push_back(index);
+      }
+
+      void notify(EventType type, uint32_t index, uint64_t time, int32_t latE7, int32_t lngE7)
+      {
+         if (!handler) return;
+
+         Event event = { type, fences[index].id, time, latE7, lngE7 };
+         handler(event, handlerContext);
+      }
+
+      bool contains(const Fence &fence, int64_t latE7, int64_t lngE7) const
+      {
+         if (latE7 < fence.minLat || latE7 > fence.maxLat || lngE7 < fence.minLng || lngE7 > fence.maxLng) return false;
+         if (!fence.count) return sq((latE7 - fence.lat) * fence.scaleLat) + sq((lngE7 - fence.lng) * fence.scaleLng) <= fence.radius2;
+         return containsPolygon(fence, latE7, lngE7);
+      }
+
+      // Crossing number, exact in 64 bit
+      bool containsPolygon(const Fence &fence, int64_t latE7, int64_t lngE7) const
+      {
+         const int32_t *corner = &corners[2 * fence.first];
+         bool in = false;
+
+         for (uint32_t i = 0, j = fence.count - 1; i < fence.count; j = i++)
+         {
+            int64_t latI = corner[2 * i], lngI = corner[2 * i + 1];
+            int64_t latJ = corner[2 * j], lngJ = corner[2 * j + 1];
+            if ((latI > latE7) == (latJ > latE7)) continue;
+
+            // lng left of the edge at lat, (lng - lngI) < (lat - latI) * (lngJ - lngI) / (latJ - latI)
+            int64_t left = (lngE7 - lngI) * (latJ - latI);
+            int64_t right = (latE7 - latI) * (lngJ - lngI);
+            if (latJ > latI ? left < right : left > right) in = !in;
+         }
+         return in;
+      }
+
+      // Marks the cells of the box, which any edge of the polygon touches
+      void touchedCells(const Fence &fence, int64_t row0, int64_t col0, int64_t rows, int64_t cols, std::vector<uint8_t> &touched) const
+      {
+         const int32_t *corner = &corners[2 * fence.first];
+
+         touched.assign((size_t)(rows * cols), 0);
+         for (uint32_t i = 0, j = fence.count - 1; i < fence.count; j = i++)
+         {
+            int64_t latA = corner[2 * j], lngA = corner[2 * j + 1];
+            int64_t latB = corner[2 * i], lngB = corner[2 * i + 1];
+            int64_t r0 = row((int32_t)std::min(latA, latB)) - row0, r1 = row((int32_t)std::max(latA, latB)) - row0;
+            int64_t c0 = column((int32_t)std::min(lngA, lngB)) - col0, c1 = column((int32_t)std::max(lngA, lngB)) - col0;
+
+            for (int64_t r = r0; r <= r1; r++)
+            {
+               for (int64_t c = c0; c <= c1; c++)
+               {
+                  if (touched[r * cols + c]) continue;
+                  if (edgeTouchesCell(latA, lngA, latB, lngB, cellLat(row0 + r), cellLng(col0 + c))) touched[r * cols + c] = 1;
+               }
+            }
+         }
+      }
+
+      // Edge crosses or touches the closed cell, whose boxes overlap, if the corners are not all on one side of it
+      bool edgeTouchesCell(int64_t latA, int64_t lngA, int64_t latB, int64_t lngB, int64_t minLat, int64_t minLng) const
+      {
+         int sides = 0;
+
+         for (int k = 0; k < 4; k++)
+         {
+            int64_t lat = minLat + ((k & 1) ? cellSize : 0);
+            int64_t lng = minLng + ((k & 2) ? cellSize : 0);
+
+            // Sign of the cross product, the products are compared, their difference could overflow
+            int64_t first = (lng - lngA) * (latB - latA);
+            int64_t second = (lat - latA) * (lngB - lngA);
+            if (first == second) return true;
+            sides |= first > second ? 1 : 2;
+         }
+         return sides == 3;
+      }
+
+      // Circle against the cell with its nearest point and its farthest corner
+      void circleCell(const Fence &fence, int64_t minLat, int64_t minLng, bool &partial, bool &full) const
+      {
+         int64_t maxLat = minLat + cellSize, maxLng = minLng + cellSize;
+         int64_t nearLat = std::max(minLat, std::min<int64_t>(fence.lat, maxLat));
+         int64_t nearLng = std::max(minLng, std::min<int64_t>(fence.lng, maxLng));
+         int64_t farLat = std::max(fence.lat - minLat, maxLat - fence.lat);
+         int64_t farLng = std::max(fence.lng - minLng, maxLng - fence.lng);
+
+         double nearest = sq((nearLat - fence.lat) * fence.scaleLat) + sq((nearLng - fence.lng) * fence.scaleLng);
+         double farthest = sq(farLat * fence.scaleLat) + sq(farLng * fence.scaleLng);
+         full = farthest <= fence.radius2;
+         partial = !full && nearest <= fence.radius2;
+      }
+};
+
+
+
+
+#endif
@@ -0,0 +1,360 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains a time indexed history of positions with range and interpolation queries
+///
+/// Only for hosts, not needed and not included on MCUs. Positions are kept sorted by time in
+/// leaves of up to GPS_DECODER_HISTORY_LEAF entries, an index holds the first time of every leaf.
+/// Positions in time order are appended to the last leaf, late positions are inserted into
+/// their leaf, which is split when it is full. Lookups are a binary search over the index and
+/// one in the leaf, a range scan is O(log n + k).
+///
+/// GpsDecoderHistory history;
+/// decoder.onLocation(GpsDecoderHistory::onLocation, &history);   // Or onEpoch with publish
+/// ...
+/// history.range(from, to, positions);                        // All positions in [from, to]
+/// history.positionAt(time, position);                        // Interpolated between the neighbours
+/// history.save("truck17.track");                             // Track file, see gpsDecoderTrack.h
+///
+/// GpsDecoderTrack::Reader reader;                            // Same queries on the file, without loading it
+/// reader.open("truck17.track");
+/// GpsDecoderHistory::range(reader, from, to, positions);
+///
+/// Time is centiseconds since 01.01.2000 UTC, see GpsDecoderTrack::timestamp. A position with
+/// the time of an existing one replaces it.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_HISTORY_H_
+#define GPS_DECODER_HISTORY_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "gpsDecoderTrack.h"
+#include <algorithm>
+#include <stdint.h>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_HISTORY_LEAF          256                 // Positions per leaf
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class GpsDecoderHistory
+{
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      struct Entry
+      {
+         uint64_t time;                                        // Centiseconds since 01.01.2000 UTC
+         int32_t latE7, lngE7;                                 // 1e-7 degrees
+      };
+
+      GpsDecoderHistory() : count(0), lastLocationTime(0) {}
+
+      // Add a position in any order, a position with the same time is replaced
+      void add(uint64_t time, int32_t latE7, int32_t lngE7)
+      {
+         Entry entry = { time, latE7, lngE7 };
+
+         // In time order, only the last leaf is touched
+         if (leaves.empty() || time > leaves.back().back().time)
+         {
+            if (leaves.empty() || leaves.back().size() == GPS_DECODER_HISTORY_LEAF)
+            {
+               leaves.push_back(std::vector<Entry>());
+               leaves.back().reserve(GPS_DECODER_HISTORY_LEAF);
+               firstTimes.push_back(time);
+            }
+            leaves.back().push_back(entry);
+            count++;
+            return;
+         }
+
+         // Late position, insert it into its leaf
+         size_t leaf = findLeaf(time);
+         std::vector<Entry> &entries = leaves[leaf];
+         std::vector<Entry>::iterator position = std::lower_bound(entries.begin(), entries.end(), time, isBefore);
+         if (position != entries.end() && position->time == time)
+         {
+            *position = entry;
+            return;
+         }
+         entries.insert(position, entry);
+         firstTimes[leaf] = entries.front().time;
+         count++;
+
+         if (entries.size() > GPS_DECODER_HISTORY_LEAF)
+         {
+            // Split in halves, so late positions in the same area do not split again right away
+            std::vector<Entry> upper(entries.begin() + entries.size() / 2, entries.end());
+            entries.resize(entries.size() / 2);
+            upper.reserve(GPS_DECODER_HISTORY_LEAF);
+            firstTimes.insert(firstTimes.begin() + leaf + 1, upper.front().time);
+            leaves.insert(leaves.begin() + leaf + 1, std::vector<Entry>());
+            leaves[leaf + 1].swap(upper);
+         }
+      }
+
+      // Add the position of a record, returns false if it has no date, time or location
+      bool add(const FixRecord &record)
+      {
+         uint64_t time = GpsDecoderTrack::timestamp(record);
+         if (!time || !(record.valid & GPS_DECODER_FIELD_LOCATION)) return false;
+
+         add(time, record.latE7, record.lngE7);
+         return true;
+      }
+
+      void clear()
+      {
+         leaves.clear();
+         firstTimes.clear();
+         count = 0;
+         lastLocationTime = 0;
+      }
+
+      size_t size() const   { return count; }
+
+      // Append all positions in [from, to] in time order to positions, returns their number
+      size_t range(uint64_t from, uint64_t to, std::vector<Entry> &positions) const
+      {
+         size_t found = 0;
+         size_t leaf, index;
+
+         for (lowerBound(from, leaf, index); leaf < leaves.size(); leaf++, index = 0)
+         {
+            const std::vector<Entry> &entries = leaves[leaf];
+            for (; index < entries.size(); index++)
+            {
+               if (entries[index].time > to) return found;
+               positions.push_back(entries[index]);
+               found++;
+            }
+         }
+         return found;
+      }
+
+      // Position at a time, linear between the positions in front and behind
+      // Returns false outside of the history or if the positions are more than maxGap apart, 0 is no limit
+      bool positionAt(uint64_t time, Entry &position, uint64_t maxGap = 0) const
+      {
+         size_t leaf, index;
+
+         lowerBound(time, leaf, index);
+         if (leaf == leaves.size()) return false;
+
+         const Entry &behind = leaves[leaf][index];
+         if (behind.time == time)
+         {
+            position = behind;
+            return true;
+         }
+         if (leaf == 0 && index == 0) return false;
+
+         const Entry &front = index ? leaves[leaf][index - 1] : leaves[leaf - 1].back();
+         return interpolate(front, behind, time, maxGap, position);
+      }
+
+      // Write all positions in time order into a track file, returns false on error
+      bool save(const char *path) const
+      {
+         GpsDecoderTrack::Writer writer;
+         if (!writer.open(path)) return false;
+
+         FixRecord record;
+         memset(&record, 0, sizeof(record));
+         record.valid = GPS_DECODER_FIELD_DATE | GPS_DECODER_FIELD_TIME | GPS_DECODER_FIELD_LOCATION;
+
+         for (size_t leaf = 0; leaf < leaves.size(); leaf++)
+         {
+            for (size_t i = 0; i < leaves[leaf].size(); i++)
+            {
+               const Entry &entry = leaves[leaf][i];
+               GpsDecoderTrack::dateTime(entry.time, record.date, record.time);
+               record.latE7 = entry.latE7;
+               record.lngE7 = entry.lngE7;
+               writer.append(record);
+            }
+         }
+         return writer.close();
+      }
+
+      // Add all positions of a track file, returns false on error
+      bool load(const char *path)
+      {
+         GpsDecoderTrack::Reader reader;
+         std::vector<FixRecord> records;
+
+         if (!reader.open(path)) return false;
+         for (size_t block = 0; block < reader.blocks(); block++)
+         {
+            if (!reader.readBlock(block, records)) return false;
+            for (size_t i = 0; i < records.size(); i++) add(records[i]);
+         }
+         return true;
+      }
+
+      // Range query on a track file in time order, like range(), returns the number of appended positions
+      static size_t range(const GpsDecoderTrack::Reader &reader, uint64_t from, uint64_t to, std::vector<Entry> &positions)
+      {
+         size_t found = 0;
+         std::vector<FixRecord> records;
+         GpsDecoderTrack::BlockInfo info;
+
+         for (size_t block = reader.seek(from); block < reader.blocks(); block++)
+         {
+            if (!reader.blockInfo(block, info) || info.minTime > to) break;
+            if (!reader.readBlock(block, records)) break;
+
+            for (size_t i = 0; i < records.size(); i++)
+            {
+               Entry entry;
+               if (!toEntry(records[i], entry) || entry.time < from) continue;
+               if (entry.time > to) return found;
+               positions.push_back(entry);
+               found++;
+            }
+         }
+         return found;
+      }
+
+      // Interpolated position on a track file in time order, like positionAt()
+      static bool positionAt(const GpsDecoderTrack::Reader &reader, uint64_t time, Entry &position, uint64_t maxGap = 0)
+      {
+         std::vector<FixRecord> records;
+         Entry front = Entry(), entry;
+         bool hasFront = false;
+
+         // The position in front can be the last one of the block in front
+         size_t block = reader.seek(time);
+         if (block > 0 && reader.readBlock(block - 1, records))
+         {
+            for (size_t i = 0; i < records.size(); i++)
+            {
+               if (toEntry(records[i], entry) && entry.time < time)
+               {
+                  front = entry;
+                  hasFront = true;
+               }
+            }
+         }
+
+         for (; block < reader.blocks(); block++)
+         {
+            if (!reader.readBlock(block, records)) return false;
+
+            for (size_t i = 0; i < records.size(); i++)
+            {
+               if (!toEntry(records[i], entry)) continue;
+               if (entry.time == time)
+               {
+                  position = entry;
+                  return true;
+               }
+               if (entry.time > time) return hasFront && interpolate(front, entry, time, maxGap, position);
+               front = entry;
+               hasFront = true;
+            }
+         }
+         return false;
+      }
+
+      // Location handler, context is the history, see GpsDecoderClass::onLocation
+      // A position right behind midnight is moved to the next day, see GpsDecoderTrack::locationTime
+      static void onLocation(GpsDecoderClass &decoder, void *history)
+      {
+         GpsDecoderHistory *self = static_cast<GpsDecoderHistory *>(history);
+         uint64_t time = GpsDecoderTrack::locationTime(decoder, self->lastLocationTime);
+         if (time == 0) return;
+
+         self->lastLocationTime = time;
+         self->add(time, decoder.location.latE7(), decoder.location.lngE7());
+      }
+
+      // Epoch handler, context is the history, see GpsDecoderClass::onEpoch
+      static void publish(const FixRecord &record, void *history)   { static_cast<GpsDecoderHistory *>(history)->add(record); }
+
+   private:
+      std::vector<std::vector<Entry> > leaves;                 // Sorted, no leaf is empty
+      std::vector<uint64_t> firstTimes;                        // Index, first time of every leaf
+      size_t count;
+      uint64_t lastLocationTime;                               // Time of the last onLocation
+
+      static bool isBefore(const Entry &entry, uint64_t time)   { return entry.time < time; }
+
+      // Leaf, which holds or would hold time
+      size_t findLeaf(uint64_t time) const
+      {
+         size_t leaf = std::upper_bound(firstTimes.begin(), firstTimes.end(), time) - firstTimes.begin();
+         return leaf ? leaf - 1 : 0;
+      }
+
+      // First entry at or behind time, leaf is leaves.size() if there is none
+      void lowerBound(uint64_t time, size_t &leaf, size_t &index) const
+      {
+         if (leaves.empty())
+         {
+            leaf = index = 0;
+            return;
+         }
+
+         leaf = findLeaf(time);
+         const std::vector<Entry> &entries = leaves[leaf];
+         index = std::lower_bound(entries.begin(), entries.end(), time, isBefore) - entries.begin();
+         if (index == entries.size())
+         {
+            leaf++;
+            index = 0;
+         }
+      }
+
+      static bool toEntry(const FixRecord &record, Entry &entry)
+      {
+         entry.time = GpsDecoderTrack::timestamp(record);
+         entry.latE7 = record.latE7;
+         entry.lngE7 = record.lngE7;
+         return entry.time && (record.valid & GPS_DECODER_FIELD_LOCATION);
+      }
+
+      // Linear between front and behind, the longitude takes the short way over +-180 degrees
+      static bool interpolate(const Entry &front, const Entry &behind, uint64_t time, uint64_t maxGap, Entry &position)
+      {
+         uint64_t gap = behind.time - front.time;
+         if (maxGap && gap > maxGap) return false;
+
+         double fraction = (double)(time - front.time) / (double)gap;
+         int64_t lngDelta = (int64_t)behind.lngE7 - front.lngE7;
+         if (lngDelta > 1800000000) lngDelta -= 3600000000LL;
+         if (lngDelta < -1800000000) lngDelta += 3600000000LL;
+
+         int64_t lng = front.lngE7 + (int64_t)(lngDelta * fraction);
+         if (lng > 1800000000) lng -= 3600000000LL;
+         if (lng < -1800000000) lng += 3600000000LL;
+
+         position.time = time;
+         position.latE7 = front.latE7 + (int32_t)(((int64_t)behind.latE7 - front.latE7) * fraction);
+         position.lngE7 = (int32_t)lng;
+         return true;
+      }
+};
+
+
+
+
+#endif
@@ -0,0 +1,333 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains a pipeline, which parses the sentences of one stream on several threads
+///
+/// Only for hosts with threads, not needed and not included on MCUs. For a single stream with a
+/// high rate, many GSV lines at 25 Hz, one core running decode() can become the bottleneck.
+///
+/// The pipeline splits decode() into three stages:
+/// - Framing, in the calling thread: collects the stream into batches of about
+///   GPS_DECODER_PIPELINE_BATCH bytes. A batch is cut behind its last complete line, so the
+///   next one starts in front of a $ or behind a \n, where the frame state machine starts over
+///   anyway. Only the last $ of a batch is searched, the bytes are copied once.
+/// - Parsing, on the worker threads: runs the frame state machine of the decoder over a whole
+///   batch, checks the checksums and keeps the event and frame state of every finished frame.
+/// - Commit, in the calling thread: hands over the frames of the parsed batches to the decoder
+///   in stream order, counts, calls the handlers and updates the sub classes and the epoch.
+///
+/// Batches are handed over in a ring of slots without locks. Workers only sleep on a lock, if
+/// there is no batch to parse, the calling thread only, if the oldest batch is not parsed yet.
+///
+/// The decoder is only changed by the calling thread, in exactly the same order as by decode(),
+/// so all values, counters and handler calls are identical to the serial decoder. They are
+/// delayed by up to one batch, flush() commits everything received so far.
+///
+/// GpsDecoderClass gps;
+/// GpsDecoderPipeline pipeline(gps);                          // One parser per core
+/// pipeline.decode(bytes, length);                            // Commits all batches parsed so far
+/// pipeline.flush();                                          // Commits all complete lines
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_PIPELINE_H_
+#define GPS_DECODER_PIPELINE_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_PIPELINE_BATCH        16384               // Bytes per batch, about 200 lines
+#define GPS_DECODER_PIPELINE_SLOTS        32                  // Batches in flight between framing and commit
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class GpsDecoderPipeline
+{
+   public:
+      // Starts the parser threads, 0 = one per core
+      // The decoder must not be used otherwise and its sentence filter must not be changed, while the pipeline exists
+      explicit GpsDecoderPipeline(GpsDecoderClass &decoder, size_t parsers = 0) :
+         decoder(decoder), framed(0), claimed(0), committed(0), sleepingParsers(0), commitWaiting(false), stop(false)
+      {
+         if (parsers == 0) parsers = std::thread::hardware_concurrency();
+         if (parsers == 0) parsers = 1;
+
+         for (size_t i = 0; i < GPS_DECODER_PIPELINE_SLOTS; i++) slots[i].bytes.reserve(GPS_DECODER_PIPELINE_BATCH + 256);
+         for (size_t i = 0; i < parsers; i++) workers.push_back(std::thread(&GpsDecoderPipeline::run, this));
+      }
+
+      // Commits all complete lines and stops the parser threads
+      ~GpsDecoderPipeline()
+      {
+         flush();
+
+         {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stop = true;
+         }
+         work.notify_all();
+
+         for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+      }
+
+      // Collect a buffer into batches and commit all batches, which have been parsed meanwhile
+      // Returns the number of frames, which passed the checksum test and have been committed within this call
+      size_t decode(const char *buffer, size_t length)
+      {
+         size_t decodedFrames = 0;
+
+         decoder.decodedCharCount += length;
+
+         while (length > 0)
+         {
+            std::vector<char> &bytes = filling().bytes;
+            size_t count = length;
+
+            // A batch only grows beyond its size, while it is one single line
+            if (bytes.size() < GPS_DECODER_PIPELINE_BATCH && count > GPS_DECODER_PIPELINE_BATCH - bytes.size()) count = GPS_DECODER_PIPELINE_BATCH - bytes.size();
+
+            bytes.insert(bytes.end(), buffer, buffer + count);
+            buffer += count;
+            length -= count;
+
+            if (bytes.size() >= GPS_DECODER_PIPELINE_BATCH) decodedFrames += hand(false);
+         }
+
+         return decodedFrames + commit(false);
+      }
+
+      // Wait for the parsers and commit all complete lines
+      // A line without \n at the end of the buffer waits for the next decode(), like in the decoder
+      size_t flush()
+      {
+         size_t decodedFrames = hand(true);
+         return decodedFrames + commit(true);
+      }
+
+      size_t parsers() const   { return workers.size(); }   // Number of parser threads
+
+   private:
+      typedef GpsDecoderClass::FrameEvent FrameEvent;
+
+      struct FrameClass                                        // A finished frame of a batch
+      {
+         FrameEvent event;
+         GpsDecoderClass::FrameStateClass frame;               // Checksums and parsed sentence at the event
+      };
+
+      struct SlotClass                                         // One batch, owned by framing, parser and commit in turn
+      {
+         std::vector<char> bytes;                              // Lines of the batch, capacity is reused
+         std::vector<FrameClass> frames;                       // Frames finished in the batch, in stream order
+         std::atomic<bool> parsed;                             // Set by the parser, cleared by the commit
+
+         SlotClass() : parsed(false) {}
+      };
+
+      GpsDecoderClass &decoder;
+      SlotClass slots[GPS_DECODER_PIPELINE_SLOTS];             // Batch n is in slot n % slots, batch framed is filled right now
+      std::vector<std::thread> workers;
+      std::atomic<uint64_t> framed;                            // Batches handed over to the parsers, only written by the calling thread
+      std::atomic<uint64_t> claimed;                           // Batches taken by a parser
+      uint64_t committed;                                      // Batches committed to the decoder, only used by the calling thread
+      std::mutex sleepLock;                                    // Only to sleep, parsers on work and the calling thread on done
+      std::condition_variable work;
+      std::condition_variable done;
+      std::atomic<size_t> sleepingParsers;
+      std::atomic<bool> commitWaiting;
+      bool stop;                                               // Protected by sleepLock
+
+      SlotClass &filling()   { return slots[framed.load(std::memory_order_relaxed) % GPS_DECODER_PIPELINE_SLOTS]; }
+
+      // Offset of the first byte, which can not be parsed yet, because it belongs to a line without \n
+      // The batch starts in front of a $ or at a place, where the frame state machine waits for one
+      static size_t cutOff(const std::vector<char> &bytes)
+      {
+         const char *start = bytes.data();
+         const char *end = start + bytes.size();
+         const char *dollar = end;
+
+         // The last $ is usually within the last line, so search backwards
+         while (dollar > start && *--dollar != '$') {}
+
+         if (dollar == end || *dollar != '$' || memchr(dollar, '\n', end - dollar)) return bytes.size();
+         return dollar - start;
+      }
+
+      // Check if an unfinished line is a filtered sentence, without changing any state
+      bool isSkipped(const char *buffer, size_t length) const
+      {
+         GpsDecoderClass::FrameStateClass scratch;
+
+         while (length > 0)
+         {
+            size_t used;
+            if (decoder.scanFrame(scratch, buffer, length, used) == GpsDecoderClass::FRAME_SKIPPED) return true;
+
+            buffer += used;
+            length -= used;
+         }
+         return false;
+      }
+
+      // Hand over the filled batch to the parsers, the unfinished line at its end moves to the next slot
+      // On flush, the decoder counts a filtered sentence right behind its identifier, the rest of the line is ignored anyway
+      size_t hand(bool flush)
+      {
+         size_t decodedFrames = 0;
+         std::vector<char> &bytes = filling().bytes;
+         size_t cut = cutOff(bytes);
+
+         if (flush && cut < bytes.size() && isSkipped(bytes.data() + cut, bytes.size() - cut)) cut = bytes.size();
+         if (cut == 0) return 0;
+
+         // The next slot must be committed, before it gets the rest of the line
+         uint64_t next = framed.load(std::memory_order_relaxed) + 1;
+         if (next - committed == GPS_DECODER_PIPELINE_SLOTS) decodedFrames += commitOne();
+
+         slots[next % GPS_DECODER_PIPELINE_SLOTS].bytes.assign(bytes.begin() + cut, bytes.end());
+         bytes.resize(cut);
+
+         framed.store(next, std::memory_order_seq_cst);
+         if (sleepingParsers.load(std::memory_order_seq_cst) > 0)
+         {
+            { std::lock_guard<std::mutex> guard(sleepLock); }
+            work.notify_one();
+         }
+
+         return decodedFrames;
+      }
+
+      // Commit parsed batches in order, wait = false stops at the first batch not parsed yet
+      size_t commit(bool wait)
+      {
+         size_t decodedFrames = 0;
+
+         while (committed < framed.load(std::memory_order_relaxed))
+         {
+            if (!wait && !slots[committed % GPS_DECODER_PIPELINE_SLOTS].parsed.load(std::memory_order_acquire)) break;
+            decodedFrames += commitOne();
+         }
+
+         return decodedFrames;
+      }
+
+      // Wait for the oldest batch in flight and commit its frames
+      size_t commitOne()
+      {
+         SlotClass &slot = slots[committed % GPS_DECODER_PIPELINE_SLOTS];
+         size_t decodedFrames = 0;
+
+         if (!slot.parsed.load(std::memory_order_acquire))
+         {
+            std::unique_lock<std::mutex> guard(sleepLock);
+            commitWaiting.store(true, std::memory_order_seq_cst);
+            done.wait(guard, [&] { return slot.parsed.load(std::memory_order_seq_cst); });
+            commitWaiting.store(false, std::memory_order_relaxed);
+         }
+
+         for (size_t i = 0; i < slot.frames.size(); i++)
+         {
+            if (decoder.commitFrame(slot.frames[i].event, slot.frames[i].frame)) decodedFrames++;
+         }
+
+         slot.bytes.clear();
+         slot.frames.clear();
+         slot.parsed.store(false, std::memory_order_relaxed);
+         committed++;
+         return decodedFrames;
+      }
+
+      // Run the frame state machine over a batch and keep every finished frame
+      void parse(SlotClass &slot)
+      {
+         GpsDecoderClass::FrameStateClass frame;
+         const char *buffer = slot.bytes.data();
+         size_t length = slot.bytes.size();
+
+         while (length > 0)
+         {
+            size_t used;
+            FrameEvent event = decoder.scanFrame(frame, buffer, length, used);
+
+            buffer += used;
+            length -= used;
+            if (event != GpsDecoderClass::FRAME_NONE)
+            {
+               slot.frames.push_back(FrameClass());
+               slot.frames.back().event = event;
+               slot.frames.back().frame = frame;
+            }
+         }
+      }
+
+      // Take the next batch, false if all handed over batches are taken
+      bool claim(uint64_t &index)
+      {
+         uint64_t next = claimed.load(std::memory_order_relaxed);
+
+         while (next < framed.load(std::memory_order_acquire))
+         {
+            if (claimed.compare_exchange_weak(next, next + 1, std::memory_order_relaxed))
+            {
+               index = next;
+               return true;
+            }
+         }
+         return false;
+      }
+
+      void run()
+      {
+         for (;;)
+         {
+            uint64_t index;
+            if (claim(index))
+            {
+               SlotClass &slot = slots[index % GPS_DECODER_PIPELINE_SLOTS];
+               parse(slot);
+
+               slot.parsed.store(true, std::memory_order_seq_cst);
+               if (commitWaiting.load(std::memory_order_seq_cst))
+               {
+                  { std::lock_guard<std::mutex> guard(sleepLock); }
+                  done.notify_one();
+               }
+               continue;
+            }
+
+            std::unique_lock<std::mutex> guard(sleepLock);
+            sleepingParsers.fetch_add(1, std::memory_order_seq_cst);
+            work.wait(guard, [this] { return stop || claimed.load(std::memory_order_seq_cst) < framed.load(std::memory_order_seq_cst); });
+            sleepingParsers.fetch_sub(1, std::memory_order_relaxed);
+            if (stop && claimed.load(std::memory_order_relaxed) == framed.load(std::memory_order_relaxed)) return;
+         }
+      }
+};
+
+
+
+
+#endif
@@ -0,0 +1,319 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains a pool of decoders for many streams, decoded by a work stealing thread pool
+///
+/// Only for hosts with threads, not needed and not included on MCUs. Every stream id gets its own
+/// decoder. Submitted bytes are appended to the stream and decoded by one of the worker
+/// threads, a stream is never decoded by two threads at once and always in submit order.
+/// Bytes submitted while a stream waits for a worker are decoded together in one batch.
+///
+/// GpsDecoderPool<> pool;                                     // GpsDecoderClass, one worker per core
+/// pool.decoder(17).onEpoch(GpsDecoderRing<16>::publish, &ring);   // Handlers run in the workers
+/// pool.submit(17, bytes, length);                            // From any thread
+/// pool.wait();                                               // Until all submitted bytes are decoded
+///
+/// Large fleets only need a few fields per stream, a GpsDecoder<Config> with just these fields
+/// takes a fraction of the memory of a GpsDecoderClass:
+///
+/// GpsDecoderPool<GpsDecoder<FleetConfig> > fleet;
+///
+/// Streams are allocated in cache line aligned slabs, so two streams never share a cache line.
+/// Idle streams keep only small buffers, the bytes of a burst are not held until the next one.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_POOL_H_
+#define GPS_DECODER_POOL_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "gpsDecoderRing.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_POOL_SHARDS           64                  // Stream maps with an own lock, stream id % shards
+#define GPS_DECODER_POOL_SLAB             64                  // Streams allocated at once
+#define GPS_DECODER_POOL_IDLE_BUFFER      256                 // Bytes of buffer an idle stream keeps
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+template <class Decoder = GpsDecoderClass>
+class GpsDecoderPool
+{
+   public:
+      // Starts the worker threads, 0 = one per core
+      explicit GpsDecoderPool(size_t threads = 0) : nextWorker(0), queuedStreams(0), outstandingSubmits(0), stop(false)
+      {
+         if (threads == 0) threads = std::thread::hardware_concurrency();
+         if (threads == 0) threads = 1;
+
+         for (size_t i = 0; i < threads; i++) workers.push_back(std::unique_ptr<WorkerClass>(new WorkerClass()));
+         for (size_t i = 0; i < threads; i++) workers[i]->thread = std::thread(&GpsDecoderPool::run, this, i);
+      }
+
+      // Decodes all submitted bytes and stops the worker threads
+      ~GpsDecoderPool()
+      {
+         wait();
+
+         {
+            std::lock_guard<std::mutex> guard(sleepLock);
+            stop = true;
+         }
+         wake.notify_all();
+
+         for (size_t i = 0; i < workers.size(); i++) workers[i]->thread.join();
+
+         for (size_t i = 0; i < slabs.size(); i++)
+         {
+            for (size_t j = 0; j < slabs[i].used; j++) slabs[i].streams[j].~StreamClass();
+            free(slabs[i].memory);
+         }
+      }
+
+      // Append bytes to a stream, the stream is created with the first call, any thread
+      void submit(uint32_t streamId, const char *buffer, size_t length)
+      {
+         StreamClass &stream = findStream(streamId);
+         bool schedule;
+
+         outstandingSubmits.fetch_add(1, std::memory_order_relaxed);
+
+         {
+            std::lock_guard<std::mutex> guard(stream.lock);
+            stream.pending.insert(stream.pending.end(), buffer, buffer + length);
+            stream.pendingSubmits++;
+            schedule = !stream.scheduled;
+            stream.scheduled = true;
+         }
+
+         // A stream is in at most one worker queue, a scheduled stream takes the bytes with it
+         if (schedule) push(nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size(), &stream);
+      }
+
+      // Wait until all bytes submitted before are decoded
+      void wait()
+      {
+         std::unique_lock<std::mutex> guard(idleLock);
+         idle.wait(guard, [this] { return outstandingSubmits.load(std::memory_order_acquire) == 0; });
+      }
+
+      // Decoder of a stream, created if needed
+      // Only use it while the stream is not decoded, before submit() or behind wait()
+      Decoder &decoder(uint32_t streamId)   { return findStream(streamId).decoder; }
+
+      size_t streams()                              // Number of streams
+      {
+         size_t count = 0;
+         for (size_t i = 0; i < GPS_DECODER_POOL_SHARDS; i++)
+         {
+            std::lock_guard<std::mutex> guard(shards[i].lock);
+            count += shards[i].streams.size();
+         }
+         return count;
+      }
+
+      size_t threads() const   { return workers.size(); }   // Number of worker threads
+
+   private:
+      struct alignas(GPS_DECODER_CACHE_LINE) StreamClass
+      {
+         Decoder decoder;                                      // Only used by the worker, which took the stream
+         std::mutex lock;                                      // Protects the members below
+         std::vector<char> pending;                            // Bytes not yet decoded
+         size_t pendingSubmits;                                // Number of submits in pending
+         bool scheduled;                                       // Stream is in a worker queue or decoded right now
+
+         StreamClass() : pendingSubmits(0), scheduled(false) {}
+      };
+
+      struct ShardClass
+      {
+         std::mutex lock;
+         std::unordered_map<uint32_t, StreamClass *> streams;
+      };
+
+      struct SlabClass
+      {
+         void *memory;                                         // As allocated, streams start at the next cache line
+         StreamClass *streams;
+         size_t used;                                          // Constructed streams
+      };
+
+      struct WorkerClass
+      {
+         std::mutex lock;                                      // Protects tasks
+         std::deque<StreamClass *> tasks;                      // Owner takes from the front in FIFO order, thieves from the back
+         std::vector<char> batch;                              // Bytes decoded right now, kept to reuse the memory
+         std::thread thread;
+      };
+
+      ShardClass shards[GPS_DECODER_POOL_SHARDS];
+      std::vector<std::unique_ptr<WorkerClass>> workers;
+      std::atomic<size_t> nextWorker;                          // Round robin for new scheduled streams
+      std::atomic<size_t> queuedStreams;                       // Streams in all worker queues
+      std::atomic<size_t> outstandingSubmits;                  // Submits not yet decoded
+      std::mutex sleepLock;                                    // Idle workers sleep on wake
+      std::condition_variable wake;
+      std::mutex idleLock;                                     // wait() sleeps on idle
+      std::condition_variable idle;
+      bool stop;                                               // Protected by sleepLock
+      std::mutex slabLock;                                     // Protects slabs
+      std::vector<SlabClass> slabs;
+
+      StreamClass &findStream(uint32_t streamId)
+      {
+         ShardClass &shard = shards[streamId % GPS_DECODER_POOL_SHARDS];
+         std::lock_guard<std::mutex> guard(shard.lock);
+
+         StreamClass *&stream = shard.streams[streamId];
+         if (!stream) stream = allocateStream();
+         return *stream;
+      }
+
+      // Construct a stream in the last slab, a full slab is followed by a new one
+      // operator new does not align to cache lines before C++17, so the slabs are aligned by hand
+      StreamClass *allocateStream()
+      {
+         std::lock_guard<std::mutex> guard(slabLock);
+
+         if (slabs.empty() || slabs.back().used == GPS_DECODER_POOL_SLAB)
+         {
+            SlabClass slab;
+            slab.memory = malloc(GPS_DECODER_POOL_SLAB * sizeof(StreamClass) + GPS_DECODER_CACHE_LINE - 1);
+            if (!slab.memory) throw std::bad_alloc();
+            slab.streams = reinterpret_cast<StreamClass *>(((uintptr_t)slab.memory + GPS_DECODER_CACHE_LINE - 1) & ~(uintptr_t)(GPS_DECODER_CACHE_LINE - 1));
+            slab.used = 0;
+            slabs.push_back(slab);
+         }
+
+         SlabClass &slab = slabs.back();
+         StreamClass *stream = new (&slab.streams[slab.used]) StreamClass();
+         slab.used++;
+         return stream;
+      }
+
+      // Add a scheduled stream to a worker queue, behind all waiting ones, so a busy stream can not starve the others
+      void push(size_t worker, StreamClass *stream)
+      {
+         {
+            std::lock_guard<std::mutex> guard(workers[worker]->lock);
+            workers[worker]->tasks.push_back(stream);
+         }
+         queuedStreams.fetch_add(1, std::memory_order_release);
+
+         // Empty lock, so a worker can not miss the wake up between its check and its sleep
+         { std::lock_guard<std::mutex> guard(sleepLock); }
+         wake.notify_one();
+      }
+
+      // Take a stream from the own queue or steal one from the others, NULL if all are empty
+      StreamClass *take(size_t self)
+      {
+         for (size_t i = 0; i < workers.size(); i++)
+         {
+            WorkerClass &worker = *workers[(self + i) % workers.size()];
+            std::lock_guard<std::mutex> guard(worker.lock);
+
+            if (worker.tasks.empty()) continue;
+
+            StreamClass *stream;
+            if (i == 0)
+            {
+               stream = worker.tasks.front();
+               worker.tasks.pop_front();
+            }
+            else
+            {
+               stream = worker.tasks.back();
+               worker.tasks.pop_back();
+            }
+            queuedStreams.fetch_sub(1, std::memory_order_relaxed);
+            return stream;
+         }
+
+         return NULL;
+      }
+
+      // Decode all bytes pending in a stream at once
+      void process(size_t self, StreamClass *stream)
+      {
+         WorkerClass &worker = *workers[self];
+         size_t submits;
+
+         {
+            std::lock_guard<std::mutex> guard(stream->lock);
+            worker.batch.swap(stream->pending);
+            submits = stream->pendingSubmits;
+            stream->pendingSubmits = 0;
+         }
+
+         stream->decoder.decode(worker.batch.data(), worker.batch.size());
+         worker.batch.clear();
+
+         // More bytes arrived meanwhile, give the other streams a chance first
+         bool reschedule;
+         {
+            std::lock_guard<std::mutex> guard(stream->lock);
+            reschedule = !stream->pending.empty();
+            stream->scheduled = reschedule;
+
+            // The stream got the former batch buffer of the worker, do not keep the memory of a burst while idle
+            if (!reschedule && stream->pending.capacity() > GPS_DECODER_POOL_IDLE_BUFFER) std::vector<char>().swap(stream->pending);
+         }
+         if (reschedule) push(self, stream);
+
+         if (outstandingSubmits.fetch_sub(submits, std::memory_order_acq_rel) == submits)
+         {
+            { std::lock_guard<std::mutex> guard(idleLock); }
+            idle.notify_all();
+         }
+      }
+
+      void run(size_t self)
+      {
+         for (;;)
+         {
+            StreamClass *stream = take(self);
+            if (stream)
+            {
+               process(self, stream);
+               continue;
+            }
+
+            std::unique_lock<std::mutex> guard(sleepLock);
+            wake.wait(guard, [this] { return stop || queuedStreams.load(std::memory_order_acquire) > 0; });
+            if (stop && queuedStreams.load(std::memory_order_acquire) == 0) return;
+         }
+      }
+};
+
+
+
+
+#endif
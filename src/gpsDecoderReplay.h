@@ -0,0 +1,315 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the parallel replay of recorded NMEA log files
+///
+/// Only for POSIX hosts with threads, not needed and not included on MCUs. The log is mapped
+/// into memory and never copied. It is split into chunks, which start at a $ in front of a line,
+/// every chunk is decoded by an own GpsDecoderClass on one of the worker threads. The fix records
+/// are handed over to the handler in the calling thread, in the order of the file.
+///
+/// GpsDecoderReplay replay;                                   // One worker per core
+/// if (!replay.open("fleet-2026-10-16.nmea")) return;
+/// replay.onSetup(setup, NULL);                               // Epoch rule, filters of every decoder
+/// replay.replay(store, &database);                           // Epoch handler, called in file order
+///
+/// Sentences and epochs are not cut at the chunk borders. Every decoder first decodes a lead-in
+/// in front of its chunk without handing over records, so the satellite tables, GSV sequences
+/// and the open epoch at the border are the same as in one decoder reading the whole file.
+/// An epoch belongs to the chunk of the sentence, which completes it. The lead-in must be
+/// longer than a complete epoch with all GSV sequences.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_REPLAY_H_
+#define GPS_DECODER_REPLAY_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <atomic>
+#include <condition_variable>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_REPLAY_CHUNK          (64UL << 20)        // Default bytes per chunk
+#define GPS_DECODER_REPLAY_LEAD_IN        (32UL << 10)        // Default bytes decoded in front of a chunk
+#define GPS_DECODER_REPLAY_AHEAD          2                   // Chunks per worker decoded ahead of the handler
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class GpsDecoderReplay
+{
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+      typedef void (*SetupHandler)(GpsDecoderClass &decoder, void *context);   // Configures a decoder before it is used
+
+      // threads = 0 is one worker per core
+      explicit GpsDecoderReplay(size_t threads = 0) : threadCount(threads), chunkSize(GPS_DECODER_REPLAY_CHUNK), leadIn(GPS_DECODER_REPLAY_LEAD_IN),
+                                                      setupHandler(NULL), setupContext(NULL), data(NULL), length(0),
+                                                      passedChecksumCount(0), failedChecksumCount(0)
+      {
+         if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+         if (threadCount == 0) threadCount = 1;
+      }
+
+      ~GpsDecoderReplay()   { close(); }
+
+      // Map a log file, returns false if it can not be opened or mapped
+      bool open(const char *path)
+      {
+         close();
+
+         int file = ::open(path, O_RDONLY);
+         if (file < 0) return false;
+
+         struct stat info;
+         if (fstat(file, &info) != 0)
+         {
+            ::close(file);
+            return false;
+         }
+
+         length = (size_t)info.st_size;
+         if (length > 0)
+         {
+            void *mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+            if (mapped == MAP_FAILED)
+            {
+               length = 0;
+               ::close(file);
+               return false;
+            }
+            data = (const char *)mapped;
+            madvise(mapped, length, MADV_SEQUENTIAL);
+         }
+
+         // The mapping keeps the file
+         ::close(file);
+         return true;
+      }
+
+      void close()
+      {
+         if (data) munmap((void *)data, length);
+         data = NULL;
+         length = 0;
+      }
+
+      // Called for every decoder before it decodes, to set the same epoch rule and filters
+      // as for a decoder reading the whole file. Do not register an epoch handler there.
+      void onSetup(SetupHandler handler, void *context = NULL)
+      {
+         setupHandler = handler;
+         setupContext = context;
+      }
+
+      void setChunkSize(size_t bytes)   { chunkSize = bytes ? bytes : 1; }   // Bytes per chunk, before aligning to a line
+      void setLeadIn(size_t bytes)      { leadIn = bytes; }                  // Bytes decoded in front of every chunk
+
+      // Decode the whole file, handler is called with every complete epoch in file order in the calling thread
+      // Returns the number of records, the open epoch at the end of the file is not complete and not handed over
+      size_t replay(GpsDecoderClass::EpochHandler handler, void *context = NULL)
+      {
+         std::vector<size_t> starts = split();
+         std::vector<ChunkClass> chunks(starts.size() - 1);
+         ShareClass share;
+         size_t records = 0;
+
+         for (size_t i = 0; i < chunks.size(); i++)
+         {
+            chunks[i].begin = starts[i];
+            chunks[i].end = starts[i + 1];
+         }
+
+         share.nextChunk = 0;
+         share.delivered = 0;
+
+         std::vector<std::thread> workers;
+         size_t threads = threadCount < chunks.size() ? threadCount : chunks.size();
+         for (size_t i = 0; i < threads; i++) workers.push_back(std::thread(&GpsDecoderReplay::run, this, std::ref(chunks), std::ref(share), threads));
+
+         passedChecksumCount = 0;
+         failedChecksumCount = 0;
+
+         // Hand over the chunks in file order, as soon as they are decoded
+         for (size_t i = 0; i < chunks.size(); i++)
+         {
+            std::vector<FixRecord> fixes;
+            {
+               std::unique_lock<std::mutex> guard(share.lock);
+               share.changed.wait(guard, [&] { return chunks[i].done; });
+               fixes.swap(chunks[i].fixes);
+               share.delivered = i + 1;
+            }
+            share.changed.notify_all();
+
+            passedChecksumCount += chunks[i].passedChecksum;
+            failedChecksumCount += chunks[i].failedChecksum;
+
+            if (handler)
+            {
+               for (size_t j = 0; j < fixes.size(); j++) handler(fixes[j], context);
+            }
+            records += fixes.size();
+         }
+
+         for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+
+         return records;
+      }
+
+      size_t size() const               { return length; }                   // Bytes of the mapped file
+      size_t threads() const            { return threadCount; }              // Number of worker threads
+      uint32_t passedChecksum() const   { return passedChecksumCount; }      // Passed checksum messages of the last replay
+      uint32_t failedChecksum() const   { return failedChecksumCount; }      // Failed checksum messages of the last replay
+
+   private:
+      struct ChunkClass
+      {
+         size_t begin;                                         // Offset of the first byte, a $ or 0
+         size_t end;                                           // Offset behind the last byte
+         std::vector<FixRecord> fixes;                         // Records completed within the chunk
+         uint32_t passedChecksum;
+         uint32_t failedChecksum;
+         bool done;                                            // Protected by ShareClass::lock
+
+         ChunkClass() : begin(0), end(0), passedChecksum(0), failedChecksum(0), done(false) {}
+      };
+
+      struct ShareClass
+      {
+         std::mutex lock;                                      // Protects done of the chunks and delivered
+         std::condition_variable changed;                      // A chunk has been decoded or handed over
+         std::atomic<size_t> nextChunk;                        // Next chunk to decode
+         size_t delivered;                                     // Chunks handed over to the handler
+      };
+
+      struct CollectClass                                      // Context of the epoch handler of a chunk decoder
+      {
+         std::vector<FixRecord> *fixes;                        // NULL while decoding the lead-in
+      };
+
+      size_t threadCount;
+      size_t chunkSize;
+      size_t leadIn;
+      SetupHandler setupHandler;
+      void *setupContext;
+      const char *data;                                        // Mapped file, NULL if empty or not open
+      size_t length;
+      uint32_t passedChecksumCount;
+      uint32_t failedChecksumCount;
+
+      // Offset of the first $ at the start of a line at or behind offset, length if there is none
+      size_t lineStart(size_t offset) const
+      {
+         if (offset == 0) return 0;
+
+         // Start with the char in front of offset, offset itself is fine behind a \n
+         for (size_t search = offset - 1; search < length;)
+         {
+            const char *found = (const char *)memchr(data + search, '\n', length - search);
+            if (!found) return length;
+
+            search = found - data + 1;
+            if (search < length && data[search] == '$') return search;
+         }
+         return length;
+      }
+
+      // Chunk borders, the first one is 0, the last one is length, no chunk is empty
+      std::vector<size_t> split() const
+      {
+         std::vector<size_t> starts(1, 0);
+
+         while (starts.back() < length)
+         {
+            size_t next = length - starts.back() > chunkSize ? lineStart(starts.back() + chunkSize) : length;
+            starts.push_back(next);
+         }
+         if (starts.size() == 1) starts.push_back(0);
+         return starts;
+      }
+
+      static void collect(const FixRecord &record, void *context)
+      {
+         CollectClass *collect = static_cast<CollectClass *>(context);
+         if (collect->fixes) collect->fixes->push_back(record);
+      }
+
+      void decodeChunk(ChunkClass &chunk)
+      {
+         GpsDecoderClass decoder;
+         CollectClass collect = { NULL };
+
+         if (setupHandler) setupHandler(decoder, setupContext);
+         decoder.onEpoch(GpsDecoderReplay::collect, &collect);
+
+         // The lead-in sets up the state at the border, its own records belong to the chunk in front
+         size_t leadBegin = chunk.begin > leadIn ? lineStart(chunk.begin - leadIn) : 0;
+         if (leadBegin < chunk.begin) decoder.decode(data + leadBegin, chunk.begin - leadBegin);
+
+         uint32_t passed = decoder.passedChecksum();
+         uint32_t failed = decoder.failedChecksum();
+
+         // madvise needs a page aligned address
+         size_t page = chunk.begin & ~(size_t)(sysconf(_SC_PAGESIZE) - 1);
+         madvise((void *)(data + page), chunk.end - page, MADV_WILLNEED);
+
+         collect.fixes = &chunk.fixes;
+         decoder.decode(data + chunk.begin, chunk.end - chunk.begin);
+
+         chunk.passedChecksum = decoder.passedChecksum() - passed;
+         chunk.failedChecksum = decoder.failedChecksum() - failed;
+      }
+
+      // Worker, decodes chunks until all are taken, at most ahead chunks per worker in front of the handler
+      void run(std::vector<ChunkClass> &chunks, ShareClass &share, size_t workers)
+      {
+         for (;;)
+         {
+            size_t index = share.nextChunk.fetch_add(1);
+            if (index >= chunks.size()) return;
+
+            {
+               std::unique_lock<std::mutex> guard(share.lock);
+               share.changed.wait(guard, [&] { return index < share.delivered + workers * GPS_DECODER_REPLAY_AHEAD; });
+            }
+
+            if (data) decodeChunk(chunks[index]);
+
+            {
+               std::lock_guard<std::mutex> guard(share.lock);
+               chunks[index].done = true;
+            }
+            share.changed.notify_all();
+         }
+      }
+};
+
+
+
+
+#endif
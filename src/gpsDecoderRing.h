@@ -0,0 +1,369 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains lock free queues and slots, which hand over fix records to other threads
+///
+/// Only for hosts with threads and C++11 <atomic>, not needed and not included on MCUs.
+/// The decoder thread publishes every complete epoch with the epoch handler, the consumer
+/// threads never touch the decoder itself:
+///
+/// GpsDecoderRing<16> ring;                                   // One consumer
+/// decoder.onEpoch(GpsDecoderRing<16>::publish, &ring);
+/// ...
+/// GpsDecoderClass::FixRecord fix;
+/// while (ring.pop(fix)) log(fix);                            // In the consumer thread
+///
+/// GpsDecoderBroadcast<16> broadcast;                         // Any number of consumers
+/// decoder.onEpoch(GpsDecoderBroadcast<16>::publish, &broadcast);
+/// ...
+/// GpsDecoderBroadcast<16>::Reader reader(broadcast);         // One reader per consumer thread
+/// while (reader.pop(fix)) uplink(fix);
+///
+/// GpsDecoderLatest latest;                                    // Only the most recent record
+/// decoder.onLocation(GpsDecoderLatest::publishLocation, &latest);
+/// ...
+/// if (latest.load(fix)) show(fix);                            // In any number of threads
+///
+/// The decoder has one epoch handler, GpsDecoderFanout hands every epoch to several ones:
+///
+/// GpsDecoderFanout<4> fanout;
+/// fanout.add(GpsDecoderRing<16>::publish, &ring);
+/// fanout.add(GpsDecoderBroadcast<16>::publish, &broadcast);
+/// decoder.onEpoch(GpsDecoderFanout<4>::publish, &fanout);
+///
+/// Latency: with the default GPS_DECODER_EPOCH_TIME_CHANGE rule an epoch is complete with the first
+/// sentence of the next one, so every epoch handler gets it one epoch late, 1 s at 1 Hz. The
+/// GPS_DECODER_EPOCH_LAST_SENTENCE rule with the last sentence of the receiver removes that delay.
+/// GpsDecoderLatest::publishLocation runs with every location commit and has no delay at all, but
+/// its record has the last values of all fields, which may come from the epoch before.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_RING_H_
+#define GPS_DECODER_RING_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <atomic>
+#include <string.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_CACHE_LINE            64                  // Indices written by different threads are kept this far apart
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+
+// Wait free ring of fix records with one producer and one consumer thread
+// A full ring drops the new record, the consumer always gets the oldest records first
+template <size_t Capacity>
+class GpsDecoderRing
+{
+   static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "GpsDecoderRing: Capacity must be a power of 2");
+
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      GpsDecoderRing() : head(0), cachedTail(0), droppedCount(0), tail(0), cachedHead(0) {}
+
+      // Producer: add a record, false if the ring is full and the record has been dropped
+      bool push(const FixRecord &record)
+      {
+         size_t h = head.load(std::memory_order_relaxed);
+
+         if (h - cachedTail >= Capacity)
+         {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (h - cachedTail >= Capacity)
+            {
+               droppedCount.store(droppedCount.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+               return false;
+            }
+         }
+
+         slots[h & (Capacity - 1)] = record;
+         head.store(h + 1, std::memory_order_release);
+         return true;
+      }
+
+      // Consumer: take the oldest record, false if the ring is empty
+      bool pop(FixRecord &record)
+      {
+         size_t t = tail.load(std::memory_order_relaxed);
+
+         if (cachedHead == t)
+         {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (cachedHead == t) return false;
+         }
+
+         record = slots[t & (Capacity - 1)];
+         tail.store(t + 1, std::memory_order_release);
+         return true;
+      }
+
+      size_t dropped() const   { return droppedCount.load(std::memory_order_relaxed); }   // Records dropped, because the ring was full
+
+      // Epoch handler, context is the ring, see GpsDecoderClass::onEpoch
+      static void publish(const FixRecord &record, void *ring)   { static_cast<GpsDecoderRing *>(ring)->push(record); }
+
+   private:
+      // Producer cache line
+      alignas(GPS_DECODER_CACHE_LINE) std::atomic<size_t> head;   // Next record to write
+      size_t cachedTail;                                          // Last tail seen by the producer
+      std::atomic<size_t> droppedCount;
+
+      // Consumer cache line
+      alignas(GPS_DECODER_CACHE_LINE) std::atomic<size_t> tail;   // Next record to read
+      size_t cachedHead;                                          // Last head seen by the consumer
+
+      alignas(GPS_DECODER_CACHE_LINE) FixRecord slots[Capacity];
+};
+
+
+// One fix record protected by a sequence lock, one writer and any number of reader threads
+// Readers never write to the slot, they copy it word by word and check, that the writer was not active meanwhile
+class alignas(GPS_DECODER_CACHE_LINE) GpsDecoderSeqlock
+{
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      GpsDecoderSeqlock() : sequence(0)
+      {
+         for (size_t i = 0; i < WORDS; i++) words[i].store(0, std::memory_order_relaxed);
+      }
+
+      // Writer: store a record with a version above 0, the sequence is odd while the words are written
+      void store(const FixRecord &record, uint64_t version)
+      {
+         uint32_t copy[WORDS];
+
+         sequence.store(2 * version - 1, std::memory_order_relaxed);
+         std::atomic_thread_fence(std::memory_order_release);
+
+         memcpy(copy, &record, sizeof(record));
+         for (size_t i = 0; i < WORDS; i++) words[i].store(copy[i], std::memory_order_relaxed);
+
+         sequence.store(2 * version, std::memory_order_release);
+      }
+
+      // Reader: copy the record, returns false and leaves record untouched if the writer was active meanwhile
+      // version is set to the last completely stored version in any case, 0 if nothing has been stored yet
+      bool tryLoad(FixRecord &record, uint64_t &version) const
+      {
+         uint32_t copy[WORDS];
+
+         uint64_t before = sequence.load(std::memory_order_acquire);
+         version = before / 2;
+
+         for (size_t i = 0; i < WORDS; i++) copy[i] = words[i].load(std::memory_order_relaxed);
+         std::atomic_thread_fence(std::memory_order_acquire);
+
+         if ((before & 1) || sequence.load(std::memory_order_relaxed) != before) return false;
+
+         memcpy(&record, copy, sizeof(record));
+         return true;
+      }
+
+   private:
+      static const size_t WORDS = (sizeof(FixRecord) + 3) / 4;
+
+      std::atomic<uint64_t> sequence;                          // 2 * version if complete, odd while written
+      std::atomic<uint32_t> words[WORDS];                      // Record, copied word by word
+};
+
+
+// Most recent fix record for any number of reader threads, a sequence lock without any lock for the writer
+// Readers do not write to shared memory at all, so they scale with the number of cores
+// publishLocation stores the current values of the decoder with every location, publish complete epochs
+class GpsDecoderLatest
+{
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      GpsDecoderLatest() : version(0) {}
+
+      // Writer: replace the record, only one writer thread
+      void store(const FixRecord &record)   { slot.store(record, ++version); }
+
+      // Reader: copy the most recent record, retries while the writer is active
+      // Returns the version of the record, increasing with every store, 0 and record untouched if nothing has been stored yet
+      uint64_t load(FixRecord &record) const
+      {
+         FixRecord copy;
+         uint64_t loaded;
+
+         while (!slot.tryLoad(copy, loaded)) {}
+
+         if (loaded) record = copy;
+         return loaded;
+      }
+
+      // Epoch handler, context is the latest record, see GpsDecoderClass::onEpoch
+      static void publish(const FixRecord &record, void *latest)   { static_cast<GpsDecoderLatest *>(latest)->store(record); }
+
+      // Location handler, context is the latest record, see GpsDecoderClass::onLocation and currentFix
+      static void publishLocation(GpsDecoderClass &decoder, void *latest)
+      {
+         FixRecord record;
+         decoder.currentFix(record);
+         static_cast<GpsDecoderLatest *>(latest)->store(record);
+      }
+
+   private:
+      uint64_t version;                                        // Only used by the writer
+      GpsDecoderSeqlock slot;
+};
+
+
+// Up to Capacity epoch handlers behind the one of the decoder, called in the order they have been added
+// Handlers are added before decoding starts, publish runs in the decoder thread
+template <size_t Capacity>
+class GpsDecoderFanout
+{
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+      typedef GpsDecoderClass::EpochHandler EpochHandler;
+
+      GpsDecoderFanout() : count(0) {}
+
+      // Add a handler with its context, false if all Capacity places are taken
+      bool add(EpochHandler handler, void *context)
+      {
+         if (count == Capacity) return false;
+
+         handlers[count] = handler;
+         contexts[count] = context;
+         count++;
+         return true;
+      }
+
+      // Epoch handler, context is the fan-out, see GpsDecoderClass::onEpoch
+      static void publish(const FixRecord &record, void *fanout)
+      {
+         GpsDecoderFanout *self = static_cast<GpsDecoderFanout *>(fanout);
+         for (size_t i = 0; i < self->count; i++) self->handlers[i](record, self->contexts[i]);
+      }
+
+   private:
+      size_t count;
+      EpochHandler handlers[Capacity];
+      void *contexts[Capacity];
+};
+
+
+// Wait free ring of fix records with one producer and any number of consumer threads
+// The producer never waits for the consumers and overwrites the oldest record, every slot is protected
+// by its own sequence number. A consumer, which has been overtaken, continues with the oldest record
+// still available and counts the records it has lost.
+template <size_t Capacity>
+class GpsDecoderBroadcast
+{
+   static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "GpsDecoderBroadcast: Capacity must be a power of 2");
+
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      class Reader                                             // Read position of one consumer thread
+      {
+         public:
+            // Starts behind the records already published
+            explicit Reader(const GpsDecoderBroadcast &broadcast) : broadcast(broadcast), next(broadcast.head.load(std::memory_order_acquire)), lostCount(0) {}
+
+            // Take the next record, false if there is no new one
+            bool pop(FixRecord &record)
+            {
+               for (;;)
+               {
+                  switch (broadcast.read(next, record))
+                  {
+                     case READ_OK:
+                        next++;
+                        return true;
+
+                     case READ_EMPTY:
+                        return false;
+
+                     default:
+                     {
+                        // Overtaken by the producer, continue with the oldest record still in the ring
+                        uint64_t h = broadcast.head.load(std::memory_order_acquire);
+                        if (h - next > Capacity)
+                        {
+                           lostCount += h - Capacity - next;
+                           next = h - Capacity;
+                        }
+                        else
+                        {
+                           lostCount++;
+                           next++;
+                        }
+                        break;
+                     }
+                  }
+               }
+            }
+
+            uint64_t lost() const   { return lostCount; }   // Records overwritten, before this reader got them
+
+         private:
+            const GpsDecoderBroadcast &broadcast;
+            uint64_t next;                                     // Index of the next record to read
+            uint64_t lostCount;
+      };
+
+      GpsDecoderBroadcast() : head(0) {}
+
+      // Producer: add a record, overwrites the oldest one
+      // The record with index h is stored as version h + 1 in slot h % Capacity
+      void push(const FixRecord &record)
+      {
+         uint64_t h = head.load(std::memory_order_relaxed);
+
+         slots[h & (Capacity - 1)].store(record, h + 1);
+         head.store(h + 1, std::memory_order_release);
+      }
+
+      uint64_t published() const   { return head.load(std::memory_order_relaxed); }   // Endless increasing number of published records
+
+      // Epoch handler, context is the broadcast, see GpsDecoderClass::onEpoch
+      static void publish(const FixRecord &record, void *broadcast)   { static_cast<GpsDecoderBroadcast *>(broadcast)->push(record); }
+
+   private:
+      enum ReadResult { READ_OK, READ_EMPTY, READ_OVERWRITTEN };
+
+      // Copy the record with the given index, record is only changed if it is READ_OK
+      ReadResult read(uint64_t index, FixRecord &record) const
+      {
+         FixRecord copy;
+         uint64_t version;
+         bool consistent = slots[index & (Capacity - 1)].tryLoad(copy, version);
+
+         if (version < index + 1) return READ_EMPTY;
+         if (!consistent || version != index + 1) return READ_OVERWRITTEN;
+
+         record = copy;
+         return READ_OK;
+      }
+
+      alignas(GPS_DECODER_CACHE_LINE) std::atomic<uint64_t> head;   // Next record to write
+      GpsDecoderSeqlock slots[Capacity];
+};
+
+
+
+
+#endif
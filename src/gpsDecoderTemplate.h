@@ -0,0 +1,533 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the template configured variant of gpsDecoder
+///
+/// GpsDecoder<Config> decodes like GpsDecoderClass, but the config type selects at compile time
+/// which sentences, talkers, satellite systems and fields exist. Disabled fields are empty base
+/// classes and take no RAM, parsers of sentences which can not update any enabled field are never
+/// referenced and removed by the linker. Fields are accessed by methods, decoder.location().lat().
+///
+/// This file is not header only. The template shares the frame state machine, the sentence
+/// parsers and the field classes with GpsDecoderClass, so these sources must be linked too:
+/// gpsDecoder.cpp                  parseFieldXXX, fieldView, findControlChar, xxxFilterBit
+/// FrameStateClass.cpp             start, appendToField, addToChecksum, readChecksum
+/// FieldClass.cpp                  number parsers used by parseFieldXXX
+/// SatellitesClass.cpp             SatelliteSystemClass::commitGSA and commitGSV
+/// LocationClass.cpp, RawDegreesClass.cpp, DateClass.cpp, TimeClass.cpp, DecimalClass.cpp,
+/// IntegerClass.cpp and EpochClass.cpp, the fields and the classes gpsDecoder.cpp refers to
+/// Linking the gpsDecoder library of GpsDecoderClass covers all of them. Without
+/// -ffunction-sections and --gc-sections the unused parsers stay in the binary.
+///
+/// struct WatchConfig : GpsDecoderDefaultConfig
+/// {
+///    static constexpr uint16_t fields = GPS_DECODER_FIELD_LOCATION | GPS_DECODER_FIELD_TIME;
+///    static constexpr size_t ramBudget = 200;               // static_assert fails if sizeof is bigger
+/// };
+/// GpsDecoder<WatchConfig> gps;
+///
+/// Events are delivered to the static methods of Config::Handler, resolved at compile time
+/// without function pointers, so empty handlers vanish and used ones can be inlined.
+///
+/// struct WatchHandler : GpsDecoderNoHandler
+/// {
+///    template <class Decoder> static void onLocation(Decoder &gps) { draw(gps.location().latE7(), gps.location().lngE7()); }
+/// };
+/// and "typedef WatchHandler Handler;" in WatchConfig.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_TEMPLATE_H_
+#define GPS_DECODER_TEMPLATE_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+
+// Satellite systems of GpsDecoder<Config>, see GpsDecoderDefaultConfig::systems
+#define GPS_DECODER_SYSTEM_GPS            0x01
+#define GPS_DECODER_SYSTEM_GLONASS        0x02
+#define GPS_DECODER_SYSTEM_BAIDU          0x04
+#define GPS_DECODER_SYSTEM_ALL            0xff
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+
+// Event handler, which ignores all events, derive from it and hide only the events which are used
+// Handlers are called from decode(), right behind the commit of the fields, see GpsDecoderClass::onGGA
+struct GpsDecoderNoHandler
+{
+   template <class Decoder> static void onGGA(Decoder &)              {}   // Behind every committed GGA
+   template <class Decoder> static void onRMC(Decoder &)              {}   // Behind every committed RMC
+   template <class Decoder> static void onLocation(Decoder &)         {}   // Behind every location commit and the rest of its sentence
+   template <class Decoder> static void onChecksumFailure(Decoder &)  {}   // With every failed checksum
+   template <class Decoder> static void onSkyView(Decoder &)          {}   // With every complete sky view
+};
+
+
+// Default config, derive from it and hide only the values which differ
+struct GpsDecoderDefaultConfig
+{
+   static constexpr uint16_t sentences = GPS_DECODER_SENTENCE_ALL;     // GPS_DECODER_SENTENCE_xxx which are decoded
+   static constexpr uint8_t talkers = GPS_DECODER_TALKER_ALL;          // GPS_DECODER_TALKER_xxx which are decoded
+   static constexpr uint16_t fields = GPS_DECODER_FIELD_ALL;           // GPS_DECODER_FIELD_xxx which are stored
+   static constexpr uint8_t systems = GPS_DECODER_SYSTEM_ALL;          // GPS_DECODER_SYSTEM_xxx with satellite lists
+   static constexpr size_t ramBudget = 0;                              // Maximum sizeof the decoder, 0 = not checked
+   typedef GpsDecoderNoHandler Handler;                                // Static methods called with the events
+};
+
+
+// Storage of one field, disabled fields are empty classes and vanish as base class
+template <class T, uint8_t id, bool enabled>
+class GpsDecoderSlot
+{
+   protected:
+      T *slot()   { return &data; }
+
+   private:
+      T data;
+};
+
+template <class T, uint8_t id>
+class GpsDecoderSlot<T, id, false>
+{
+   protected:
+      T *slot()   { return NULL; }
+};
+
+
+// Storage layout of GpsDecoder<Config>, one slot per field
+template <class Config>
+class GpsDecoderLayout
+{
+   public:
+      static constexpr bool has(uint16_t field)        { return (Config::fields & field) != 0; }
+      static constexpr bool hasSystem(uint8_t system)  { return has(GPS_DECODER_FIELD_SATELLITES) && (Config::systems & system) != 0; }
+
+      typedef GpsDecoderSlot<GpsDecoderClass::LocationClass,         0, has(GPS_DECODER_FIELD_LOCATION)>   LocationSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::DateClass,             1, has(GPS_DECODER_FIELD_DATE)>       DateSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::TimeClass,             2, has(GPS_DECODER_FIELD_TIME)>       TimeSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::SpeedClass,            3, has(GPS_DECODER_FIELD_SPEED)>      SpeedSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::CourseClass,           4, has(GPS_DECODER_FIELD_COURSE)>     CourseSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::AltitudeClass,         5, has(GPS_DECODER_FIELD_ALTITUDE)>   AltitudeSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::DecimalClass,          6, has(GPS_DECODER_FIELD_DOP)>        HdopSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::DecimalClass,          7, has(GPS_DECODER_FIELD_DOP)>        VdopSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::DecimalClass,          8, has(GPS_DECODER_FIELD_DOP)>        PdopSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::IntegerClass,          9, has(GPS_DECODER_FIELD_FIXED_TYPE)> FixedTypeSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::SatelliteSystemClass, 10, hasSystem(GPS_DECODER_SYSTEM_GPS)>     GpsSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::SatelliteSystemClass, 11, hasSystem(GPS_DECODER_SYSTEM_GLONASS)> GlonassSlot;
+      typedef GpsDecoderSlot<GpsDecoderClass::SatelliteSystemClass, 12, hasSystem(GPS_DECODER_SYSTEM_BAIDU)>   BaiduSlot;
+};
+
+
+template <class Config = GpsDecoderDefaultConfig>
+class GpsDecoder : private GpsDecoderLayout<Config>::LocationSlot,
+                   private GpsDecoderLayout<Config>::DateSlot,
+                   private GpsDecoderLayout<Config>::TimeSlot,
+                   private GpsDecoderLayout<Config>::SpeedSlot,
+                   private GpsDecoderLayout<Config>::CourseSlot,
+                   private GpsDecoderLayout<Config>::AltitudeSlot,
+                   private GpsDecoderLayout<Config>::HdopSlot,
+                   private GpsDecoderLayout<Config>::VdopSlot,
+                   private GpsDecoderLayout<Config>::PdopSlot,
+                   private GpsDecoderLayout<Config>::FixedTypeSlot,
+                   private GpsDecoderLayout<Config>::GpsSlot,
+                   private GpsDecoderLayout<Config>::GlonassSlot,
+                   private GpsDecoderLayout<Config>::BaiduSlot
+{
+   friend class GpsDecoderClass;                                           // Calls scanField from the shared state machine
+
+   public:
+      typedef GpsDecoderClass::LocationClass LocationClass;
+      typedef GpsDecoderClass::DateClass DateClass;
+      typedef GpsDecoderClass::TimeClass TimeClass;
+      typedef GpsDecoderClass::SpeedClass SpeedClass;
+      typedef GpsDecoderClass::DecimalClass DecimalClass;
+      typedef GpsDecoderClass::CourseClass CourseClass;
+      typedef GpsDecoderClass::AltitudeClass AltitudeClass;
+      typedef GpsDecoderClass::IntegerClass IntegerClass;
+      typedef GpsDecoderClass::SatelliteSystemClass SatelliteSystemClass;
+
+   private:
+      typedef GpsDecoderLayout<Config> Layout;
+      typedef typename Config::Handler Handler;
+      typedef GpsDecoderClass::FieldClass FieldClass;
+      typedef GpsDecoderClass::SentenceClass SentenceClass;
+
+      // Sentences which are decoded, sentences which can not update any enabled field are skipped
+      static constexpr uint16_t sentences()
+      {
+         return Config::sentences & GPS_DECODER_SENTENCE_MASK &
+            ((Layout::has(GPS_DECODER_FIELD_TIME | GPS_DECODER_FIELD_LOCATION | GPS_DECODER_FIELD_ALTITUDE) ? GPS_DECODER_SENTENCE_GGA : 0) |
+             (Layout::has(GPS_DECODER_FIELD_TIME | GPS_DECODER_FIELD_LOCATION | GPS_DECODER_FIELD_SPEED | GPS_DECODER_FIELD_DATE) ? GPS_DECODER_SENTENCE_RMC : 0) |
+             (Layout::has(GPS_DECODER_FIELD_DOP | GPS_DECODER_FIELD_FIXED_TYPE | GPS_DECODER_FIELD_SATELLITES) ? GPS_DECODER_SENTENCE_GSA : 0) |
+             (Layout::has(GPS_DECODER_FIELD_SATELLITES) ? GPS_DECODER_SENTENCE_GSV : 0) |
+             (Layout::has(GPS_DECODER_FIELD_SPEED | GPS_DECODER_FIELD_COURSE) ? GPS_DECODER_SENTENCE_VTG : 0));
+      }
+      static constexpr uint8_t talkers()     { return Config::talkers & GPS_DECODER_TALKER_MASK; }
+
+      // parsing state variables, same as in GpsDecoderClass
+      GpsDecoderClass::FrameStateClass frame;                               // State of the frame currently received
+
+      // statistics
+      uint32_t decodedCharCount;                                            // Endless increasing number of encoded chars
+      uint32_t failedChecksumCount;                                         // Endless increasing number of failed checksum messages
+      uint32_t passedChecksumCount;                                         // Endless increasing number of passed checksum messages
+      uint32_t skippedSentenceCount;                                        // Endless increasing number of skipped sentences
+
+      // Storage of the fields, NULL if the field is disabled
+      LocationClass *locationSlot()          { return this->Layout::LocationSlot::slot(); }
+      DateClass *dateSlot()                  { return this->Layout::DateSlot::slot(); }
+      TimeClass *timeSlot()                  { return this->Layout::TimeSlot::slot(); }
+      SpeedClass *speedSlot()                { return this->Layout::SpeedSlot::slot(); }
+      CourseClass *courseSlot()              { return this->Layout::CourseSlot::slot(); }
+      AltitudeClass *altitudeSlot()          { return this->Layout::AltitudeSlot::slot(); }
+      DecimalClass *hdopSlot()               { return this->Layout::HdopSlot::slot(); }
+      DecimalClass *vdopSlot()               { return this->Layout::VdopSlot::slot(); }
+      DecimalClass *pdopSlot()               { return this->Layout::PdopSlot::slot(); }
+      IntegerClass *fixedTypeSlot()          { return this->Layout::FixedTypeSlot::slot(); }
+      SatelliteSystemClass *gpsSlot()        { return this->Layout::GpsSlot::slot(); }
+      SatelliteSystemClass *glonassSlot()    { return this->Layout::GlonassSlot::slot(); }
+      SatelliteSystemClass *baiduSlot()      { return this->Layout::BaiduSlot::slot(); }
+
+
+      // Parse a field into the current sentence and continue with the next, called by GpsDecoderClass::scanChar
+      // Sentences, which are not enabled in the config, are skipped right behind their identifier
+      GpsDecoderClass::FrameEvent scanField(GpsDecoderClass::FrameStateClass &frame, const FieldClass &field)
+      {
+         GpsDecoderClass::FrameEvent event = GpsDecoderClass::FRAME_NONE;
+
+         if (frame.currentFieldIndex == 0)
+         {
+            if (field.len == 5)
+            {
+               frame.currentSentence.talker = GpsDecoderClass::talkerCode(field.str[0], field.str[1]);
+               frame.currentSentence.type = GpsDecoderClass::sentenceCode(field.str[2], field.str[3], field.str[4]);
+            }
+            if (!(sentences() & GpsDecoderClass::sentenceFilterBit(frame.currentSentence.type)) ||
+                !(talkers() & GpsDecoderClass::talkerFilterBit(frame.currentSentence.talker)))
+            {
+               frame.waitForFrameStart = false;
+               event = GpsDecoderClass::FRAME_SKIPPED;
+            }
+         }
+         else
+         {
+            parseField(field);
+         }
+
+         frame.currentFieldOffset = 0;
+         if (frame.currentFieldIndex < 0xff) frame.currentFieldIndex++;
+
+         return event;
+      }
+
+      // Count a frame finished by the state machine and commit its sentence, see GpsDecoderClass::commitFrame
+      bool commitFrame(GpsDecoderClass::FrameEvent event)
+      {
+         switch (event)
+         {
+            case GpsDecoderClass::FRAME_SKIPPED:
+               skippedSentenceCount++;
+               return false;
+
+            case GpsDecoderClass::FRAME_NO_CHECKSUM:
+               GPS_DECODER_LOG("GPS decoder: No * in frame found\n");
+               return false;
+
+            case GpsDecoderClass::FRAME_INCOMPLETE_CHECKSUM:
+            case GpsDecoderClass::FRAME_INVALID_CHECKSUM:
+               GPS_DECODER_LOG("GPS decoder: Invalid checksum\n");
+               failedChecksumCount++;
+               Handler::onChecksumFailure(*this);
+               return false;
+
+            case GpsDecoderClass::FRAME_PASSED:
+               passedChecksumCount++;
+               return commitSentence(frame.currentSentence);
+
+            default:
+               return false;
+         }
+      }
+
+      // Only the parsers of enabled sentences are referenced
+      void parseField(const FieldClass &field)
+      {
+         switch(frame.currentSentence.type)
+         {
+            case GpsDecoderClass::sentenceCode('G','G','A'):
+               if (sentences() & GPS_DECODER_SENTENCE_GGA) GpsDecoderClass::parseFieldGGA(frame.currentSentence, frame.currentFieldIndex, field);
+               break;
+
+            case GpsDecoderClass::sentenceCode('R','M','C'):
+               if (sentences() & GPS_DECODER_SENTENCE_RMC) GpsDecoderClass::parseFieldRMC(frame.currentSentence, frame.currentFieldIndex, field);
+               break;
+
+            case GpsDecoderClass::sentenceCode('G','S','A'):
+               if (sentences() & GPS_DECODER_SENTENCE_GSA) GpsDecoderClass::parseFieldGSA(frame.currentSentence, frame.currentFieldIndex, field);
+               break;
+
+            case GpsDecoderClass::sentenceCode('G','S','V'):
+               if (sentences() & GPS_DECODER_SENTENCE_GSV) GpsDecoderClass::parseFieldGSV(frame.currentSentence, frame.currentFieldIndex, field);
+               break;
+
+            case GpsDecoderClass::sentenceCode('V','T','G'):
+               if (sentences() & GPS_DECODER_SENTENCE_VTG) GpsDecoderClass::parseFieldVTG(frame.currentSentence, frame.currentFieldIndex, field);
+               break;
+
+            default:
+               break;
+         }
+      }
+
+      // Commit the staged values of a sentence which passed the checksum test, see GpsDecoderClass::commitSentence
+      bool commitSentence(const SentenceClass &sentence)
+      {
+         switch(sentence.type)
+         {
+            case GpsDecoderClass::sentenceCode('G','G','A'):
+               commitGGA(sentence);
+               Handler::onGGA(*this);
+               return true;
+
+            case GpsDecoderClass::sentenceCode('R','M','C'):
+               commitRMC(sentence);
+               Handler::onRMC(*this);
+               return true;
+
+            case GpsDecoderClass::sentenceCode('G','S','A'):
+               return commitGSA(sentence);
+
+            case GpsDecoderClass::sentenceCode('G','S','V'):
+               return commitGSV(sentence);
+
+            case GpsDecoderClass::sentenceCode('V','T','G'):
+               return commitVTG(sentence);
+
+            default:
+               return false;
+         }
+      }
+
+      // Commit time and location of GGA and RMC
+      void commitTime(const SentenceClass &sentence)
+      {
+         TimeClass *time = timeSlot();
+         if (time)
+         {
+            time->setTime(sentence.time);
+            time->commit();
+         }
+      }
+
+      void commitLocation(const SentenceClass &sentence)
+      {
+         LocationClass *location = locationSlot();
+         if (location)
+         {
+            location->setLatitude(sentence.latitude);
+            location->setLongitude(sentence.longitude);
+            location->commit();
+         }
+      }
+
+      // Set and commit a decimal field, if it is enabled
+      static void commitDecimal(DecimalClass *decimal, int32_t hundredths)
+      {
+         if (decimal)
+         {
+            decimal->set(hundredths);
+            decimal->commit();
+         }
+      }
+
+      bool commitRMC(const SentenceClass &sentence)
+      {
+         if (sentence.isValid(1)) commitTime(sentence);
+         bool located = sentence.status == 'A' && sentence.isValid(3) && sentence.isValid(5);
+         if (located) commitLocation(sentence);
+         if (sentence.isValid(7)) commitDecimal(speedSlot(), sentence.speed);
+
+         DateClass *date = dateSlot();
+         if (date && sentence.isValid(9))
+         {
+            date->setDate(sentence.date);
+            date->commit();
+         }
+
+         // The handler sees all fields of the sentence
+         if (located && locationSlot()) Handler::onLocation(*this);
+         return true;
+      }
+
+      bool commitGGA(const SentenceClass &sentence)
+      {
+         if (sentence.isValid(1)) commitTime(sentence);
+         bool located = sentence.isValid(2) && sentence.isValid(4);
+         if (located) commitLocation(sentence);
+         if (sentence.isValid(9)) commitDecimal(altitudeSlot(), sentence.altitude);
+
+         if (located && locationSlot()) Handler::onLocation(*this);
+         return true;
+      }
+
+      bool commitGSA(const SentenceClass &sentence)
+      {
+         if (sentence.isValid(16)) commitDecimal(hdopSlot(), sentence.hdop);
+         if (sentence.isValid(17)) commitDecimal(vdopSlot(), sentence.vdop);
+         if (sentence.isValid(15)) commitDecimal(pdopSlot(), sentence.pdop);
+
+         IntegerClass *fixedType = fixedTypeSlot();
+         if (fixedType && sentence.isValid(2))
+         {
+            fixedType->set(sentence.fixedType);
+            fixedType->commit();
+         }
+
+         // System id is only available since NMEA 4.1, older receivers send one GSA per talker
+         SatelliteSystemClass *system = sentence.isValid(18) ? satelliteSystemById(sentence.systemId) : satelliteSystemByTalker(sentence.talker);
+         if (system) system->commitGSA(sentence);
+
+         return true;
+      }
+
+      bool commitGSV(const SentenceClass &sentence)
+      {
+         if (!sentence.isValid(1) || !sentence.isValid(2) || !sentence.isValid(3)) return true;
+
+         SatelliteSystemClass *system = satelliteSystemByTalker(sentence.talker);
+         if (system && system->commitGSV(sentence)) Handler::onSkyView(*this);
+
+         return true;
+      }
+
+      bool commitVTG(const SentenceClass &sentence)
+      {
+         if (sentence.status == 'T' && sentence.isValid(1) && sentence.isValid(5))
+         {
+            commitDecimal(speedSlot(), sentence.speed);
+            commitDecimal(courseSlot(), sentence.course);
+         }
+
+         return true;
+      }
+
+      // Satellite system for a NMEA 4.1 system id or talker, NULL if it is not tracked or disabled
+      SatelliteSystemClass *satelliteSystemById(uint32_t systemId)
+      {
+         switch (systemId)
+         {
+            case 1:  return gpsSlot();
+            case 2:  return glonassSlot();
+            case 4:  return baiduSlot();
+            default: return NULL;
+         }
+      }
+
+      SatelliteSystemClass *satelliteSystemByTalker(uint16_t talker)
+      {
+         switch (talker)
+         {
+            case GpsDecoderClass::talkerCode('G','P'): return gpsSlot();
+            case GpsDecoderClass::talkerCode('G','L'): return glonassSlot();
+            case GpsDecoderClass::talkerCode('B','D'):
+            case GpsDecoderClass::talkerCode('G','B'): return baiduSlot();
+            default:                                   return NULL;
+         }
+      }
+
+
+   public:
+      GpsDecoder()
+      {
+         static_assert(Config::ramBudget == 0 || sizeof(GpsDecoder) <= Config::ramBudget, "GpsDecoder: sizeof exceeds ramBudget of the config");
+
+         decodedCharCount = 0;
+         failedChecksumCount = 0;
+         passedChecksumCount = 0;
+         skippedSentenceCount = 0;
+      }
+
+      // process one character received from GPS
+      bool decode(char currentChar)
+      {
+         decodedCharCount++;
+
+         GpsDecoderClass::FrameEvent event = GpsDecoderClass::scanChar(frame, currentChar, *this);
+         return event != GpsDecoderClass::FRAME_NONE && commitFrame(event);
+      }
+
+      // process a buffer received from GPS, returns number of decoded frames, see GpsDecoderClass::decode
+      size_t decode(const char *buffer, size_t length)
+      {
+         size_t decodedFrames = 0;
+
+         decodedCharCount += length;
+
+         while (length > 0)
+         {
+            size_t used;
+            GpsDecoderClass::FrameEvent event = GpsDecoderClass::scanFrame(frame, buffer, length, used, *this);
+
+            buffer += used;
+            length -= used;
+            if (event != GpsDecoderClass::FRAME_NONE && commitFrame(event)) decodedFrames++;
+         }
+
+         return decodedFrames;
+      }
+
+      uint32_t charsProcessed()   const { return decodedCharCount; }        // Returns total number of processed chars
+      uint32_t failedChecksum()   const { return failedChecksumCount; }     // Returns total number of failed checksum messages
+      uint32_t passedChecksum()   const { return passedChecksumCount; }     // Returns total number of passed checksum messages
+      uint32_t skippedSentences() const { return skippedSentenceCount; }    // Returns total number of sentences skipped by the config
+
+      // Fields, accessing a field which is disabled in the config fails to compile
+      LocationClass &location()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_LOCATION), "GpsDecoder: location is disabled in the config"); return *locationSlot(); }
+      DateClass &date()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_DATE), "GpsDecoder: date is disabled in the config"); return *dateSlot(); }
+      TimeClass &time()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_TIME), "GpsDecoder: time is disabled in the config"); return *timeSlot(); }
+      SpeedClass &speed()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_SPEED), "GpsDecoder: speed is disabled in the config"); return *speedSlot(); }
+      CourseClass &course()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_COURSE), "GpsDecoder: course is disabled in the config"); return *courseSlot(); }
+      AltitudeClass &altitude()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_ALTITUDE), "GpsDecoder: altitude is disabled in the config"); return *altitudeSlot(); }
+      DecimalClass &hdop()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_DOP), "GpsDecoder: dop is disabled in the config"); return *hdopSlot(); }
+      DecimalClass &vdop()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_DOP), "GpsDecoder: dop is disabled in the config"); return *vdopSlot(); }
+      DecimalClass &pdop()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_DOP), "GpsDecoder: dop is disabled in the config"); return *pdopSlot(); }
+      IntegerClass &fixedType()
+         { static_assert(Layout::has(GPS_DECODER_FIELD_FIXED_TYPE), "GpsDecoder: fixed type is disabled in the config"); return *fixedTypeSlot(); }
+      SatelliteSystemClass &gps()
+         { static_assert(Layout::hasSystem(GPS_DECODER_SYSTEM_GPS), "GpsDecoder: GPS satellites are disabled in the config"); return *gpsSlot(); }
+      SatelliteSystemClass &glonass()
+         { static_assert(Layout::hasSystem(GPS_DECODER_SYSTEM_GLONASS), "GpsDecoder: GLONASS satellites are disabled in the config"); return *glonassSlot(); }
+      SatelliteSystemClass &baidu()
+         { static_assert(Layout::hasSystem(GPS_DECODER_SYSTEM_BAIDU), "GpsDecoder: Baidu satellites are disabled in the config"); return *baiduSlot(); }
+};
+
+
+
+
+#endif
@@ -0,0 +1,561 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains a compact columnar file format for fix records
+///
+/// Only for hosts with files, not needed and not included on MCUs. Fix records are stored in
+/// blocks of GPS_DECODER_TRACK_BLOCK records. Within a block every field of the record is an own
+/// column, each value is stored as zigzag varint of the difference to the value in front, so
+/// a fix at 1 Hz takes about 20 bytes instead of 48 bytes of FixRecord or 400 bytes of NMEA.
+///
+/// GpsDecoderTrack::Writer writer;
+/// writer.open("truck17.track");
+/// decoder.onEpoch(GpsDecoderTrack::Writer::publish, &writer);
+/// ...
+/// writer.close();                                            // Writes the last block and the index
+///
+/// GpsDecoderTrack::Reader reader;                            // Maps the file, decodes only requested blocks
+/// reader.open("truck17.track");
+/// for (size_t i = reader.seek(from); i < reader.blocks(); i++) reader.readBlock(i, records);
+///
+/// File layout, all numbers little endian:
+///   Header   "GPST", version 16 bit, columns 16 bit
+///   Blocks   columns of varints, followed by the block footer: "GPSB", records, valid fields
+///            of any record, min and max time, bounding box and the end of every column
+///   Index    per block: offset, size, min and max time
+///   Trailer  offset of the index 64 bit, number of blocks 32 bit, "GPSI"
+///
+/// Time is centiseconds since 01.01.2000 UTC, 0 for records without date or time. The index
+/// is sorted by time, if the records are written in time order, then seek() is a binary search.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+#ifndef GPS_DECODER_TRACK_H_
+#define GPS_DECODER_TRACK_H_
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define GPS_DECODER_TRACK_BLOCK           1024                // Records per block
+#define GPS_DECODER_TRACK_VERSION         1
+
+
+// ******************************************************************
+// Class
+// ******************************************************************
+class GpsDecoderTrack
+{
+   private:
+      static const size_t COLUMNS = 15;
+      static const size_t HEADER_SIZE = 8;
+      static const size_t FOOTER_SIZE = 44 + 4 * COLUMNS;
+      static const size_t INDEX_ENTRY_SIZE = 28;
+      static const size_t TRAILER_SIZE = 16;
+
+   public:
+      typedef GpsDecoderClass::FixRecord FixRecord;
+
+      struct BlockInfo                                         // Block footer, readable without decoding the block
+      {
+         uint32_t records;                                     // Number of records
+         uint16_t valid;                                       // GPS_DECODER_FIELD_xxx valid in any of the records
+         uint64_t minTime, maxTime;                            // Of the records with date and time, 0 if there is none
+         int32_t minLatE7, maxLatE7, minLngE7, maxLngE7;       // Bounding box of the records with location
+      };
+
+      class Writer
+      {
+         public:
+            Writer() : file(NULL), offset(0), totalRecords(0), failed(false)   { startBlock(); }
+            ~Writer()   { close(); }
+
+            // Create or truncate a track file, returns false on error
+            bool open(const char *path)
+            {
+               close();
+
+               file = fopen(path, "wb");
+               if (!file) return false;
+
+               uint8_t header[HEADER_SIZE];
+               memcpy(header, "GPST", 4);
+               put16(header + 4, GPS_DECODER_TRACK_VERSION);
+               put16(header + 6, COLUMNS);
+
+               offset = 0;
+               totalRecords = 0;
+               failed = false;
+               index.clear();
+               startBlock();
+               write(header, sizeof(header));
+               return !failed;
+            }
+
+            // Add a record, a full block is written, returns false if the file is not open or on a write error
+            bool append(const FixRecord &record)
+            {
+               if (!file || failed) return false;
+
+               int64_t values[COLUMNS];
+               toColumns(record, values);
+
+               for (size_t i = 0; i < COLUMNS; i++)
+               {
+                  putVarint(columns[i], zigzag(values[i] - previous[i]));
+                  previous[i] = values[i];
+               }
+
+               uint64_t time = timestamp(record);
+               if (time)
+               {
+                  if (!info.minTime || time < info.minTime) info.minTime = time;
+                  if (time > info.maxTime) info.maxTime = time;
+               }
+               if (record.valid & GPS_DECODER_FIELD_LOCATION)
+               {
+                  if (!(info.valid & GPS_DECODER_FIELD_LOCATION))
+                  {
+                     info.minLatE7 = info.maxLatE7 = record.latE7;
+                     info.minLngE7 = info.maxLngE7 = record.lngE7;
+                  }
+                  if (record.latE7 < info.minLatE7) info.minLatE7 = record.latE7;
+                  if (record.latE7 > info.maxLatE7) info.maxLatE7 = record.latE7;
+                  if (record.lngE7 < info.minLngE7) info.minLngE7 = record.lngE7;
+                  if (record.lngE7 > info.maxLngE7) info.maxLngE7 = record.lngE7;
+               }
+               info.valid |= record.valid;
+               info.records++;
+               totalRecords++;
+
+               if (info.records == GPS_DECODER_TRACK_BLOCK) writeBlock();
+               return !failed;
+            }
+
+            // Write the last block and the index and close the file, returns false on any error since open
+            bool close()
+            {
+               if (!file) return false;
+
+               if (info.records) writeBlock();
+
+               uint64_t indexOffset = offset;
+               for (size_t i = 0; i < index.size(); i++)
+               {
+                  uint8_t entry[INDEX_ENTRY_SIZE];
+                  put64(entry, index[i].offset);
+                  put32(entry + 8, index[i].size);
+                  put64(entry + 12, index[i].minTime);
+                  put64(entry + 20, index[i].maxTime);
+                  write(entry, sizeof(entry));
+               }
+
+               uint8_t trailer[TRAILER_SIZE];
+               put64(trailer, indexOffset);
+               put32(trailer + 8, (uint32_t)index.size());
+               memcpy(trailer + 12, "GPSI", 4);
+               write(trailer, sizeof(trailer));
+
+               if (fclose(file) != 0) failed = true;
+               file = NULL;
+               return !failed;
+            }
+
+            uint64_t records() const   { return totalRecords; }   // Records appended since open
+
+            // Epoch handler, context is the writer, see GpsDecoderClass::onEpoch
+            static void publish(const FixRecord &record, void *writer)   { static_cast<Writer *>(writer)->append(record); }
+
+         private:
+            struct IndexEntry
+            {
+               uint64_t offset;
+               uint32_t size;
+               uint64_t minTime, maxTime;
+            };
+
+            FILE *file;
+            uint64_t offset;                                   // Bytes written
+            uint64_t totalRecords;
+            bool failed;                                       // A write failed since open
+            std::vector<uint8_t> columns[COLUMNS];             // Varints of the current block
+            int64_t previous[COLUMNS];                         // Last value of every column
+            BlockInfo info;                                    // Footer of the current block
+            std::vector<IndexEntry> index;
+
+            void startBlock()
+            {
+               for (size_t i = 0; i < COLUMNS; i++)
+               {
+                  columns[i].clear();
+                  previous[i] = 0;
+               }
+               memset(&info, 0, sizeof(info));
+            }
+
+            void write(const void *data, size_t length)
+            {
+               if (length && fwrite(data, 1, length, file) != length) failed = true;
+               offset += length;
+            }
+
+            void writeBlock()
+            {
+               IndexEntry entry;
+               uint8_t footer[FOOTER_SIZE];
+               uint32_t columnEnd = 0;
+
+               entry.offset = offset;
+               entry.minTime = info.minTime;
+               entry.maxTime = info.maxTime;
+
+               memcpy(footer, "GPSB", 4);
+               put32(footer + 4, info.records);
+               put16(footer + 8, info.valid);
+               put16(footer + 10, 0);
+               put64(footer + 12, info.minTime);
+               put64(footer + 20, info.maxTime);
+               put32(footer + 28, (uint32_t)info.minLatE7);
+               put32(footer + 32, (uint32_t)info.maxLatE7);
+               put32(footer + 36, (uint32_t)info.minLngE7);
+               put32(footer + 40, (uint32_t)info.maxLngE7);
+
+               for (size_t i = 0; i < COLUMNS; i++)
+               {
+                  write(columns[i].data(), columns[i].size());
+                  columnEnd += columns[i].size();
+                  put32(footer + 44 + 4 * i, columnEnd);
+               }
+               write(footer, sizeof(footer));
+
+               entry.size = columnEnd + FOOTER_SIZE;
+               index.push_back(entry);
+               startBlock();
+            }
+      };
+
+      class Reader
+      {
+         public:
+            Reader() : data(NULL), length(0), indexOffset(0), blockCount(0), totalRecords(0) {}
+            ~Reader()   { close(); }
+
+            // Map a track file and check its header, trailer and index, returns false on error
+            bool open(const char *path)
+            {
+               close();
+
+               int file = ::open(path, O_RDONLY);
+               if (file < 0) return false;
+
+               struct stat status;
+               if (fstat(file, &status) != 0 || (size_t)status.st_size < HEADER_SIZE + TRAILER_SIZE)
+               {
+                  ::close(file);
+                  return false;
+               }
+
+               length = (size_t)status.st_size;
+               void *mapped = mmap(NULL, length, PROT_READ, MAP_PRIVATE, file, 0);
+               ::close(file);
+               if (mapped == MAP_FAILED)
+               {
+                  length = 0;
+                  return false;
+               }
+               data = (const uint8_t *)mapped;
+
+               if (!check())
+               {
+                  close();
+                  return false;
+               }
+               return true;
+            }
+
+            void close()
+            {
+               if (data) munmap((void *)data, length);
+               data = NULL;
+               length = 0;
+               blockCount = 0;
+               totalRecords = 0;
+            }
+
+            size_t blocks() const      { return blockCount; }     // Number of blocks
+            uint64_t records() const   { return totalRecords; }   // Number of records in all blocks
+
+            // Footer of a block, without decoding it
+            bool blockInfo(size_t block, BlockInfo &info) const
+            {
+               if (block >= blockCount) return false;
+
+               const uint8_t *footer = data + blockOffset(block) + blockSize(block) - FOOTER_SIZE;
+               info.records = get32(footer + 4);
+               info.valid = get16(footer + 8);
+               info.minTime = get64(footer + 12);
+               info.maxTime = get64(footer + 20);
+               info.minLatE7 = (int32_t)get32(footer + 28);
+               info.maxLatE7 = (int32_t)get32(footer + 32);
+               info.minLngE7 = (int32_t)get32(footer + 36);
+               info.maxLngE7 = (int32_t)get32(footer + 40);
+               return true;
+            }
+
+            // First block, which ends at or behind time, blocks() if there is none
+            // Binary search over the index, the records must have been written in time order
+            size_t seek(uint64_t time) const
+            {
+               size_t low = 0, high = blockCount;
+
+               while (low < high)
+               {
+                  size_t middle = low + (high - low) / 2;
+                  if (get64(indexEntry(middle) + 20) < time) low = middle + 1;
+                  else high = middle;
+               }
+               return low;
+            }
+
+            // Decode all records of a block, records is replaced, returns false if the block is corrupt
+            bool readBlock(size_t block, std::vector<FixRecord> &records) const
+            {
+               records.clear();
+               if (block >= blockCount) return false;
+
+               const uint8_t *begin = data + blockOffset(block);
+               const uint8_t *footer = begin + blockSize(block) - FOOTER_SIZE;
+               uint32_t count = get32(footer + 4);
+
+               records.resize(count);
+
+               // Column by column, so only one column is decoded at a time
+               uint32_t columnBegin = 0;
+               for (size_t i = 0; i < COLUMNS; i++)
+               {
+                  uint32_t columnEnd = get32(footer + 44 + 4 * i);
+                  const uint8_t *read = begin + columnBegin;
+                  const uint8_t *end = begin + columnEnd;
+                  int64_t value = 0;
+
+                  for (uint32_t j = 0; j < count; j++)
+                  {
+                     uint64_t delta;
+                     if (!getVarint(read, end, delta))
+                     {
+                        records.clear();
+                        return false;
+                     }
+                     value += unzigzag(delta);
+                     fromColumn(records[j], i, value);
+                  }
+                  columnBegin = columnEnd;
+               }
+               return true;
+            }
+
+         private:
+            const uint8_t *data;                               // Mapped file
+            size_t length;
+            uint64_t indexOffset;
+            size_t blockCount;
+            uint64_t totalRecords;
+
+            const uint8_t *indexEntry(size_t block) const   { return data + indexOffset + block * INDEX_ENTRY_SIZE; }
+            uint64_t blockOffset(size_t block) const        { return get64(indexEntry(block)); }
+            uint32_t blockSize(size_t block) const          { return get32(indexEntry(block) + 8); }
+
+            // Check that all offsets are within the file, so the accessors do not need to
+            bool check()
+            {
+               if (memcmp(data, "GPST", 4) != 0 || get16(data + 4) != GPS_DECODER_TRACK_VERSION || get16(data + 6) != COLUMNS) return false;
+
+               const uint8_t *trailer = data + length - TRAILER_SIZE;
+               if (memcmp(trailer + 12, "GPSI", 4) != 0) return false;
+
+               indexOffset = get64(trailer);
+               blockCount = get32(trailer + 8);
+               if (indexOffset < HEADER_SIZE || indexOffset > length - TRAILER_SIZE ||
+                   (length - TRAILER_SIZE - indexOffset) / INDEX_ENTRY_SIZE < blockCount) return false;
+
+               for (size_t i = 0; i < blockCount; i++)
+               {
+                  uint64_t begin = blockOffset(i);
+                  uint32_t size = blockSize(i);
+                  if (begin < HEADER_SIZE || size < FOOTER_SIZE || begin > indexOffset || size > indexOffset - begin) return false;
+
+                  const uint8_t *footer = data + begin + size - FOOTER_SIZE;
+                  if (memcmp(footer, "GPSB", 4) != 0 || get32(footer + 44 + 4 * (COLUMNS - 1)) != size - FOOTER_SIZE) return false;
+
+                  // Every record takes at least one byte in every column
+                  uint32_t records = get32(footer + 4);
+                  uint32_t columnBegin = 0;
+                  for (size_t j = 0; j < COLUMNS; j++)
+                  {
+                     uint32_t columnEnd = get32(footer + 44 + 4 * j);
+                     if (columnEnd < columnBegin || columnEnd - columnBegin < records) return false;
+                     columnBegin = columnEnd;
+                  }
+                  totalRecords += records;
+               }
+               return true;
+            }
+      };
+
+      // Centiseconds since 01.01.2000 UTC, 0 if the record has no date or time
+      static uint64_t timestamp(const FixRecord &record)
+      {
+         if ((record.valid & (GPS_DECODER_FIELD_DATE | GPS_DECODER_FIELD_TIME)) != (GPS_DECODER_FIELD_DATE | GPS_DECODER_FIELD_TIME)) return 0;
+         return timestamp(record.date, record.time);
+      }
+
+      // Centiseconds since 01.01.2000 UTC of ddmmyy and hhmmsscc
+      static uint64_t timestamp(uint32_t date, uint32_t time)
+      {
+         // Days since 01.01.2000 of the proleptic Gregorian calendar, the year is 2000 + yy
+         int32_t day = date / 10000;
+         int32_t month = (date / 100) % 100;
+         int32_t year = 2000 + date % 100 - (month <= 2);
+         int32_t era = year / 400;
+         int32_t yearOfEra = year - era * 400;
+         int32_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+         int32_t days = era * 146097 + yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear - 730425;
+
+         uint32_t hours = time / 1000000;
+         uint32_t minutes = (time / 10000) % 100;
+         uint32_t seconds = (time / 100) % 100;
+         uint32_t centiseconds = time % 100;
+
+         return (uint64_t)days * 8640000 + ((hours * 60 + minutes) * 60 + seconds) * 100 + centiseconds;
+      }
+
+      // Centiseconds since 01.01.2000 UTC of the location of a decoder, last is the result for the location before
+      // GGA has no date, so a GGA position right behind midnight still has the date of the RMC of the day before.
+      // A time more than half a day behind last is moved to the next day. 0 without date or time.
+      static uint64_t locationTime(GpsDecoderClass &decoder, uint64_t last)
+      {
+         if (!decoder.date.isValid() || !decoder.time.isValid()) return 0;
+
+         uint64_t time = timestamp(decoder.date.value(), decoder.time.value());
+         if (time + 4320000 < last && last - time < 8640000) time += 8640000;
+         return time;
+      }
+
+      // Inverse of timestamp, ddmmyy and hhmmsscc
+      static void dateTime(uint64_t timestamp, uint32_t &date, uint32_t &time)
+      {
+         uint32_t days = (uint32_t)(timestamp / 8640000) + 730425;
+         uint32_t rest = (uint32_t)(timestamp % 8640000);
+         uint32_t era = days / 146097;
+         uint32_t dayOfEra = days - era * 146097;
+         uint32_t yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+         uint32_t dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+         uint32_t shiftedMonth = (5 * dayOfYear + 2) / 153;
+         uint32_t day = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+         uint32_t month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+         uint32_t year = yearOfEra + era * 400 + (month <= 2);
+
+         date = day * 10000 + month * 100 + year % 100;
+         time = (rest / 360000) * 1000000 + (rest / 6000 % 60) * 10000 + (rest / 100 % 60) * 100 + rest % 100;
+      }
+
+   private:
+      static void toColumns(const FixRecord &record, int64_t *values)
+      {
+         values[0] = record.valid;
+         values[1] = record.sentences;
+         values[2] = record.time;
+         values[3] = record.date;
+         values[4] = record.latE7;
+         values[5] = record.lngE7;
+         values[6] = record.altitude;
+         values[7] = record.speed;
+         values[8] = record.course;
+         values[9] = record.hdop;
+         values[10] = record.vdop;
+         values[11] = record.pdop;
+         values[12] = record.fixedType;
+         values[13] = record.satellitesUsed;
+         values[14] = record.satellitesInView;
+      }
+
+      static void fromColumn(FixRecord &record, size_t column, int64_t value)
+      {
+         switch (column)
+         {
+            case 0:  record.valid = (uint16_t)value; break;
+            case 1:  record.sentences = (uint16_t)value; break;
+            case 2:  record.time = (uint32_t)value; break;
+            case 3:  record.date = (uint32_t)value; break;
+            case 4:  record.latE7 = (int32_t)value; break;
+            case 5:  record.lngE7 = (int32_t)value; break;
+            case 6:  record.altitude = (int32_t)value; break;
+            case 7:  record.speed = (int32_t)value; break;
+            case 8:  record.course = (int32_t)value; break;
+            case 9:  record.hdop = (int32_t)value; break;
+            case 10: record.vdop = (int32_t)value; break;
+            case 11: record.pdop = (int32_t)value; break;
+            case 12: record.fixedType = (uint8_t)value; break;
+            case 13: record.satellitesUsed = (uint8_t)value; break;
+            case 14: record.satellitesInView = (uint8_t)value; break;
+         }
+      }
+
+      static uint64_t zigzag(int64_t value)     { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+      static int64_t unzigzag(uint64_t value)   { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+      // 7 bits per byte, low bits first, bit 7 is set if another byte follows
+      static void putVarint(std::vector<uint8_t> &out, uint64_t value)
+      {
+         while (value >= 0x80)
+         {
+            out.push_back((uint8_t)(value | 0x80));
+            value >>= 7;
+         }
+         out.push_back((uint8_t)value);
+      }
+
+      static bool getVarint(const uint8_t *&read, const uint8_t *end, uint64_t &value)
+      {
+         value = 0;
+         for (uint8_t shift = 0; read < end && shift < 64; shift += 7)
+         {
+            uint8_t byte = *read++;
+            value |= (uint64_t)(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+         }
+         return false;
+      }
+
+      static void put16(uint8_t *p, uint16_t v)   { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+      static void put32(uint8_t *p, uint32_t v)   { put16(p, (uint16_t)v); put16(p + 2, (uint16_t)(v >> 16)); }
+      static void put64(uint8_t *p, uint64_t v)   { put32(p, (uint32_t)v); put32(p + 4, (uint32_t)(v >> 32)); }
+      static uint16_t get16(const uint8_t *p)     { return (uint16_t)(p[0] | (p[1] << 8)); }
+      static uint32_t get32(const uint8_t *p)     { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+      static uint64_t get64(const uint8_t *p)     { return get32(p) | ((uint64_t)get32(p + 4) << 32); }
+};
+
+
+
+
+#endif
@@ -0,0 +1,260 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the lossless NMEA codec of gpsDecoderArchive.h
+///
+/// BenchTrack logs are mixed with lines the decoder filters out or does not know, sentences with
+/// wrong or missing checksums, too many fields, too long numbers, more identifiers than slots,
+/// overlong lines, binary garbage and random damage. Compressed and decompressed in random pieces
+/// the log must come back byte exact. Damaged and truncated streams must not be accepted by finish().
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderArchive.h"
+#include "benchNmea.h"
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define LOGS                              16
+#define HEADER_BYTES                      5                   // "GPSZ" and version
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+
+// Lines which are no sentence of BenchTrack, each is followed by \r\n
+static const char *extraLines[] =
+{
+   "$GPTXT,01,01,02,ANTENNA OPEN*25",                                         // Filtered by the decoder
+   "$PUBX,00,081350.00,4717.113210,N,00833.915187,E,546.589,G3,2.1,2.0,0.007,77.52,0.007,,0.92,1.19,0.77,9,0,0*5F",
+   "$GNGGA,165520.000,4807.038,N,01131.000,E,1,07,2.7,101.0,M,48.3,M,,*00",  // Wrong checksum
+   "$GNGGA,165520.000,4807.038,N,01131.000,E,1,07,2.7,101.0,M,48.3,M,,",      // No checksum
+   "$GPGSV,3,3,10,29,1,1,1,30,2,2,2,0*",
+   "$,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,,*2C",
+   "$GNRMC,,V,,,,,,,,,,N,V*37",
+   "*3A",
+   "$",
+   "",
+};
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+static void collect(const uint8_t *data, size_t length, void *context)
+{
+   std::string &out = *(std::string *)context;
+   out.append((const char *)data, length);
+}
+
+// A sentence with a valid checksum, the body may be longer than benchSentence takes
+static std::string sentence(const std::string &body)
+{
+   uint8_t checksum = 0;
+   for (size_t i = 0; i < body.size(); i++) checksum ^= (uint8_t)body[i];
+
+   char tail[8];
+   snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+   return "$" + body + tail;
+}
+
+// A BenchTrack log with extra lines between its lines and random damage
+static std::string makeLog(int l)
+{
+   std::string track = BenchTrack::log(20000 + random(200000), l + 1), log;
+
+   for (size_t start = 0, end; start < track.size(); start = end)
+   {
+      end = track.find('\n', start);
+      end = end == std::string::npos ? track.size() : end + 1;
+      log.append(track, start, end - start);
+
+      switch (random(40))
+      {
+         case 0:
+            log += extraLines[random(sizeof(extraLines) / sizeof(extraLines[0]))];
+            log += random(4) ? "\r\n" : "\n";
+            break;
+         case 1:
+         {
+            // More identifiers than slots
+            char identifier[16];
+            snprintf(identifier, sizeof(identifier), "P%uXY", (unsigned)random(100));
+            log += sentence(std::string(identifier) + ",1,2,3.5," + std::to_string(random(1000000)));
+            break;
+         }
+         case 2:
+         {
+            // More fields than the codec has models for
+            std::string body = "GPZZZ";
+            for (size_t k = random(60); k > 0; k--) body += "," + std::to_string(random(100));
+            log += sentence(body);
+            break;
+         }
+         case 3:
+            // Binary garbage, with and without \n
+            for (size_t k = random(300); k > 0; k--) log += (char)random(256);
+            break;
+         case 4:
+            // Numbers longer than the codec takes as number, leading zeros, signs
+            log += sentence("GNGGA,165520.000,4807.0380000000000000000000001,N,01131.000,E,1,07,2.7,-0000101.0,M,+48.3,M,,");
+            break;
+         case 5:
+            // Longer than GPS_DECODER_ARCHIVE_MAX_LINE
+            log += "$GPTXT," + std::string(GPS_DECODER_ARCHIVE_MAX_LINE - 10 + random(2000), 'A') + "\r\n";
+            break;
+         default:
+            break;
+      }
+   }
+
+   for (size_t k = l % 2 ? random(log.size() / 300) : 0; k > 0; k--)
+   {
+      size_t position = random(log.size());
+      switch (random(3))
+      {
+         case 0:  log[position] = (char)random(256); break;
+         case 1:  log.erase(position, 1 + random(80)); break;
+         default: log.insert(position, 1, "$*\r\n,"[random(5)]); break;
+      }
+   }
+
+   // Last line without \n
+   if (l % 4 == 3) log += "$GNGGA,165520.000,4807.038,N";
+   return log;
+}
+
+static std::string compress(const std::string &log, size_t maxPiece)
+{
+   std::string compressed;
+   GpsDecoderArchive::Compressor compressor(collect, &compressed);
+
+   for (size_t offset = 0; offset < log.size();)
+   {
+      size_t count = random(maxPiece + 1);
+      if (count > log.size() - offset) count = log.size() - offset;
+      compressor.write(log.data() + offset, count);
+      offset += count;
+   }
+   compressor.finish();
+
+   CHECK(compressor.bytesIn() == log.size());
+   CHECK(compressor.bytesOut() == compressed.size());
+   return compressed;
+}
+
+// Returns finish(), out is the decompressed log
+static bool decompress(const std::string &compressed, size_t maxPiece, std::string &out)
+{
+   GpsDecoderArchive::Decompressor decompressor(collect, &out);
+   bool ok = true;
+
+   out.clear();
+   for (size_t offset = 0; offset < compressed.size();)
+   {
+      size_t count = random(maxPiece + 1);
+      if (count > compressed.size() - offset) count = compressed.size() - offset;
+      ok = decompressor.write((const uint8_t *)compressed.data() + offset, count) && ok;
+      offset += count;
+   }
+   return decompressor.finish() && ok;
+}
+
+// Damaged streams, all of them must give an error or decompress without crashing
+static void testCorrupt(const std::string &compressed)
+{
+   std::string out;
+
+   // Truncated, the end marker is missing
+   for (size_t i = 0; i < 100; i++)
+   {
+      size_t length = i < 20 ? i : random(compressed.size());
+      CHECK(!decompress(compressed.substr(0, length), 1 + random(5000), out));
+   }
+
+   // Bytes behind the end
+   CHECK(!decompress(compressed + '\0', 100000, out));
+   CHECK(!decompress(compressed + compressed, 100000, out));
+
+   // Wrong header
+   std::string damaged = compressed;
+   damaged[4] = GPS_DECODER_ARCHIVE_VERSION + 1;
+   CHECK(!decompress(damaged, 100000, out) && out.empty());
+   damaged = compressed;
+   damaged[0] = 'X';
+   CHECK(!decompress(damaged, 100000, out) && out.empty());
+
+   // Random bytes may be found or not
+   for (size_t i = 0; i < 100; i++)
+   {
+      damaged = compressed;
+      for (size_t k = 1 + random(4); k > 0; k--) damaged[HEADER_BYTES + random(damaged.size() - HEADER_BYTES)] = (char)random(256);
+      decompress(damaged, 1 + random(5000), out);
+   }
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   std::string compressed, out;
+   size_t logBytes = 0, compressedBytes = 0;
+
+   for (int l = 0; l < LOGS; l++)
+   {
+      std::string log = makeLog(l);
+
+      compressed = compress(log, l % 2 ? 10 : 100000);
+      CHECK(decompress(compressed, l % 3 ? 100000 : 7, out));
+      CHECK(out == log);
+      if (out != log) printf("log %d: %zu bytes back of %zu\n", l, out.size(), log.size());
+
+      logBytes += log.size();
+      compressedBytes += compressed.size();
+      if (l == 0) testCorrupt(compressed);
+   }
+
+   // An empty log is only the header and the end
+   compressed = compress(std::string(), 1);
+   CHECK(compressed.size() == HEADER_BYTES + 1);
+   CHECK(decompress(compressed, 1, out) && out.empty());
+
+   // A clean log
+   std::string log = BenchTrack::log(1000000);
+   compressed = compress(log, 65536);
+   CHECK(decompress(compressed, 65536, out) && out == log);
+   CHECK(compressed.size() * 10 < log.size());
+
+   printf("gpsDecoderArchive: %u failures, %zu bytes to %zu\n", failures, logBytes, compressedBytes);
+   return failures ? 1 : 0;
+}
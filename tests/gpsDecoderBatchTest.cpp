@@ -0,0 +1,212 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the batch distanceBetween and courseTo against the scalar ones
+///
+/// Random pairs of positions, 1 cm to 20000 km and nearly antipodal apart, some of them on both
+/// sides of 180 degrees longitude, are run through the batch functions of the selected kernel, in
+/// double, float and from a PreparedPointClass. Every result must be within the bounds given in
+/// gpsDecoder.cpp. Odd counts and offsets check the lanes behind the last full vector.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define POSITIONS                         200003
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+static std::vector<double> lat1, lng1, lat2, lng2;
+static std::vector<float> lat1F, lng1F, lat2F, lng2F;
+static std::vector<bool> antipodal;
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static double uniform(double low, double high)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return low + (high - low) * (randomState / 4294967296.0);
+}
+
+// Course difference across 0 / 360 degrees
+static double angleDifference(double a, double b)
+{
+   double difference = fabs(a - b);
+   return difference > 180 ? 360 - difference : difference;
+}
+
+// Double course bound of gpsDecoder.cpp
+static double courseBound(double distance, bool nearlyAntipodal)
+{
+   if (nearlyAntipodal) return 1e-6;
+   return distance > 1000 ? 1e-9 : 1e-5;
+}
+
+// Every fifth pair anywhere, every fifth nearly antipodal, every fifth close to 180 degrees longitude,
+// the others 1 cm to 100 km apart
+static void makePositions()
+{
+   for (size_t i = 0; i < POSITIONS; i++)
+   {
+      double lat = uniform(-89.9, 89.9), lng = uniform(-180, 180), otherLat, otherLng;
+
+      switch (i % 5)
+      {
+         case 0:
+            otherLat = uniform(-89.9, 89.9);
+            otherLng = uniform(-180, 180);
+            break;
+         case 4:
+            otherLat = -lat + uniform(-5e-4, 5e-4);
+            otherLng = lng + 180 + uniform(-5e-4, 5e-4);
+            if (otherLng > 180) otherLng -= 360;
+            break;
+         case 3:
+            lng = uniform(179, 180);
+            // fall through
+         default:
+         {
+            double offset = pow(10, uniform(-7, -0.05));          // 1 cm to 100 km
+            otherLat = fmax(-89.9, fmin(89.9, lat + uniform(-offset, offset)));
+            otherLng = lng + uniform(-offset, offset);
+            if (otherLng > 180) otherLng -= 360;
+            break;
+         }
+      }
+
+      lat1.push_back(lat);
+      lng1.push_back(lng);
+      lat2.push_back(otherLat);
+      lng2.push_back(otherLng);
+      lat1F.push_back((float)lat);
+      lng1F.push_back((float)lng);
+      lat2F.push_back((float)otherLat);
+      lng2F.push_back((float)otherLng);
+      antipodal.push_back(i % 5 == 4);
+   }
+}
+
+static void testDouble()
+{
+   std::vector<double> distances(POSITIONS), courses(POSITIONS);
+
+   GpsDecoderClass::distanceBetween(lat1.data(), lng1.data(), lat2.data(), lng2.data(), distances.data(), POSITIONS);
+   GpsDecoderClass::courseTo(lat1.data(), lng1.data(), lat2.data(), lng2.data(), courses.data(), POSITIONS);
+
+   for (size_t i = 0; i < POSITIONS; i++)
+   {
+      double distance = GpsDecoderClass::distanceBetween(lat1[i], lng1[i], lat2[i], lng2[i]);
+      double course = GpsDecoderClass::courseTo(lat1[i], lng1[i], lat2[i], lng2[i]);
+
+      CHECK(fabs(distances[i] - distance) <= 1e-8);
+      if (distance > 0.01) CHECK(angleDifference(courses[i], course) <= courseBound(distance, antipodal[i]));
+   }
+}
+
+// The scalar reference is the double function over the rounded inputs
+static void testFloat()
+{
+   std::vector<float> distances(POSITIONS), courses(POSITIONS);
+
+   GpsDecoderClass::distanceBetween(lat1F.data(), lng1F.data(), lat2F.data(), lng2F.data(), distances.data(), POSITIONS);
+   GpsDecoderClass::courseTo(lat1F.data(), lng1F.data(), lat2F.data(), lng2F.data(), courses.data(), POSITIONS);
+
+   for (size_t i = 0; i < POSITIONS; i++)
+   {
+      double distance = GpsDecoderClass::distanceBetween(lat1F[i], lng1F[i], lat2F[i], lng2F[i]);
+      double course = GpsDecoderClass::courseTo(lat1F[i], lng1F[i], lat2F[i], lng2F[i]);
+
+      CHECK(fabs(distances[i] - distance) <= 4 + 3e-7 * distance);
+      if (!antipodal[i] && distance > 1000) CHECK(angleDifference(courses[i], course) <= (distance > 100000 ? 0.005 : 0.2));
+   }
+}
+
+// From the first position of every pair to the second positions of all pairs
+static void testPrepared()
+{
+   std::vector<double> distances(POSITIONS), courses(POSITIONS);
+
+   for (size_t k = 0; k < 50; k++)
+   {
+      GpsDecoderClass::PreparedPointClass point(lat1[k], lng1[k]);
+
+      point.distanceTo(lat2.data(), lng2.data(), distances.data(), POSITIONS);
+      point.courseTo(lat2.data(), lng2.data(), courses.data(), POSITIONS);
+
+      for (size_t i = 0; i < POSITIONS; i++)
+      {
+         double distance = point.distanceTo(lat2[i], lng2[i]);
+         bool nearlyAntipodal = fabs(lat1[k] + lat2[i]) < 1e-3 && fabs(fabs(lng1[k] - lng2[i]) - 180) < 1e-3;
+
+         CHECK(fabs(distances[i] - distance) <= 1e-8);
+         if (distance > 0.01) CHECK(angleDifference(courses[i], point.courseTo(lat2[i], lng2[i])) <= courseBound(distance, nearlyAntipodal));
+      }
+   }
+}
+
+// Counts and offsets, which are no multiple of any vector width, must not touch anything behind count
+static void testTails()
+{
+   for (size_t offset = 0; offset < 5; offset++)
+   {
+      for (size_t count = 0; count <= 37; count++)
+      {
+         std::vector<double> distances(count + 1, -1.0);
+         std::vector<float> courses(count + 1, -1.0f);
+
+         GpsDecoderClass::distanceBetween(&lat1[offset], &lng1[offset], &lat2[offset], &lng2[offset], distances.data(), count);
+         GpsDecoderClass::courseTo(&lat1F[offset], &lng1F[offset], &lat2F[offset], &lng2F[offset], courses.data(), count);
+
+         for (size_t i = 0; i < count; i++)
+         {
+            CHECK(fabs(distances[i] - GpsDecoderClass::distanceBetween(lat1[offset + i], lng1[offset + i], lat2[offset + i], lng2[offset + i])) <= 1e-8);
+            CHECK(courses[i] >= 0.0f && courses[i] < 360.0f);
+         }
+         CHECK(distances[count] == -1.0 && courses[count] == -1.0f);
+      }
+   }
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   makePositions();
+
+   testDouble();
+   testFloat();
+   testPrepared();
+   testTails();
+
+   printf("gpsDecoderBatch (%s): %u failures\n", GpsDecoderClass::batchKernel(), failures);
+   return failures ? 1 : 0;
+}
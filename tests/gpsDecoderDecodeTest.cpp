@@ -0,0 +1,175 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the buffer decode() against the char by char decode()
+///
+/// BenchTrack logs with random bytes overwritten, removed and inserted are decoded char by char
+/// and in random pieces of 0 to 600 bytes by a second decoder. The number of decoded frames and
+/// everything visible from outside must be the same, also in the middle of the stream. onSkyView
+/// must be called once per complete sky view.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "benchNmea.h"
+#include <string>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define STREAMS                           40
+#define VALUES                            23
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+// Counts handler calls into the int array of the context
+static void countGGA(GpsDecoderClass &, void *context)        { ((int *)context)[0]++; }
+static void countRMC(GpsDecoderClass &, void *context)        { ((int *)context)[1]++; }
+static void countLocation(GpsDecoderClass &, void *context)   { ((int *)context)[2]++; }
+static void countChecksum(GpsDecoderClass &, void *context)   { ((int *)context)[3]++; }
+static void countSkyView(GpsDecoderClass &, void *context)    { ((int *)context)[4]++; }
+
+static void attach(GpsDecoderClass &decoder, int *calls)
+{
+   decoder.onGGA(countGGA, calls);
+   decoder.onRMC(countRMC, calls);
+   decoder.onLocation(countLocation, calls);
+   decoder.onChecksumFailure(countChecksum, calls);
+   decoder.onSkyView(countSkyView, calls);
+}
+
+// Everything, which is visible from outside
+static void snapshot(GpsDecoderClass &decoder, const int *calls, uint32_t *values)
+{
+   int i = 0;
+
+   values[i++] = decoder.charsProcessed();
+   values[i++] = decoder.failedChecksum();
+   values[i++] = decoder.passedChecksum();
+   values[i++] = decoder.skippedSentences();
+   values[i++] = decoder.location.latE7();
+   values[i++] = decoder.location.lngE7();
+   values[i++] = decoder.time.value();
+   values[i++] = decoder.date.value();
+   values[i++] = decoder.speed.hundredths();
+   values[i++] = decoder.course.hundredths();
+   values[i++] = decoder.altitude.hundredths();
+   values[i++] = decoder.hdop.hundredths();
+   values[i++] = decoder.fixedType.value();
+   values[i++] = decoder.satellites.gps.count();
+   values[i++] = decoder.satellites.gps.skyViewCount();
+   values[i++] = (uint32_t)decoder.satellites.gps.activeMask();
+   values[i++] = decoder.epoch.count();
+   values[i++] = decoder.satellites.glonass.skyViewCount();
+   for (int c = 0; c < 5; c++) values[i++] = calls[c];
+}
+
+// A BenchTrack log with some random bytes overwritten, removed or inserted
+static std::string makeStream(int s)
+{
+   std::string stream = BenchTrack::log(20000 + random(60000), s + 1);
+   size_t damages = random(stream.size() / 200);
+
+   for (size_t k = 0; k < damages; k++)
+   {
+      size_t position = random(stream.size());
+      switch (random(3))
+      {
+         case 0:  stream[position] = (char)random(256); break;
+         case 1:  stream.erase(position, 1 + random(80)); break;
+         default: stream.insert(position, 1, "$*\r\n,"[random(5)]); break;
+      }
+   }
+   return stream;
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   for (int s = 0; s < STREAMS; s++)
+   {
+      std::string stream = makeStream(s);
+      size_t maxPiece = s % 2 ? 8 : 600;
+
+      GpsDecoderClass single, buffer;
+      int singleCalls[5] = {0}, bufferCalls[5] = {0};
+      uint32_t singleValues[VALUES], bufferValues[VALUES];
+
+      attach(single, singleCalls);
+      attach(buffer, bufferCalls);
+      if (s % 5 == 4)
+      {
+         single.setSentenceFilter(GPS_DECODER_SENTENCE_GGA | GPS_DECODER_SENTENCE_RMC, GPS_DECODER_TALKER_ALL);
+         buffer.setSentenceFilter(GPS_DECODER_SENTENCE_GGA | GPS_DECODER_SENTENCE_RMC, GPS_DECODER_TALKER_ALL);
+      }
+
+      size_t singleFrames = 0, bufferFrames = 0;
+      for (size_t offset = 0; offset < stream.size();)
+      {
+         size_t count = random(maxPiece + 1);
+         if (count > stream.size() - offset) count = stream.size() - offset;
+
+         for (size_t i = offset; i < offset + count; i++) singleFrames += single.decode(stream[i]);
+         bufferFrames += buffer.decode(stream.data() + offset, count);
+         offset += count;
+
+         // Also in the middle of the stream
+         if (random(50) == 0 || offset == stream.size())
+         {
+            snapshot(single, singleCalls, singleValues);
+            snapshot(buffer, bufferCalls, bufferValues);
+
+            CHECK(singleFrames == bufferFrames);
+            for (int i = 0; i < VALUES; i++)
+            {
+               if (singleValues[i] != bufferValues[i]) printf("stream %d, offset %zu: value %d is %u, char by char %u\n", s, offset, i, bufferValues[i], singleValues[i]);
+               CHECK(singleValues[i] == bufferValues[i]);
+            }
+         }
+      }
+
+      // The damages must not have stopped the decoding
+      CHECK(single.passedChecksum() > 0 && single.epoch.count() > 0);
+
+      // One onSkyView per flipped sky view of any system
+      uint32_t skyViews = single.satellites.gps.skyViewCount() + single.satellites.glonass.skyViewCount() + single.satellites.baidu.skyViewCount();
+      CHECK(singleCalls[4] == (int)skyViews && (skyViews > 0 || s % 5 == 4));
+   }
+
+   printf("gpsDecoderDecode: %u failures\n", failures);
+   return failures ? 1 : 0;
+}
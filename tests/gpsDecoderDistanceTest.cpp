@@ -0,0 +1,122 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of DISTANCE_AUTO of distanceBetween and courseTo
+///
+/// Pairs of positions from 1 cm to 18000 km apart at all latitudes and across 180 degrees longitude
+/// run through DISTANCE_AUTO with tolerances from 0.1 mm to 100 km and 1e-5 to 5 degrees. The result
+/// must be the one of the tier distanceMethod and courseMethod report, only that tier is calculated,
+/// and within the tolerance of DISTANCE_VINCENTY. Courses are compared from 1 m on, the course of
+/// positions 1 cm apart differs by 2e-5 degrees between the tiers by rounding alone.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include <math.h>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define PAIRS                             100000
+#define VINCENTY_ERROR                    1e-4                // m, 1e-6 degrees, DISTANCE_VINCENTY against GeographicLib
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+static const double distanceTolerances[] = { 1e-4, 1e-2, 1, 100, 1e5 };
+static const double courseTolerances[] = { 1e-5, 1e-3, 0.1, 1, 5 };
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static double uniform(double low, double high)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return low + (high - low) * (randomState / 4294967296.0);
+}
+
+// Course difference across 0 / 360 degrees
+static double angleDifference(double a, double b)
+{
+   double difference = fabs(a - b);
+   return difference > 180 ? 360 - difference : difference;
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   unsigned used[3] = {0};
+
+   for (size_t i = 0; i < PAIRS; i++)
+   {
+      double lat1 = uniform(-89.9, 89.9), lng1 = uniform(-180, 180), lat2, lng2;
+      if (i % 2)
+      {
+         double offset = pow(10, uniform(-7, 0));              // 1 cm to 100 km
+         lat2 = fmax(-89.9, fmin(89.9, lat1 + uniform(-offset, offset)));
+         lng2 = lng1 + uniform(-offset, offset);
+         if (lng2 > 180) lng2 -= 360;
+         if (lng2 < -180) lng2 += 360;
+      }
+      else
+      {
+         lat2 = uniform(-89.9, 89.9);
+         lng2 = uniform(-180, 180);
+      }
+
+      double distance = GpsDecoderClass::distanceBetween(lat1, lng1, lat2, lng2, GpsDecoderClass::DISTANCE_VINCENTY);
+      if (distance > 18e6) continue;                           // Nearly antipodal, the course depends on the last digit
+      double course = GpsDecoderClass::courseTo(lat1, lng1, lat2, lng2, GpsDecoderClass::DISTANCE_VINCENTY);
+
+      for (size_t t = 0; t < sizeof(distanceTolerances) / sizeof(distanceTolerances[0]); t++)
+      {
+         GpsDecoderClass::DistanceMethod method = GpsDecoderClass::distanceMethod(lat1, lng1, lat2, lng2, distanceTolerances[t]);
+         double value = GpsDecoderClass::distanceBetween(lat1, lng1, lat2, lng2, GpsDecoderClass::DISTANCE_AUTO, distanceTolerances[t]);
+
+         CHECK(method != GpsDecoderClass::DISTANCE_AUTO);
+         CHECK(value == GpsDecoderClass::distanceBetween(lat1, lng1, lat2, lng2, method));
+         CHECK(fabs(value - distance) <= distanceTolerances[t] + VINCENTY_ERROR);
+         used[method]++;
+      }
+
+      for (size_t t = 0; t < sizeof(courseTolerances) / sizeof(courseTolerances[0]); t++)
+      {
+         GpsDecoderClass::DistanceMethod method = GpsDecoderClass::courseMethod(lat1, lng1, lat2, lng2, courseTolerances[t]);
+         double value = GpsDecoderClass::courseTo(lat1, lng1, lat2, lng2, GpsDecoderClass::DISTANCE_AUTO, courseTolerances[t]);
+
+         CHECK(method != GpsDecoderClass::DISTANCE_AUTO);
+         CHECK(value == GpsDecoderClass::courseTo(lat1, lng1, lat2, lng2, method));
+         if (distance > 1) CHECK(angleDifference(value, course) <= courseTolerances[t] + VINCENTY_ERROR / 100);
+         used[method]++;
+      }
+   }
+
+   // Every tier must be taken for some tolerances
+   CHECK(used[GpsDecoderClass::DISTANCE_EQUIRECTANGULAR] > 0 && used[GpsDecoderClass::DISTANCE_HAVERSINE] > 0 && used[GpsDecoderClass::DISTANCE_VINCENTY] > 0);
+
+   printf("gpsDecoderDistance: %u failures, tiers taken %u %u %u\n", failures, used[0], used[1], used[2]);
+   return failures ? 1 : 0;
+}
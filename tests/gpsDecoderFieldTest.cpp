@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the number parsers of FieldClass
+///
+/// Numbers are passed through whole sentences, a value which does not fit into 32 bit must
+/// make its field invalid, the value before is kept and must not be replaced by a wrapped one.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoder.h"
+#include "benchNmea.h"
+#include <string>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static unsigned failures = 0;
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// Decode a GGA with the given altitude field, returns the altitude in cm afterwards
+static int32_t altitudeAfter(GpsDecoderClass &decoder, const char *altitude)
+{
+   std::string line;
+   benchSentence(line, "GNGGA,165520.000,4807.038,N,01131.000,E,1,07,2.7,%s,M,48.3,M,,", altitude);
+   decoder.decode(line.data(), line.size());
+   return decoder.altitude.hundredths();
+}
+
+// Decode a GSA with the given fix type field, returns the fix type afterwards
+static uint32_t fixedTypeAfter(GpsDecoderClass &decoder, const char *fixedType)
+{
+   std::string line;
+   benchSentence(line, "GPGSA,A,%s,10,16,,,,,,,,,,,9.7,2.7,9.3,1", fixedType);
+   decoder.decode(line.data(), line.size());
+   return decoder.fixedType.value();
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   GpsDecoderClass decoder;
+
+   // toFixed, 2 decimals
+   CHECK(altitudeAfter(decoder, "101.0") == 10100);
+   CHECK(altitudeAfter(decoder, "42949672.96") == 10100);            // 2^32 cm, wraps to 0 without the check
+   CHECK(altitudeAfter(decoder, "99999999999999999999") == 10100);   // Longest field
+   CHECK(altitudeAfter(decoder, "21474836.48") == 10100);            // Beyond int32
+   CHECK(altitudeAfter(decoder, "21474836.47") == 2147483647);
+   CHECK(altitudeAfter(decoder, "-21474836.47") == -2147483647);
+   CHECK(altitudeAfter(decoder, "-0.5") == -50);
+   CHECK(altitudeAfter(decoder, "4.9999") == 499);                   // Truncated
+   CHECK(altitudeAfter(decoder, "0000000000000000012") == 1200);    // Leading zeros do not overflow
+
+   // toUnsigned
+   CHECK(fixedTypeAfter(decoder, "2") == 2);
+   CHECK(fixedTypeAfter(decoder, "4294967299") == 2);                 // 2^32 + 3, wraps to 3 without the check
+   CHECK(fixedTypeAfter(decoder, "99999999999999999999") == 2);
+   CHECK(fixedTypeAfter(decoder, "00000000000000000003") == 3);       // Leading zeros do not overflow
+
+   printf("gpsDecoderField: %u failures\n", failures);
+   return failures ? 1 : 0;
+}
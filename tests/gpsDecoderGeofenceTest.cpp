@@ -0,0 +1,362 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the geofence engine of gpsDecoderGeofence.h
+///
+/// Concave polygons, rectangles on the cell borders, circles and a fence too large for the grid
+/// are checked with a random walk, which also hits corners and edges. With cells of 0.01, 0.002
+/// and 0.0003 degrees the fences inside must be the ones of a brute force check of every fence,
+/// polygons also against a point in polygon test of its own. The events must be the enter, exit
+/// and dwell of the inside sets, exits in front of enters. A decoder passing GGA and RMC across
+/// midnight through onLocation must dwell and exit on the next day.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderGeofence.h"
+#include "benchNmea.h"
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define FIXES                             100000
+#define POLYGONS                          40
+#define CIRCLES                           20
+#define AREA_LAT                          480000000           // South west corner of the walk, 1e-7 degrees
+#define AREA_LNG                          80000000
+#define AREA_SIZE                         2000000             // 0.2 degrees
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderGeofence::Event Event;
+typedef GpsDecoderGeofence::EventType EventType;
+
+struct Polygon
+{
+   uint32_t id;
+   std::vector<int32_t> lats, lngs;
+};
+
+struct Model                                                   // Expected state of one fence
+{
+   bool inside, dwelled;
+   uint64_t enterTime, dwell;
+};
+
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+static const int32_t cellSizes[] = { 100000, 20000, 3000 };
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+static void collect(const Event &event, void *context)
+{
+   static_cast<std::vector<Event> *>(context)->push_back(event);
+}
+
+// Point in polygon by the crossing number with the intersection as fraction, exact in 64 bit
+static bool insidePolygon(const Polygon &polygon, int64_t lat, int64_t lng)
+{
+   bool in = false;
+   size_t count = polygon.lats.size();
+
+   for (size_t i = 0, j = count - 1; i < count; j = i++)
+   {
+      int64_t latI = polygon.lats[i], lngI = polygon.lngs[i], latJ = polygon.lats[j], lngJ = polygon.lngs[j];
+      if ((latI > lat) == (latJ > lat)) continue;
+
+      // lng < lngI + (lat - latI) * (lngJ - lngI) / (latJ - latI), multiplied with the positive denominator
+      int64_t denominator = latJ - latI, numerator = (lat - latI) * (lngJ - lngI);
+      if (denominator < 0)
+      {
+         denominator = -denominator;
+         numerator = -numerator;
+      }
+      if ((lng - lngI) * denominator < numerator) in = !in;
+   }
+   return in;
+}
+
+// Star shaped polygon, concave with more than 4 corners
+static Polygon makeStar(uint32_t id)
+{
+   Polygon polygon;
+   int32_t lat = AREA_LAT + (int32_t)random(AREA_SIZE), lng = AREA_LNG + (int32_t)random(AREA_SIZE);
+   size_t corners = 3 + random(14);
+   double radius = 20000 + random(400000);
+
+   polygon.id = id;
+   for (size_t i = 0; i < corners; i++)
+   {
+      double angle = 2 * M_PI * (i + 0.8 * random(1000) / 1000.0) / corners;
+      double scale = i % 2 ? 1.0 : 0.2 + random(800) / 1000.0;
+      polygon.lats.push_back(lat + (int32_t)(radius * scale * sin(angle)));
+      polygon.lngs.push_back(lng + (int32_t)(radius * scale * cos(angle)));
+   }
+   return polygon;
+}
+
+// Rectangle with its edges on the borders of the 0.002 degree cells
+static Polygon makeRectangle(uint32_t id)
+{
+   Polygon polygon;
+   int32_t lat = AREA_LAT + 20000 * (int32_t)random(AREA_SIZE / 20000), lng = AREA_LNG + 20000 * (int32_t)random(AREA_SIZE / 20000);
+   int32_t height = 20000 * (1 + (int32_t)random(10)), width = 20000 * (1 + (int32_t)random(10));
+
+   polygon.id = id;
+   polygon.lats.push_back(lat);            polygon.lngs.push_back(lng);
+   polygon.lats.push_back(lat);            polygon.lngs.push_back(lng + width);
+   polygon.lats.push_back(lat + height);   polygon.lngs.push_back(lng + width);
+   polygon.lats.push_back(lat + height);   polygon.lngs.push_back(lng);
+   return polygon;
+}
+
+// Ids of the last fix of an engine, sorted
+static std::vector<uint32_t> insideIds(const GpsDecoderGeofence &geofence)
+{
+   std::vector<uint32_t> ids;
+   geofence.insideIds(ids);
+   std::sort(ids.begin(), ids.end());
+   return ids;
+}
+
+// Events of a fix against the model, exits in front of enters and dwells
+static void checkEvents(const std::vector<Event> &events, const std::vector<Event> &expected, uint64_t time)
+{
+   std::vector<std::pair<int, uint32_t> > got, want;
+   bool entered = false;
+
+   for (size_t i = 0; i < events.size(); i++)
+   {
+      CHECK(events[i].time == time);
+      if (events[i].type == GpsDecoderGeofence::GEOFENCE_EXIT) CHECK(!entered);
+      else entered = true;
+      got.push_back(std::make_pair((int)events[i].type, events[i].id));
+   }
+   for (size_t i = 0; i < expected.size(); i++) want.push_back(std::make_pair((int)expected[i].type, expected[i].id));
+
+   std::sort(got.begin(), got.end());
+   std::sort(want.begin(), want.end());
+   CHECK(got == want);
+}
+
+static void testFences()
+{
+   std::vector<Polygon> polygons;
+   std::vector<GpsDecoderGeofence *> engines;
+   std::vector<std::vector<Event> > events(sizeof(cellSizes) / sizeof(cellSizes[0]) + 1);
+   std::vector<Model> models;
+   uint32_t id = 100;
+
+   // The last engine has cells of 1e-7 degrees, so every fence is too large for the grid and checked with every fix
+   for (size_t e = 0; e < events.size(); e++)
+   {
+      engines.push_back(new GpsDecoderGeofence(e < events.size() - 1 ? cellSizes[e] : 1));
+      engines.back()->onEvent(collect, &events[e]);
+   }
+
+   for (size_t i = 0; i < POLYGONS + CIRCLES + 1; i++, id++)
+   {
+      Model model = { false, false, 0, random(3) ? 0 : (uint64_t)100 * (1 + random(300)) };
+      models.push_back(model);
+
+      if (i < POLYGONS)
+      {
+         polygons.push_back(i % 4 ? makeStar(id) : makeRectangle(id));
+         const Polygon &polygon = polygons.back();
+         for (size_t e = 0; e < engines.size(); e++) CHECK(engines[e]->addPolygon(id, &polygon.lats[0], &polygon.lngs[0], polygon.lats.size(), model.dwell));
+      }
+      else if (i < POLYGONS + CIRCLES)
+      {
+         int32_t lat = AREA_LAT + (int32_t)random(AREA_SIZE), lng = AREA_LNG + (int32_t)random(AREA_SIZE);
+         double radius = 50 + random(3000);
+         for (size_t e = 0; e < engines.size(); e++) CHECK(engines[e]->addCircle(id, lat, lng, radius, model.dwell));
+      }
+      else
+      {
+         // Larger than GPS_DECODER_GEOFENCE_MAX_CELLS cells of all engines
+         Polygon polygon;
+         polygon.id = id;
+         polygon.lats.push_back(AREA_LAT - 10000000);   polygon.lngs.push_back(AREA_LNG - 10000000);
+         polygon.lats.push_back(AREA_LAT + 1000000);    polygon.lngs.push_back(AREA_LNG + 30000000);
+         polygon.lats.push_back(AREA_LAT + 30000000);   polygon.lngs.push_back(AREA_LNG + 1500000);
+         polygons.push_back(polygon);
+         for (size_t e = 0; e < engines.size(); e++) CHECK(engines[e]->addPolygon(id, &polygon.lats[0], &polygon.lngs[0], 3, model.dwell));
+      }
+   }
+   CHECK(!engines[0]->addPolygon(1, &polygons[0].lats[0], &polygons[0].lngs[0], 2));
+   CHECK(!engines[0]->addCircle(1, AREA_LAT, AREA_LNG, 0.0));
+
+   uint64_t time = GpsDecoderTrack::timestamp(161026, 12000000);
+   int32_t lat = AREA_LAT + AREA_SIZE / 2, lng = AREA_LNG + AREA_SIZE / 2;
+   size_t enters = 0, dwells = 0;
+
+   for (size_t f = 0; f < FIXES; f++)
+   {
+      time += 100;
+      switch (random(100))
+      {
+         case 0:
+            // Jump
+            lat = AREA_LAT + (int32_t)random(AREA_SIZE);
+            lng = AREA_LNG + (int32_t)random(AREA_SIZE);
+            break;
+         case 1:
+         {
+            // On a corner or an edge of a polygon
+            const Polygon &polygon = polygons[random(POLYGONS)];
+            size_t i = random(polygon.lats.size()), j = (i + 1) % polygon.lats.size();
+            int64_t step = random(2) ? 0 : random(1000);
+            lat = (int32_t)(polygon.lats[i] + (polygon.lats[j] - polygon.lats[i]) * step / 1000);
+            lng = (int32_t)(polygon.lngs[i] + (polygon.lngs[j] - polygon.lngs[i]) * step / 1000);
+            break;
+         }
+         default:
+            lat += (int32_t)random(4001) - 2000;
+            lng += (int32_t)random(4001) - 2000;
+            lat = std::max(AREA_LAT, std::min(AREA_LAT + AREA_SIZE, lat));
+            lng = std::max(AREA_LNG, std::min(AREA_LNG + AREA_SIZE, lng));
+            break;
+      }
+
+      for (size_t e = 0; e < engines.size(); e++)
+      {
+         events[e].clear();
+         engines[e]->update(time, lat, lng);
+      }
+
+      // Every engine against the brute force one, its polygons against the own test
+      std::vector<uint32_t> inside = insideIds(*engines.back());
+      for (size_t e = 0; e + 1 < engines.size(); e++) CHECK(insideIds(*engines[e]) == inside);
+      for (size_t p = 0; p < polygons.size(); p++)
+      {
+         CHECK(insidePolygon(polygons[p], lat, lng) == std::binary_search(inside.begin(), inside.end(), polygons[p].id));
+      }
+
+      // Events of the model
+      std::vector<Event> expected;
+      for (size_t m = 0; m < models.size(); m++)
+      {
+         Model &model = models[m];
+         bool in = std::binary_search(inside.begin(), inside.end(), (uint32_t)(100 + m));
+         Event event = { GpsDecoderGeofence::GEOFENCE_EXIT, (uint32_t)(100 + m), time, lat, lng };
+
+         if (model.inside && !in) expected.push_back(event);
+         if (!model.inside && in)
+         {
+            event.type = GpsDecoderGeofence::GEOFENCE_ENTER;
+            expected.push_back(event);
+            model.dwelled = false;
+            model.enterTime = time;
+            enters++;
+         }
+         else if (in && !model.dwelled && model.dwell && time >= model.enterTime + model.dwell)
+         {
+            event.type = GpsDecoderGeofence::GEOFENCE_DWELL;
+            expected.push_back(event);
+            model.dwelled = true;
+            dwells++;
+         }
+         model.inside = in;
+      }
+      for (size_t e = 0; e < engines.size(); e++) checkEvents(events[e], expected, time);
+   }
+
+   // All kinds of events must have happened
+   CHECK(enters > 100 && dwells > 10);
+
+   // After clear() the next fix is outside of everything without exit
+   for (size_t e = 0; e < engines.size(); e++)
+   {
+      events[e].clear();
+      engines[e]->clear();
+      engines[e]->update(time + 100, lat, lng);
+      CHECK(events[e].empty() && insideIds(*engines[e]).empty() && engines[e]->size() == 0);
+      delete engines[e];
+   }
+}
+
+// GGA and RMC of one second, inside is the center of the fence or 0.5 minutes east of it
+static void decodeSecond(GpsDecoderClass &decoder, uint32_t time, uint32_t date, bool inside)
+{
+   std::string lines;
+   const char *lng = inside ? "01131.000" : "01131.500";
+
+   benchSentence(lines, "GNGGA,%06u.00,4807.000,N,%s,E,1,07,1.0,100.0,M,48.3,M,,", time, lng);
+   benchSentence(lines, "GNRMC,%06u.00,A,4807.000,N,%s,E,0.0,0.0,%06u,,,A", time, lng, date);
+   decoder.decode(lines.data(), lines.size());
+}
+
+// The GGA right behind midnight has the date of the RMC in front, onLocation moves it to the next day
+static void testMidnight()
+{
+   GpsDecoderClass decoder;
+   GpsDecoderGeofence geofence;
+   std::vector<Event> events;
+
+   geofence.addCircle(7, 481166667, 115166667, 100.0, 2000);   // 4807.000N 01131.000E, dwell 20 s
+   geofence.onEvent(collect, &events);
+   decoder.onLocation(GpsDecoderGeofence::onLocation, &geofence);
+
+   // 23:59:40 to 00:00:40, inside from 23:59:50 to 23:59:54 and from 00:00:00 to 00:00:29
+   for (int second = -20; second <= 40; second++)
+   {
+      uint32_t time = second < 0 ? 235900 + 60 + second : second;
+      decodeSecond(decoder, time, second < 0 ? 161026 : 171026, (second >= -10 && second < -5) || (second >= 0 && second < 30));
+   }
+
+   // Without the next day the enter at midnight is a day early and dwells with the following RMC
+   EventType types[] = { GpsDecoderGeofence::GEOFENCE_ENTER, GpsDecoderGeofence::GEOFENCE_EXIT, GpsDecoderGeofence::GEOFENCE_ENTER,
+                         GpsDecoderGeofence::GEOFENCE_DWELL, GpsDecoderGeofence::GEOFENCE_EXIT };
+   uint64_t times[] = { GpsDecoderTrack::timestamp(161026, 23595000), GpsDecoderTrack::timestamp(161026, 23595500), GpsDecoderTrack::timestamp(171026, 0),
+                        GpsDecoderTrack::timestamp(171026, 2000), GpsDecoderTrack::timestamp(171026, 3000) };
+
+   CHECK(events.size() == 5);
+   for (size_t i = 0; i < events.size() && i < 5; i++) CHECK(events[i].type == types[i] && events[i].time == times[i] && events[i].id == 7);
+
+   // Only a time more than half a day behind the last one is moved
+   CHECK(GpsDecoderTrack::locationTime(decoder, 0) == GpsDecoderTrack::timestamp(171026, 4000));
+   CHECK(GpsDecoderTrack::locationTime(decoder, GpsDecoderTrack::timestamp(171026, 12000000)) == GpsDecoderTrack::timestamp(171026, 4000));
+   CHECK(GpsDecoderTrack::locationTime(decoder, GpsDecoderTrack::timestamp(171026, 12010000)) == GpsDecoderTrack::timestamp(181026, 4000));
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   testFences();
+   testMidnight();
+
+   printf("gpsDecoderGeofence: %u failures\n", failures);
+   return failures ? 1 : 0;
+}
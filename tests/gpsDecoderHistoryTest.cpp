@@ -0,0 +1,279 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the position history of gpsDecoderHistory.h
+///
+/// A walk over 180 degrees longitude is added mostly in time order, with late positions that
+/// split leaves and positions that replace others. Every range() and positionAt() must agree with
+/// a brute force search over a std::map, around the leaf edges of the appended leaves as well as
+/// at random times. Saved to a track file, the static overloads on the Reader must give the same
+/// results as the in-memory ones, also across the block edges of the file.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderHistory.h"
+#include <map>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define POSITIONS                         20000
+#define QUERIES                           3000
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderHistory::Entry Entry;
+typedef std::map<uint64_t, Entry> Reference;
+
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+static bool sameEntry(const Entry &a, const Entry &b)
+{
+   return a.time == b.time && a.latE7 == b.latE7 && a.lngE7 == b.lngE7;
+}
+
+static void add(GpsDecoderHistory &history, Reference &reference, uint64_t time, int32_t latE7, int32_t lngE7)
+{
+   Entry entry = { time, latE7, lngE7 };
+   history.add(time, latE7, lngE7);
+   reference[time] = entry;
+}
+
+// Longitude difference over +-180 degrees
+static int64_t lngDifference(int32_t a, int32_t b)
+{
+   int64_t difference = (int64_t)a - b;
+   if (difference > 1800000000) difference -= 3600000000LL;
+   if (difference < -1800000000) difference += 3600000000LL;
+   return difference;
+}
+
+// Expected positionAt by the map, 1 1e-7 degree of rounding is allowed
+static bool expectedAt(const Reference &reference, uint64_t time, uint64_t maxGap, Entry &position)
+{
+   Reference::const_iterator behind = reference.lower_bound(time);
+   if (behind == reference.end()) return false;
+   if (behind->first == time)
+   {
+      position = behind->second;
+      return true;
+   }
+   if (behind == reference.begin()) return false;
+
+   Reference::const_iterator front = behind;
+   --front;
+   if (maxGap && behind->first - front->first > maxGap) return false;
+
+   // Unwrapped over 180 degrees and wrapped again
+   double fraction = (double)(time - front->first) / (double)(behind->first - front->first);
+   double lng = front->second.lngE7 + fraction * lngDifference(behind->second.lngE7, front->second.lngE7);
+   if (lng > 1800000000) lng -= 3600000000.0;
+   if (lng < -1800000000) lng += 3600000000.0;
+
+   position.time = time;
+   position.latE7 = (int32_t)(front->second.latE7 + fraction * ((double)behind->second.latE7 - front->second.latE7));
+   position.lngE7 = (int32_t)lng;
+   return true;
+}
+
+static void checkRange(const GpsDecoderHistory &history, const Reference &reference, uint64_t from, uint64_t to)
+{
+   std::vector<Entry> positions(1);                            // range() appends
+   size_t found = history.range(from, to, positions);
+
+   CHECK(found == positions.size() - 1);
+   Reference::const_iterator it = reference.lower_bound(from);
+   for (size_t i = 1; i < positions.size(); i++, ++it)
+   {
+      CHECK(it != reference.end() && sameEntry(positions[i], it->second));
+      if (it == reference.end()) return;
+   }
+   CHECK(it == reference.end() || it->first > to);
+}
+
+static void checkPositionAt(const GpsDecoderHistory &history, const Reference &reference, uint64_t time, uint64_t maxGap)
+{
+   Entry position, expected;
+   bool found = history.positionAt(time, position, maxGap);
+
+   CHECK(found == expectedAt(reference, time, maxGap, expected));
+   if (!found) return;
+
+   CHECK(position.time == time);
+   CHECK(abs(position.latE7 - expected.latE7) <= 1 && llabs(lngDifference(position.lngE7, expected.lngE7)) <= 1);
+   CHECK(position.lngE7 >= -1800000000 && position.lngE7 <= 1800000000);
+}
+
+// Times around the edges of the appended leaves and random ones, with and without gap limit
+static void checkQueries(const GpsDecoderHistory &history, const Reference &reference)
+{
+   std::vector<uint64_t> times;
+   for (Reference::const_iterator it = reference.begin(); it != reference.end(); ++it) times.push_back(it->first);
+
+   uint64_t first = times.front(), last = times.back();
+   for (size_t q = 0; q < QUERIES; q++)
+   {
+      uint64_t from, to;
+      if (q % 2)
+      {
+         size_t edge = GPS_DECODER_HISTORY_LEAF * (1 + random(times.size() / GPS_DECODER_HISTORY_LEAF));
+         edge = edge < times.size() ? edge : times.size() - 1;
+         from = times[edge] - random(300) * 50;
+         to = times[edge] + random(300) * 50;
+      }
+      else
+      {
+         from = first - 1000 + random((uint32_t)(last - first + 2000));
+         to = from + random(500000);
+      }
+
+      checkRange(history, reference, from, to);
+      checkPositionAt(history, reference, from, 0);
+      checkPositionAt(history, reference, to, q % 3 ? 0 : 400);
+   }
+
+   checkRange(history, reference, 0, UINT64_MAX);
+   checkRange(history, reference, last + 1, UINT64_MAX);
+   checkPositionAt(history, reference, first, 0);
+   checkPositionAt(history, reference, first - 1, 0);
+   checkPositionAt(history, reference, last, 0);
+   checkPositionAt(history, reference, last + 1, 0);
+}
+
+// The static overloads on a track file against the in-memory ones
+static void checkReader(const GpsDecoderHistory &history, const Reference &reference)
+{
+   char path[] = "/tmp/gpsDecoderHistoryTestXXXXXX";
+   int descriptor = mkstemp(path);
+   CHECK(descriptor >= 0);
+   if (descriptor < 0) return;
+   close(descriptor);
+
+   GpsDecoderTrack::Reader reader;
+   CHECK(history.save(path));
+   CHECK(reader.open(path));
+   CHECK(reader.records() == history.size() && reader.blocks() > 2);
+
+   uint64_t first = reference.begin()->first, last = reference.rbegin()->first;
+   for (size_t q = 0; q < QUERIES; q++)
+   {
+      uint64_t from;
+      if (q % 2)
+      {
+         // Around the block edges of the file
+         GpsDecoderTrack::BlockInfo info = GpsDecoderTrack::BlockInfo();
+         reader.blockInfo(random(reader.blocks()), info);
+         from = info.maxTime - 1000 + random(2000);
+      }
+      else from = first - 1000 + random((uint32_t)(last - first + 2000));
+      uint64_t to = from + random(q % 5 ? 5000 : 500000);
+
+      std::vector<Entry> memory, file;
+      CHECK(history.range(from, to, memory) == GpsDecoderHistory::range(reader, from, to, file));
+      CHECK(memory.size() == file.size());
+      for (size_t i = 0; i < memory.size() && i < file.size(); i++) CHECK(sameEntry(memory[i], file[i]));
+
+      Entry memoryPosition = Entry(), filePosition = Entry();
+      uint64_t maxGap = q % 3 ? 0 : 400;
+      bool found = history.positionAt(to, memoryPosition, maxGap);
+      CHECK(found == GpsDecoderHistory::positionAt(reader, to, filePosition, maxGap));
+      if (found) CHECK(sameEntry(memoryPosition, filePosition));
+   }
+
+   // Loaded again
+   GpsDecoderHistory loaded;
+   std::vector<Entry> all, allLoaded;
+   CHECK(loaded.load(path) && loaded.size() == history.size());
+   history.range(0, UINT64_MAX, all);
+   loaded.range(0, UINT64_MAX, allLoaded);
+   CHECK(all.size() == allLoaded.size());
+   for (size_t i = 0; i < all.size() && i < allLoaded.size(); i++) CHECK(sameEntry(all[i], allLoaded[i]));
+
+   unlink(path);
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   GpsDecoderHistory history;
+   Reference reference;
+   uint64_t time = GpsDecoderTrack::timestamp(161026, 12000000);
+   int32_t latE7 = 654321000, lngE7 = 1799000000;
+
+   // Empty
+   Entry position;
+   std::vector<Entry> positions;
+   CHECK(!history.positionAt(time, position) && history.range(0, UINT64_MAX, positions) == 0);
+
+   // A walk at 1 Hz over 180 degrees longitude and back, with gaps
+   for (size_t i = 0; i < POSITIONS; i++)
+   {
+      time += 100 + (random(50) == 0 ? random(2000) : 0);
+      latE7 += (int32_t)random(2001) - 1000;
+      lngE7 += (i / 5000) % 2 ? -(int32_t)random(100000) : (int32_t)random(100000);
+      if (lngE7 > 1800000000) lngE7 = (int32_t)(lngE7 - 3600000000LL);
+      if (lngE7 < -1800000000) lngE7 = (int32_t)(lngE7 + 3600000000LL);
+      add(history, reference, time, latE7, lngE7);
+   }
+   CHECK(history.size() == reference.size());
+   checkQueries(history, reference);
+
+   // Late positions, many of them into the same few leaves, so these are split more than once
+   uint64_t first = reference.begin()->first;
+   for (size_t i = 0; i < POSITIONS; i++)
+   {
+      uint64_t late = i % 2 ? first + random(20000) : first + random((uint32_t)(time - first));
+      if (i % 7 == 0) late = first + 100 * random(POSITIONS);   // Maybe the time of a position, which is replaced
+      add(history, reference, late, (int32_t)random(1800000000) - 900000000, (int32_t)random(3600000000U) - 1800000000);
+   }
+   CHECK(history.size() == reference.size());
+   checkQueries(history, reference);
+
+   // Late positions in front of the first one
+   for (size_t i = 0; i < 300; i++) add(history, reference, first - 1 - random(100000), 0, -1800000000 + (int32_t)random(1000));
+   CHECK(history.size() == reference.size());
+   checkQueries(history, reference);
+
+   checkReader(history, reference);
+
+   history.clear();
+   CHECK(history.size() == 0 && !history.positionAt(time, position));
+
+   printf("gpsDecoderHistory: %u failures\n", failures);
+   return failures ? 1 : 0;
+}
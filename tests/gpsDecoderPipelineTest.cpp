@@ -0,0 +1,195 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of gpsDecoderPipeline.h against the serial decoder
+///
+/// Random streams of good, broken, cut and filtered sentences with binary garbage are decoded
+/// char by char by a GpsDecoderClass and in random pieces by a GpsDecoderPipeline with 1 to 4
+/// parsers. After flush() all counters, values, epochs and handler calls must be the same.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderPipeline.h"
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define STREAMS                           60
+#define VALUES                            20
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+
+static const char *bodies[] =
+{
+   "GNGGA,165520.000,4807.038,N,01131.000,E,1,07,2.7,101.0,M,48.3,M,,",
+   "GPGSA,A,3,10,16,,,,,,,,,,,9.7,2.7,9.3,1",
+   "GPGSV,3,1,10,08,,,21,10,56,137,27,16,49,200,26,18,,,18,0",
+   "GPGSV,3,2,10,23,,,28,26,18,178,,27,1,2,3,28,4,5,6",
+   "GPGSV,3,3,10,29,1,1,1,30,2,2,2,0",
+   "GNRMC,165520.29,A,5000.95387,S,00012.24919,W,1.50,181.50,180323,,,A,V",
+   "GNVTG,181.50,T,,M,0.00,N,0.00,K,A",
+   "GPTXT,01,01,01,ANTENNA OPEN",
+   "GLGSV,1,1,04,70,,,31,86,,,27,85,,,29,67,30,120,29,0",
+   "GBGSA,A,3,21,28,34,37,,,,,,,,,9.7,2.7,9.3,4",
+   "GNGGA,165521.000,4807.0380000000000000001,N,01131.000,E,1,07,2.7,101.0,M,48.3,M,,",
+   "GNRMC,165521.00,A,5000.95400,N,00012.25000,E,1.60,181.00,180323,,,A,V",
+};
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+// Counts handler calls into the int array of the context
+static void countGGA(GpsDecoderClass &, void *context)        { ((int *)context)[0]++; }
+static void countRMC(GpsDecoderClass &, void *context)        { ((int *)context)[1]++; }
+static void countLocation(GpsDecoderClass &, void *context)   { ((int *)context)[2]++; }
+static void countChecksum(GpsDecoderClass &, void *context)   { ((int *)context)[3]++; }
+
+static void attach(GpsDecoderClass &decoder, int *calls)
+{
+   decoder.onGGA(countGGA, calls);
+   decoder.onRMC(countRMC, calls);
+   decoder.onLocation(countLocation, calls);
+   decoder.onChecksumFailure(countChecksum, calls);
+   decoder.epoch.setRule(GPS_DECODER_EPOCH_LAST_SENTENCE, GPS_DECODER_SENTENCE_VTG, 0);
+}
+
+// Everything, which is visible from outside
+static void snapshot(GpsDecoderClass &decoder, const int *calls, uint32_t *values)
+{
+   int i = 0;
+
+   values[i++] = decoder.charsProcessed();
+   values[i++] = decoder.failedChecksum();
+   values[i++] = decoder.passedChecksum();
+   values[i++] = decoder.skippedSentences();
+   values[i++] = decoder.location.latE7();
+   values[i++] = decoder.location.lngE7();
+   values[i++] = decoder.time.value();
+   values[i++] = decoder.date.value();
+   values[i++] = decoder.speed.hundredths();
+   values[i++] = decoder.course.hundredths();
+   values[i++] = decoder.altitude.hundredths();
+   values[i++] = decoder.hdop.hundredths();
+   values[i++] = decoder.fixedType.value();
+   values[i++] = decoder.satellites.gps.skyViewCount();
+   values[i++] = (uint32_t)decoder.satellites.gps.activeMask();
+   values[i++] = decoder.epoch.count();
+   for (int c = 0; c < 4; c++) values[i++] = calls[c];
+}
+
+// Random lines, some broken, cut or followed by garbage
+static std::string makeStream(size_t lines)
+{
+   std::string stream;
+
+   for (size_t k = 0; k < lines; k++)
+   {
+      const char *body = bodies[random(sizeof(bodies) / sizeof(bodies[0]))];
+      uint8_t checksum = 0;
+      char tail[8];
+
+      for (const char *c = body; *c; c++) checksum ^= (uint8_t)*c;
+      snprintf(tail, sizeof(tail), "*%02X\r\n", checksum);
+      std::string line = std::string("$") + body + tail;
+
+      switch (random(12))
+      {
+         case 0:  line[random(line.size())] = (char)random(256); break;
+         case 1:  line.resize(random(line.size())); break;
+         case 2:  for (int j = 0; j < 5; j++) line += (char)random(256); break;
+         case 3:  line.erase(line.size() - 2, 1); break;                  // No \r
+         default: break;
+      }
+      stream += line;
+   }
+   return stream;
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   for (int s = 0; s < STREAMS; s++)
+   {
+      std::string stream = makeStream(s % 3 == 0 ? 3000 : random(400));
+      size_t parsers = 1 + s % 4;
+      uint16_t sentences = s % 5 == 4 ? GPS_DECODER_SENTENCE_GGA | GPS_DECODER_SENTENCE_VTG : GPS_DECODER_SENTENCE_ALL;
+      uint8_t talkers = s % 7 == 6 ? GPS_DECODER_TALKER_GN : GPS_DECODER_TALKER_ALL;
+
+      // The serial decoder counts a filtered sentence right behind its identifier, even without \n
+      if (sentences != GPS_DECODER_SENTENCE_ALL) stream += "$GPGSV,3,1,10,08";
+
+      GpsDecoderClass serial, parallel;
+      int serialCalls[4] = {0}, parallelCalls[4] = {0};
+      uint32_t serialValues[VALUES], parallelValues[VALUES];
+
+      attach(serial, serialCalls);
+      attach(parallel, parallelCalls);
+      serial.setSentenceFilter(sentences, talkers);
+      parallel.setSentenceFilter(sentences, talkers);
+
+      size_t serialFrames = 0, parallelFrames = 0;
+      for (size_t i = 0; i < stream.size(); i++) serialFrames += serial.decode(stream[i]);
+
+      {
+         GpsDecoderPipeline pipeline(parallel, parsers);
+         size_t maxPiece = s % 2 ? 64 : 40000;
+
+         for (size_t offset = 0; offset < stream.size();)
+         {
+            size_t count = random(maxPiece);
+            if (count > stream.size() - offset) count = stream.size() - offset;
+
+            parallelFrames += pipeline.decode(stream.data() + offset, count);
+            offset += count;
+         }
+         parallelFrames += pipeline.flush();
+      }
+
+      snapshot(serial, serialCalls, serialValues);
+      snapshot(parallel, parallelCalls, parallelValues);
+
+      CHECK(serialFrames == parallelFrames);
+      for (int i = 0; i < VALUES; i++)
+      {
+         if (serialValues[i] != parallelValues[i]) printf("stream %d, %zu parsers: value %d is %u, serial %u\n", s, parsers, i, parallelValues[i], serialValues[i]);
+         CHECK(serialValues[i] == parallelValues[i]);
+      }
+   }
+
+   printf("gpsDecoderPipeline: %u failures\n", failures);
+   return failures ? 1 : 0;
+}
@@ -0,0 +1,184 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of gpsDecoderReplay.h against the serial decoder
+///
+/// BenchTrack logs, some of them with random bytes overwritten, removed and inserted, are written
+/// to a file and replayed with 1 to 4 workers and small chunks, so every log is cut at many
+/// borders. The records must be the ones and in the order of one GpsDecoderClass decoding the
+/// whole log with the same setup, also the checksum counters.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderReplay.h"
+#include "benchNmea.h"
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define LOGS                              12
+#define LEAD_IN                           8192                // Many epochs with GSV of BenchTrack
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderClass::FixRecord FixRecord;
+
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+static bool sameRecord(const FixRecord &a, const FixRecord &b)
+{
+   return a.valid == b.valid && a.sentences == b.sentences && a.time == b.time && a.date == b.date &&
+          a.latE7 == b.latE7 && a.lngE7 == b.lngE7 && a.altitude == b.altitude && a.speed == b.speed &&
+          a.course == b.course && a.hdop == b.hdop && a.vdop == b.vdop && a.pdop == b.pdop &&
+          a.fixedType == b.fixedType && a.satellitesUsed == b.satellitesUsed && a.satellitesInView == b.satellitesInView;
+}
+
+static void collect(const FixRecord &record, void *context)
+{
+   static_cast<std::vector<FixRecord> *>(context)->push_back(record);
+}
+
+// Setups of the decoders, the context selects one of them
+static void setup(GpsDecoderClass &decoder, void *context)
+{
+   switch (*(int *)context)
+   {
+      case 1:
+         decoder.epoch.setRule(GPS_DECODER_EPOCH_LAST_SENTENCE, GPS_DECODER_SENTENCE_VTG, 0);
+         break;
+      case 2:
+         decoder.setSentenceFilter(GPS_DECODER_SENTENCE_GGA | GPS_DECODER_SENTENCE_RMC, GPS_DECODER_TALKER_ALL);
+         break;
+      default:
+         break;
+   }
+}
+
+// A BenchTrack log, every second one with some random bytes overwritten, removed or inserted
+static std::string makeLog(int l)
+{
+   std::string log = BenchTrack::log(100000 + random(300000), l + 1);
+   size_t damages = l % 2 ? random(log.size() / 500) : 0;
+
+   for (size_t k = 0; k < damages; k++)
+   {
+      size_t position = random(log.size());
+      switch (random(3))
+      {
+         case 0:  log[position] = (char)random(256); break;
+         case 1:  log.erase(position, 1 + random(80)); break;
+         default: log.insert(position, 1, "$*\r\n,"[random(5)]); break;
+      }
+   }
+   return log;
+}
+
+static bool writeFile(const char *path, const std::string &content)
+{
+   FILE *file = fopen(path, "wb");
+   if (!file) return false;
+   bool written = fwrite(content.data(), 1, content.size(), file) == content.size();
+   return fclose(file) == 0 && written;
+}
+
+// Replays the file and compares it with the serial decode of log
+static void compare(const char *path, const std::string &log, int mode, size_t threads, size_t chunkSize)
+{
+   GpsDecoderClass serial;
+   std::vector<FixRecord> expected, replayed;
+
+   setup(serial, &mode);
+   serial.onEpoch(collect, &expected);
+   serial.decode(log.data(), log.size());
+
+   GpsDecoderReplay replay(threads);
+   CHECK(replay.open(path));
+   CHECK(replay.size() == log.size());
+   replay.onSetup(setup, &mode);
+   replay.setChunkSize(chunkSize);
+   replay.setLeadIn(LEAD_IN);
+
+   size_t records = replay.replay(collect, &replayed);
+
+   CHECK(records == replayed.size());
+   CHECK(replayed.size() == expected.size());
+   for (size_t i = 0; i < replayed.size() && i < expected.size(); i++)
+   {
+      if (!sameRecord(replayed[i], expected[i])) printf("mode %d, %zu threads, chunks of %zu: record %zu of %zu differs\n", mode, threads, chunkSize, i, expected.size());
+      CHECK(sameRecord(replayed[i], expected[i]));
+   }
+   CHECK(replay.passedChecksum() == serial.passedChecksum());
+   CHECK(replay.failedChecksum() == serial.failedChecksum());
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   char path[] = "/tmp/gpsDecoderReplayTestXXXXXX";
+   int descriptor = mkstemp(path);
+   if (descriptor < 0)
+   {
+      printf("gpsDecoderReplay: can not create %s\n", path);
+      return 1;
+   }
+   close(descriptor);
+
+   for (int l = 0; l < LOGS; l++)
+   {
+      std::string log = makeLog(l);
+      CHECK(writeFile(path, log));
+
+      // Chunks from smaller than an epoch to the whole log
+      compare(path, log, l % 3, 1 + l % 4, 1000 + random(40000));
+      compare(path, log, l % 3, 4, 1 + random(600));
+      if (l == 0) compare(path, log, 0, 2, log.size() * 2);
+   }
+
+   // Empty and missing files
+   CHECK(writeFile(path, std::string()));
+   compare(path, std::string(), 0, 2, 1000);
+
+   unlink(path);
+   GpsDecoderReplay missing;
+   CHECK(!missing.open(path));
+   CHECK(missing.replay(collect, NULL) == 0);
+
+   printf("gpsDecoderReplay: %u failures\n", failures);
+   return failures ? 1 : 0;
+}
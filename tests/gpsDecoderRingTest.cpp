@@ -0,0 +1,282 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the multi thread stress test of gpsDecoderRing.h
+///
+/// One writer publishes records, whose values are all derived from one counter, while reader
+/// threads check every record they get. A torn read shows up as a record with mixed counters,
+/// a lost order as a counter going backwards.
+///
+/// A BenchTrack log is decoded line by line into a GpsDecoderLatest behind onLocation and a
+/// GpsDecoderFanout of epoch handlers. The location record must have the sentence just decoded,
+/// the epoch records must arrive one epoch late in every handler of the fan-out.
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderRing.h"
+#include "benchNmea.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdio.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define READERS                           4
+#define RUN_MS                            300                 // Each test publishes at least this long
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderClass::FixRecord FixRecord;
+
+static std::atomic<unsigned> failures(0);
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+
+// Publish records 0 or 1, 2, ... for RUN_MS, returns the number of published records
+template <class Publish>
+static uint32_t publishFor(uint32_t first, Publish publish)
+{
+   std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(RUN_MS);
+   uint32_t n = first;
+
+   do
+   {
+      for (uint32_t i = 0; i < 1000; i++) publish(n++);
+   }
+   while (std::chrono::steady_clock::now() < end);
+
+   return n - first;
+}
+
+// Record with all values set from n
+static FixRecord makeRecord(uint32_t n)
+{
+   FixRecord record;
+
+   record.valid = record.sentences = (uint16_t)n;
+   record.time = record.date = n;
+   record.latE7 = record.lngE7 = record.altitude = (int32_t)n;
+   record.speed = record.course = (int32_t)n;
+   record.hdop = record.vdop = record.pdop = (int32_t)n;
+   record.fixedType = record.satellitesUsed = record.satellitesInView = (uint8_t)n;
+   return record;
+}
+
+// True if all values of the record are from the same n
+static bool isConsistent(const FixRecord &record)
+{
+   uint32_t n = record.time;
+   int32_t i = (int32_t)n;
+
+   return record.valid == (uint16_t)n && record.sentences == (uint16_t)n && record.date == n &&
+          record.latE7 == i && record.lngE7 == i && record.altitude == i && record.speed == i && record.course == i &&
+          record.hdop == i && record.vdop == i && record.pdop == i &&
+          record.fixedType == (uint8_t)n && record.satellitesUsed == (uint8_t)n && record.satellitesInView == (uint8_t)n;
+}
+
+
+// Readers load while the writer stores, versions must not go backwards and match the record
+static void testLatest()
+{
+   GpsDecoderLatest latest;
+   std::atomic<bool> done(false);
+   std::vector<std::thread> readers;
+   uint32_t records = 0;
+
+   for (int r = 0; r < READERS; r++)
+   {
+      readers.push_back(std::thread([&]()
+      {
+         FixRecord record;
+         uint64_t last = 0;
+
+         while (!done.load(std::memory_order_acquire))
+         {
+            uint64_t version = latest.load(record);
+            if (version == 0) continue;
+
+            CHECK(isConsistent(record));
+            CHECK(record.time == (uint32_t)version);
+            CHECK(version >= last);
+            last = version;
+         }
+
+         CHECK(latest.load(record) == records && record.time == records);
+      }));
+   }
+
+   records = publishFor(1, [&](uint32_t n) { latest.store(makeRecord(n)); });
+   done.store(true, std::memory_order_release);
+
+   for (size_t r = 0; r < readers.size(); r++) readers[r].join();
+}
+
+
+// Readers pop while the producer overwrites, every reader gets each record at most once and in order
+static void testBroadcast()
+{
+   GpsDecoderBroadcast<16> broadcast;
+   std::atomic<bool> done(false);
+   std::atomic<int> started(0);
+   std::vector<std::thread> readers;
+   uint32_t records = 0;
+
+   for (int r = 0; r < READERS; r++)
+   {
+      readers.push_back(std::thread([&]()
+      {
+         GpsDecoderBroadcast<16>::Reader reader(broadcast);
+         FixRecord record;
+         uint64_t received = 0;
+         uint64_t next = 0;
+
+         started++;
+         for (;;)
+         {
+            bool finished = done.load(std::memory_order_acquire);
+
+            while (reader.pop(record))
+            {
+               CHECK(isConsistent(record));
+               CHECK(record.time >= next);
+               next = record.time + 1;
+               received++;
+            }
+            if (finished) break;
+         }
+
+         // The reader started at 0, so all records are either received or counted as lost
+         CHECK(received + reader.lost() == records);
+         CHECK(next == records);
+      }));
+   }
+
+   while (started.load() < READERS) std::this_thread::yield();
+
+   records = publishFor(0, [&](uint32_t n) { broadcast.push(makeRecord(n)); });
+   done.store(true, std::memory_order_release);
+
+   for (size_t r = 0; r < readers.size(); r++) readers[r].join();
+   CHECK(broadcast.published() == records);
+}
+
+
+// One consumer gets the records in order, records are only dropped if the ring is full
+static void testRing()
+{
+   GpsDecoderRing<16> ring;
+   std::atomic<bool> done(false);
+   uint64_t pushed = 0;
+   uint32_t records = 0;
+
+   std::thread consumer([&]()
+   {
+      FixRecord record;
+      uint64_t received = 0;
+      uint32_t next = 0;
+
+      for (;;)
+      {
+         bool finished = done.load(std::memory_order_acquire);
+
+         while (ring.pop(record))
+         {
+            CHECK(isConsistent(record));
+            CHECK(record.time >= next);
+            next = record.time + 1;
+            received++;
+         }
+         if (finished) break;
+      }
+
+      CHECK(received == pushed);
+   });
+
+   records = publishFor(0, [&](uint32_t n) { if (ring.push(makeRecord(n))) pushed++; });
+   done.store(true, std::memory_order_release);
+
+   consumer.join();
+   CHECK(pushed + ring.dropped() == records);
+}
+
+
+// GpsDecoderLatest behind onLocation has no delay, the epoch handlers of a fan-out get every epoch one epoch late
+static void testDecoder()
+{
+   GpsDecoderClass decoder;
+   GpsDecoderLatest location, epoch;
+   GpsDecoderRing<4> ring;
+   GpsDecoderFanout<2> fanout;
+   std::string log = BenchTrack::log(200000);
+   FixRecord fix = FixRecord(), record = FixRecord();
+   uint32_t lastTime = 0, popped = 0;
+
+   CHECK(fanout.add(GpsDecoderLatest::publish, &epoch));
+   CHECK(fanout.add(GpsDecoderRing<4>::publish, &ring));
+   CHECK(!fanout.add(GpsDecoderLatest::publish, &epoch));
+   decoder.onLocation(GpsDecoderLatest::publishLocation, &location);
+   decoder.onEpoch(GpsDecoderFanout<2>::publish, &fanout);
+
+   for (size_t start = 0, end; (end = log.find('\n', start)) != std::string::npos; start = end + 1)
+   {
+      uint32_t passed = decoder.passedChecksum();
+      decoder.decode(log.data() + start, end + 1 - start);
+      bool gga = log.compare(start + 3, 4, "GGA,") == 0 && decoder.passedChecksum() != passed;
+
+      while (ring.pop(record)) popped++;
+
+      if (gga)
+      {
+         // The location record has the GGA just decoded
+         CHECK(location.load(fix) > 0);
+         CHECK(fix.latE7 == decoder.location.latE7() && fix.lngE7 == decoder.location.lngE7());
+         CHECK(fix.time == decoder.time.value() && fix.altitude == decoder.altitude.hundredths());
+
+         // The GGA has closed the epoch before, which has the time of the GGA before
+         if (lastTime)
+         {
+            CHECK(epoch.load(record) == decoder.epoch.count());
+            CHECK(record.time == lastTime && record.time != fix.time);
+         }
+         lastTime = fix.time;
+      }
+   }
+
+   CHECK(decoder.epoch.count() > 100 && popped == decoder.epoch.count());
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   testLatest();
+   testBroadcast();
+   testRing();
+   testDecoder();
+
+   printf("gpsDecoderRing: %u failures\n", failures.load());
+   return failures.load() ? 1 : 0;
+}
@@ -0,0 +1,400 @@
+//-----------------------------------------------------------------------------
+//
+/// @file
+/// @brief This file contains the test of the track file format of gpsDecoderTrack.h
+///
+/// Records of a random walk across midnight and 180 degrees longitude, some of them without
+/// date, location or other fields, are written and read back across several blocks and a last
+/// partial one. Every record, the block footers and seek() are compared with a brute force search.
+/// A decoded BenchTrack log must give the same records through Writer::publish. Damaged headers,
+/// trailers, indexes, footers and truncated files must be rejected by open().
+///
+//-----------------------------------------------------------------------------
+// $Author: FKSN $
+// $Change: $
+// $DateTime: 16.10.2026 $
+//
+// Creator: FKSN ()
+// Compiler: Arduino PlattformIO
+//-----------------------------------------------------------------------------
+
+// ******************************************************************
+// Includes
+// ******************************************************************
+#include "gpsDecoderTrack.h"
+#include "benchNmea.h"
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+
+// ******************************************************************
+// Defines
+// ******************************************************************
+#define RECORDS                           (3 * GPS_DECODER_TRACK_BLOCK + 517)
+#define FOOTER_SIZE                       (44 + 4 * 15)       // Of gpsDecoderTrack.h, 15 columns
+
+#define CHECK(condition)   do { if (!(condition) && failures++ < 10) printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); } while (0)
+
+
+// ******************************************************************
+// Local variables
+// ******************************************************************
+typedef GpsDecoderClass::FixRecord FixRecord;
+
+static unsigned failures = 0;
+static uint32_t randomState = 1;
+static char path[] = "/tmp/gpsDecoderTrackTestXXXXXX";
+
+
+// ******************************************************************
+// Local functions
+// ******************************************************************
+static uint32_t random(uint32_t range)
+{
+   randomState ^= randomState << 13;
+   randomState ^= randomState >> 17;
+   randomState ^= randomState << 5;
+   return randomState % range;
+}
+
+static bool sameRecord(const FixRecord &a, const FixRecord &b)
+{
+   return a.valid == b.valid && a.sentences == b.sentences && a.time == b.time && a.date == b.date &&
+          a.latE7 == b.latE7 && a.lngE7 == b.lngE7 && a.altitude == b.altitude && a.speed == b.speed &&
+          a.course == b.course && a.hdop == b.hdop && a.vdop == b.vdop && a.pdop == b.pdop &&
+          a.fixedType == b.fixedType && a.satellitesUsed == b.satellitesUsed && a.satellitesInView == b.satellitesInView;
+}
+
+static uint32_t get32(const std::string &file, size_t offset)
+{
+   return (uint8_t)file[offset] | (uint8_t)file[offset + 1] << 8 | (uint8_t)file[offset + 2] << 16 | (uint32_t)(uint8_t)file[offset + 3] << 24;
+}
+
+static void put32(std::string &file, size_t offset, uint32_t value)
+{
+   for (int i = 0; i < 4; i++) file[offset + i] = (char)(value >> (8 * i));
+}
+
+static bool writeFile(const std::string &content)
+{
+   FILE *file = fopen(path, "wb");
+   if (!file) return false;
+   bool written = fwrite(content.data(), 1, content.size(), file) == content.size();
+   return fclose(file) == 0 && written;
+}
+
+static std::string readFile()
+{
+   std::string content;
+   FILE *file = fopen(path, "rb");
+   if (!file) return content;
+
+   char buffer[4096];
+   size_t count;
+   while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) content.append(buffer, count);
+   fclose(file);
+   return content;
+}
+
+// A walk at 1 Hz from 23:00 on, over midnight and the end of the month, which crosses 180 degrees longitude
+static std::vector<FixRecord> makeRecords()
+{
+   std::vector<FixRecord> records;
+   uint64_t time = GpsDecoderTrack::timestamp(311226, 23000000);
+   int32_t latE7 = -123456789, lngE7 = 1799990000;
+
+   for (size_t i = 0; i < RECORDS; i++)
+   {
+      FixRecord record = FixRecord();
+
+      time += 100 + (random(10) == 0 ? random(100000) : 0);
+      latE7 += (int32_t)random(2001) - 1000;
+      lngE7 += (int32_t)random(2001) - 500;
+      if (lngE7 > 1800000000) lngE7 = (int32_t)(lngE7 - 3600000000LL);
+
+      record.valid = GPS_DECODER_FIELD_TIME | GPS_DECODER_FIELD_ALTITUDE | GPS_DECODER_FIELD_SATELLITES;
+      record.sentences = GPS_DECODER_SENTENCE_GGA;
+      GpsDecoderTrack::dateTime(time, record.date, record.time);
+      record.altitude = i % 100 == 7 ? INT32_MIN : (int32_t)random(100000) - 5000;
+      record.satellitesUsed = (uint8_t)random(40);
+      record.satellitesInView = 255;
+
+      if (random(20))
+      {
+         record.valid |= GPS_DECODER_FIELD_LOCATION;
+         record.latE7 = latE7;
+         record.lngE7 = lngE7;
+      }
+      if (random(10))
+      {
+         record.valid |= GPS_DECODER_FIELD_DATE | GPS_DECODER_FIELD_SPEED | GPS_DECODER_FIELD_COURSE;
+         record.sentences |= GPS_DECODER_SENTENCE_RMC;
+         record.speed = (int32_t)random(20000);
+         record.course = (int32_t)random(36000);
+      }
+      else record.date = 0;
+      if (i % 3 == 0)
+      {
+         record.valid |= GPS_DECODER_FIELD_DOP | GPS_DECODER_FIELD_FIXED_TYPE;
+         record.hdop = (int32_t)random(9999);
+         record.vdop = INT32_MAX;
+         record.pdop = (int32_t)random(9999);
+         record.fixedType = 3;
+      }
+      records.push_back(record);
+   }
+   return records;
+}
+
+static bool writeTrack(const std::vector<FixRecord> &records)
+{
+   GpsDecoderTrack::Writer writer;
+   bool ok = writer.open(path);
+
+   for (size_t i = 0; i < records.size(); i++) ok = writer.append(records[i]) && ok;
+   CHECK(writer.records() == records.size());
+   return writer.close() && ok;
+}
+
+// All records through readBlock, the footers against the records of every block
+static void testRoundTrip(const std::vector<FixRecord> &records)
+{
+   GpsDecoderTrack::Reader reader;
+   std::vector<FixRecord> block;
+   size_t next = 0;
+
+   CHECK(reader.open(path));
+   CHECK(reader.blocks() == (records.size() + GPS_DECODER_TRACK_BLOCK - 1) / GPS_DECODER_TRACK_BLOCK);
+   CHECK(reader.records() == records.size());
+
+   for (size_t b = 0; b < reader.blocks(); b++)
+   {
+      GpsDecoderTrack::BlockInfo info, expected;
+      bool located = false;
+
+      memset(&expected, 0, sizeof(expected));
+      CHECK(reader.readBlock(b, block));
+      CHECK(reader.blockInfo(b, info));
+      CHECK(info.records == block.size());
+
+      for (size_t i = 0; i < block.size() && next < records.size(); i++, next++)
+      {
+         const FixRecord &record = records[next];
+         uint64_t time = GpsDecoderTrack::timestamp(record);
+
+         CHECK(sameRecord(block[i], record));
+         expected.valid |= record.valid;
+         if (time && (!expected.minTime || time < expected.minTime)) expected.minTime = time;
+         if (time > expected.maxTime) expected.maxTime = time;
+         if (record.valid & GPS_DECODER_FIELD_LOCATION)
+         {
+            if (!located || record.latE7 < expected.minLatE7) expected.minLatE7 = record.latE7;
+            if (!located || record.latE7 > expected.maxLatE7) expected.maxLatE7 = record.latE7;
+            if (!located || record.lngE7 < expected.minLngE7) expected.minLngE7 = record.lngE7;
+            if (!located || record.lngE7 > expected.maxLngE7) expected.maxLngE7 = record.lngE7;
+            located = true;
+         }
+      }
+
+      CHECK(info.valid == expected.valid && info.minTime == expected.minTime && info.maxTime == expected.maxTime);
+      CHECK(info.minLatE7 == expected.minLatE7 && info.maxLatE7 == expected.maxLatE7);
+      CHECK(info.minLngE7 == expected.minLngE7 && info.maxLngE7 == expected.maxLngE7);
+   }
+   CHECK(next == records.size());
+
+   // Behind the last block
+   GpsDecoderTrack::BlockInfo info;
+   CHECK(!reader.readBlock(reader.blocks(), block) && block.empty());
+   CHECK(!reader.blockInfo(reader.blocks(), info));
+}
+
+// seek against a linear search over the block footers, also between and beyond the records
+static void testSeek(const std::vector<FixRecord> &records)
+{
+   GpsDecoderTrack::Reader reader;
+   CHECK(reader.open(path));
+
+   std::vector<uint64_t> maxTimes;
+   uint64_t first = 0;
+   for (size_t b = 0; b < reader.blocks(); b++)
+   {
+      GpsDecoderTrack::BlockInfo info;
+      reader.blockInfo(b, info);
+      maxTimes.push_back(info.maxTime);
+      if (b == 0) first = info.minTime;
+   }
+
+   uint64_t last = maxTimes.back();
+   for (size_t i = 0; i < 2000; i++)
+   {
+      uint64_t time;
+      switch (i % 4)
+      {
+         case 0:  time = GpsDecoderTrack::timestamp(records[random(records.size())]); break;
+         case 1:  time = maxTimes[random(maxTimes.size())] + random(3); break;
+         default: time = first - 1000 + random((uint32_t)(last - first + 2000)); break;
+      }
+
+      size_t expected = 0;
+      while (expected < maxTimes.size() && maxTimes[expected] < time) expected++;
+      CHECK(reader.seek(time) == expected);
+
+      // The record of time is in that block or there is none
+      if (expected < reader.blocks())
+      {
+         std::vector<FixRecord> block;
+         reader.readBlock(expected, block);
+         bool found = false;
+         for (size_t j = 0; j < block.size(); j++) found = found || GpsDecoderTrack::timestamp(block[j]) >= time;
+         CHECK(found);
+      }
+   }
+   CHECK(reader.seek(0) == 0);
+   CHECK(reader.seek(last + 1) == reader.blocks());
+}
+
+// The epoch records of a decoder through Writer::publish
+static void testDecoder()
+{
+   GpsDecoderClass decoder;
+   GpsDecoderTrack::Writer writer;
+   std::vector<FixRecord> records;
+   std::string log = BenchTrack::log(1000000);
+
+   CHECK(writer.open(path));
+   decoder.onEpoch(GpsDecoderTrack::Writer::publish, &writer);
+   decoder.decode(log.data(), log.size());
+   CHECK(writer.close());
+
+   // Once more into a vector
+   GpsDecoderClass again;
+   again.onEpoch([](const FixRecord &record, void *context) { static_cast<std::vector<FixRecord> *>(context)->push_back(record); }, &records);
+   again.decode(log.data(), log.size());
+   CHECK(records.size() > GPS_DECODER_TRACK_BLOCK);
+
+   GpsDecoderTrack::Reader reader;
+   std::vector<FixRecord> block;
+   size_t next = 0;
+
+   CHECK(reader.open(path));
+   CHECK(reader.records() == records.size());
+   for (size_t b = 0; b < reader.blocks(); b++)
+   {
+      CHECK(reader.readBlock(b, block));
+      for (size_t i = 0; i < block.size() && next < records.size(); i++) CHECK(sameRecord(block[i], records[next++]));
+   }
+   CHECK(next == records.size());
+}
+
+// Every damage of the structure must be found by open()
+static void testCorrupt()
+{
+   std::string good = readFile();
+   size_t length = good.size();
+   size_t indexOffset = get32(good, length - 16);
+   size_t blocks = get32(good, length - 8);
+   size_t firstFooter = get32(good, indexOffset + 8) - FOOTER_SIZE + get32(good, indexOffset);
+
+   struct { size_t offset; uint32_t value; } damages[] =
+   {
+      { 0, 0x47535047 },                                       // "GPSG" instead of "GPST"
+      { 4, 0x000f0002 },                                       // Version 2
+      { 4, 0x000e0001 },                                       // 14 columns
+      { length - 4, 0x58535047 },                              // Trailer "GPSX"
+      { length - 16, 4 },                                      // Index offset in the header
+      { length - 16, (uint32_t)length },                       // Index offset behind the file
+      { length - 8, (uint32_t)blocks + 1 },                    // Index entry in the trailer
+      { length - 8, 0xffffffff },
+      { indexOffset, 0 },                                      // Block offset in the header
+      { indexOffset, (uint32_t)indexOffset },                  // Block in the index
+      { indexOffset + 8, FOOTER_SIZE - 1 },                    // Block smaller than its footer
+      { indexOffset + 8, (uint32_t)indexOffset },              // Block into the index
+      { firstFooter, 0x58535047 },                             // Footer "GPSX"
+      { firstFooter + 4, 0xfffffff0 },                         // More records than bytes in the columns
+      { firstFooter + 44, 0xffffff00 },                        // Column end behind the next one
+      { firstFooter + 44 + 4 * 14, 1 },                        // Last column end is not the footer
+   };
+
+   GpsDecoderTrack::Reader reader;
+   CHECK(writeFile(good) && reader.open(path));
+
+   for (size_t i = 0; i < sizeof(damages) / sizeof(damages[0]); i++)
+   {
+      std::string file = good;
+      put32(file, damages[i].offset, damages[i].value);
+      CHECK(writeFile(file));
+      if (reader.open(path)) printf("damage %zu not found\n", i);
+      CHECK(!reader.blocks());
+   }
+
+   // Truncated files
+   for (size_t i = 0; i < 200; i++)
+   {
+      CHECK(writeFile(good.substr(0, i < 30 ? i : random(length))));
+      CHECK(!reader.open(path));
+   }
+
+   // Random bytes may not be found, but the reader must stay within the file
+   for (size_t i = 0; i < 200; i++)
+   {
+      std::string file = good;
+      for (size_t k = 1 + random(4); k > 0; k--) file[random(length)] = (char)random(256);
+      CHECK(writeFile(file));
+      if (!reader.open(path)) continue;
+
+      std::vector<FixRecord> block;
+      GpsDecoderTrack::BlockInfo info;
+      for (size_t b = 0; b < reader.blocks(); b++) CHECK(reader.blockInfo(b, info) && (reader.readBlock(b, block) || block.empty()));
+   }
+
+   unlink(path);
+   CHECK(!reader.open(path));
+
+   // A writer without file
+   GpsDecoderTrack::Writer writer;
+   CHECK(!writer.append(FixRecord()) && !writer.close());
+}
+
+
+// ******************************************************************
+// Main
+// ******************************************************************
+int main()
+{
+   int descriptor = mkstemp(path);
+   if (descriptor < 0)
+   {
+      printf("gpsDecoderTrack: can not create %s\n", path);
+      return 1;
+   }
+   close(descriptor);
+
+   std::vector<FixRecord> records = makeRecords();
+
+   // timestamp and dateTime are inverse
+   for (size_t i = 0; i < records.size(); i++)
+   {
+      uint32_t date, time;
+      GpsDecoderTrack::dateTime(GpsDecoderTrack::timestamp(records[i].date ? records[i].date : 10100, records[i].time), date, time);
+      CHECK(time == records[i].time && (date == records[i].date || !records[i].date));
+   }
+
+   CHECK(writeTrack(records));
+   testRoundTrip(records);
+   testSeek(records);
+
+   testDecoder();
+
+   // A track without records has no block
+   CHECK(writeTrack(std::vector<FixRecord>()));
+   testRoundTrip(std::vector<FixRecord>());
+
+   CHECK(writeTrack(records));
+   testCorrupt();
+
+   printf("gpsDecoderTrack: %u failures\n", failures);
+   return failures ? 1 : 0;
+}